@@ -593,6 +593,10 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x)
             map.heightMapSize += sizeof(V9) + sizeof(V8);
     }
 
+    // keep following sections 4 byte aligned, mangosd can map the file into memory then
+    uint32 heightPadding = (4 - map.heightMapSize % 4) % 4;
+    map.heightMapSize += heightPadding;
+
     // Get from MCLQ chunk (old)
     for (int i = 0; i < ADT_CELLS_PER_GRID; i++)
     {
@@ -860,6 +864,11 @@ bool ConvertADT(char* filename, char* filename2, int cell_y, int cell_x)
             fwrite(V8, sizeof(V8), 1, output);
         }
     }
+    if (heightPadding)
+    {
+        uint32 const zero = 0;
+        fwrite(&zero, heightPadding, 1, output);
+    }
 
     // Store liquid data if need
     if (map.liquidMapOffset)
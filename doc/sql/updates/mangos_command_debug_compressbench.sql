@@ -0,0 +1,6 @@
+-- Help of .debug compressbench, apply to the mangos (world) database after init/mangos.sql
+
+DELETE FROM `command` WHERE `name` IN ('debug compressbench', 'debug compressbench record');
+
+INSERT INTO `command` VALUES ('debug compressbench', '3', 'Syntax: .debug compressbench [#iterations]\r\n\r\nCompress the recorded update packets #iterations times (default 10, at most 100) with a new deflate state per packet and with the reused per thread stream, and show average and worst time per packet and throughput of both. Needs packets recorded by .debug compressbench record.');
+INSERT INTO `command` VALUES ('debug compressbench record', '3', 'Syntax: .debug compressbench record [#count]\r\n\r\nRecord the next #count (default 1000) update packets larger than Compression.Threshold for .debug compressbench.');
@@ -0,0 +1,5 @@
+-- Help of .debug eventbench, apply to the mangos (world) database after init/mangos.sql
+
+DELETE FROM `command` WHERE `name` IN ('debug eventbench');
+
+INSERT INTO `command` VALUES ('debug eventbench', '4', 'Syntax: .debug eventbench [#creatures [#ticks]]\r\n\r\nConsole only. Tick the event processors of #creatures (default 20000, at most 100000) moving creatures #ticks times (default 600, at most 1000) at 100 ms, rescheduling relocation notifies and adding short events, with events made by new and with events made by EventProcessor::MakeEvent, and show average and worst tick time of both.');
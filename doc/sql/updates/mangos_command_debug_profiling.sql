@@ -0,0 +1,14 @@
+-- Help of the profiling and benchmark debug commands, apply to the mangos (world) database after init/mangos.sql
+
+DELETE FROM `command` WHERE `name` IN ('debug updatecache', 'debug sqlqueue', 'debug flushlatency', 'debug losbench', 'debug losbench record',
+  'debug opcodeprofile', 'debug opcodeprofile enable', 'debug opcodeprofile reset', 'debug opcodeprofile write');
+
+INSERT INTO `command` VALUES ('debug updatecache', '3', 'Syntax: .debug updatecache\r\n\r\nShow hits, misses and hit rate of the cache of values update blocks shared between viewers.');
+INSERT INTO `command` VALUES ('debug sqlqueue', '3', 'Syntax: .debug sqlqueue\r\n\r\nShow the queued async requests of the world, character and login databases, and executed requests and latency per async connection.');
+INSERT INTO `command` VALUES ('debug flushlatency', '3', 'Syntax: .debug flushlatency\r\n\r\nShow the histogram of the time between buffering output and writing it to the socket, for all connections and for the selected player.');
+INSERT INTO `command` VALUES ('debug losbench', '3', 'Syntax: .debug losbench [#iterations]\r\n\r\nReplay the recorded line of sight queries #iterations times (default 10, at most 100) with the per triangle and with the packed triangle code and show the time of both. Needs vmap.packedTriangles enabled and queries recorded by .debug losbench record.');
+INSERT INTO `command` VALUES ('debug losbench record', '3', 'Syntax: .debug losbench record [#count]\r\n\r\nRecord the next #count (default 10000) static line of sight queries of all maps for .debug losbench.');
+INSERT INTO `command` VALUES ('debug opcodeprofile', '3', 'Syntax: .debug opcodeprofile [#count [time|max|calls|out]]\r\n\r\nShow the #count (default 20) client opcodes with the highest total handler time, worst handler time, number of calls or bytes sent.');
+INSERT INTO `command` VALUES ('debug opcodeprofile enable', '3', 'Syntax: .debug opcodeprofile enable on|off\r\n\r\nStart or stop recording opcode handler costs, the initial state is set by Network.OpcodeProfiler.');
+INSERT INTO `command` VALUES ('debug opcodeprofile reset', '3', 'Syntax: .debug opcodeprofile reset\r\n\r\nClear the recorded opcode handler costs.');
+INSERT INTO `command` VALUES ('debug opcodeprofile write', '3', 'Syntax: .debug opcodeprofile write [$filename]\r\n\r\nWrite the recorded opcode handler costs as CSV to $filename (default opcode_profile.csv) in the logs directory. Only a file name without path is accepted.');
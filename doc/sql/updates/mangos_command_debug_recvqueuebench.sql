@@ -0,0 +1,5 @@
+-- Help of .debug recvqueuebench, apply to the mangos (world) database after init/mangos.sql
+
+DELETE FROM `command` WHERE `name` IN ('debug recvqueuebench');
+
+INSERT INTO `command` VALUES ('debug recvqueuebench', '4', 'Syntax: .debug recvqueuebench [#sessions [#packets [#threads]]]\r\n\r\nConsole only. In #packets rounds (default 100, at most 200) #threads producer threads (default 4, at most 16) send one movement sized packet to each of #sessions (default 5000, at most 10000) session queues while the calling thread drains all queues, with the mutex queue and with the lock-free queue, and show average and worst round time and enqueue time of both.');
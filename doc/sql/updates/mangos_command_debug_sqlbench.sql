@@ -0,0 +1,5 @@
+-- Help of .debug sqlbench, apply to the mangos (world) database after init/mangos.sql
+
+DELETE FROM `command` WHERE `name` IN ('debug sqlbench');
+
+INSERT INTO `command` VALUES ('debug sqlbench', '4', 'Syntax: .debug sqlbench [#iterations]\r\n\r\nConsole only. Load the creature and item_template tables #iterations times (default 1, at most 10) as text result set and as binary protocol result set, reading every field, in a separate thread with an own database connection. Average and worst load time and field read time of both are written to the server log.');
@@ -0,0 +1,6 @@
+-- Help of .debug updatecache, apply to the mangos (world) database after init/mangos.sql
+
+DELETE FROM `command` WHERE `name` IN ('debug updatecache', 'debug updatecache reset');
+
+INSERT INTO `command` VALUES ('debug updatecache', '3', 'Syntax: .debug updatecache\r\n\r\nShow hits, misses and hit rate of the cache of values update blocks shared between viewers since start or the last .debug updatecache reset.');
+INSERT INTO `command` VALUES ('debug updatecache reset', '3', 'Syntax: .debug updatecache reset\r\n\r\nClear the hit and miss counters of the values update block cache, to measure the hit rate of a chosen period like a raid encounter.');
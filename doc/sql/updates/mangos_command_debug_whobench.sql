@@ -0,0 +1,5 @@
+-- Help of .debug whobench, apply to the mangos (world) database after init/mangos.sql
+
+DELETE FROM `command` WHERE `name` IN ('debug whobench');
+
+INSERT INTO `command` VALUES ('debug whobench', '4', 'Syntax: .debug whobench [#queries [#players]]\r\n\r\nConsole only. Run #queries (default 1000, at most 10000) /who level range queries, every fourth with a guild name filter, against #players (default 5000, at most 50000) simulated players, converting name and guild name of every player per query and with a WhoListIndex, and show average and worst query time of both.');
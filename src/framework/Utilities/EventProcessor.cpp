@@ -18,15 +18,25 @@
 
 #include "EventProcessor.h"
 
+#include <algorithm>
+#include <functional>
+
+// a unit usually has only one or two events of each type at a time
+static const size_t MaxFreeEventStorage = 4;
+
 EventProcessor::EventProcessor()
 {
     m_time = 0;
+    m_sequence = 0;
     m_aborting = false;
 }
 
 EventProcessor::~EventProcessor()
 {
     KillAllEvents(true);
+
+    for (std::vector<std::pair<size_t, void*> >::const_iterator i = m_freeStorage.begin(); i != m_freeStorage.end(); ++i)
+        ::operator delete(i->second);
 }
 
 void EventProcessor::Update(uint32 p_time)
@@ -35,25 +45,25 @@ void EventProcessor::Update(uint32 p_time)
     m_time += p_time;
 
     // main event loop
-    EventList::iterator i;
-    while (((i = m_events.begin()) != m_events.end()) && i->first <= m_time)
+    while (!m_events.empty() && m_events.front().time <= m_time)
     {
         // get and remove event from queue
-        BasicEvent* Event = i->second;
-        m_events.erase(i);
+        BasicEvent* Event = m_events.front().event;
+        std::pop_heap(m_events.begin(), m_events.end(), std::greater<QueuedEvent>());
+        m_events.pop_back();
 
         if (!Event->to_Abort)
         {
             if (Event->Execute(m_time, p_time))
             {
                 // completely destroy event if it is not re-added
-                delete Event;
+                DestroyEvent(Event);
             }
         }
         else
         {
             Event->Abort(m_time);
-            delete Event;
+            DestroyEvent(Event);
         }
     }
 }
@@ -63,26 +73,28 @@ void EventProcessor::KillAllEvents(bool force)
     // prevent event insertions
     m_aborting = true;
 
+    // aborted and destroyed events may add new ones, so work on a detached list
+    EventList events;
+    events.swap(m_events);
+
     // first, abort all existing events
-    for (EventList::iterator i = m_events.begin(); i != m_events.end();)
+    EventList::iterator last = events.begin();
+    for (EventList::iterator i = events.begin(); i != events.end(); ++i)
     {
-        EventList::iterator i_old = i;
-        ++i;
-
-        i_old->second->to_Abort = true;
-        i_old->second->Abort(m_time);
-        if (force || i_old->second->IsDeletable())
-        {
-            delete i_old->second;
-
-            if (!force)                                     // need per-element cleanup
-                m_events.erase(i_old);
-        }
+        i->event->to_Abort = true;
+        i->event->Abort(m_time);
+        if (force || i->event->IsDeletable())
+            DestroyEvent(i->event);
+        else
+            *last++ = *i;                                   // keep for per-element cleanup later
     }
 
     // fast clear event list (in force case)
     if (force)
-        m_events.clear();
+        return;
+
+    m_events.insert(m_events.end(), events.begin(), last);
+    std::make_heap(m_events.begin(), m_events.end(), std::greater<QueuedEvent>());
 }
 
 void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime)
@@ -91,10 +103,45 @@ void EventProcessor::AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime
         Event->m_addTime = m_time;
 
     Event->m_execTime = e_time;
-    m_events.insert(std::pair<uint64, BasicEvent*>(e_time, Event));
+    m_events.push_back(QueuedEvent(e_time, m_sequence++, Event));
+    std::push_heap(m_events.begin(), m_events.end(), std::greater<QueuedEvent>());
 }
 
 uint64 EventProcessor::CalculateTime(uint64 t_offset) const
 {
     return m_time + t_offset;
 }
+
+void EventProcessor::DestroyEvent(BasicEvent* Event)
+{
+    size_t size = Event->m_storageSize;
+    if (!size)
+    {
+        delete Event;
+        return;
+    }
+
+    void* storage = dynamic_cast<void*>(Event);             // start of the most derived object, as created by MakeEvent
+    Event->~BasicEvent();
+
+    if (m_freeStorage.size() < MaxFreeEventStorage)
+        m_freeStorage.push_back(std::make_pair(size, storage));
+    else
+        ::operator delete(storage);
+}
+
+void* EventProcessor::AllocateEventStorage(size_t size)
+{
+    for (std::vector<std::pair<size_t, void*> >::iterator i = m_freeStorage.begin(); i != m_freeStorage.end(); ++i)
+    {
+        if (i->first != size)
+            continue;
+
+        void* storage = i->second;
+        *i = m_freeStorage.back();
+        m_freeStorage.pop_back();
+        return storage;
+    }
+
+    return ::operator new(size);
+}
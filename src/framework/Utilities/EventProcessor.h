@@ -21,7 +21,9 @@
 
 #include "Platform/Define.h"
 
-#include <map>
+#include <new>
+#include <utility>
+#include <vector>
 
 // Note. All times are in milliseconds here.
 
@@ -30,7 +32,7 @@ class BasicEvent
     public:
 
         BasicEvent()
-            : to_Abort(false)
+            : to_Abort(false), m_storageSize(0)
         {
         }
 
@@ -53,9 +55,26 @@ class BasicEvent
         // these can be used for time offset control
         uint64 m_addTime;                                   // time when the event was added to queue, filled by event handler
         uint64 m_execTime;                                  // planned time of next execution, filled by event handler
+
+        uint32 m_storageSize;                               // size of recycled storage from EventProcessor::MakeEvent, 0 if created by new
+};
+
+struct QueuedEvent
+{
+    QueuedEvent(uint64 _time, uint64 _sequence, BasicEvent* _event) : time(_time), sequence(_sequence), event(_event) {}
+
+    // ordering of the event heap, earliest time first and same time events in insertion order
+    bool operator>(QueuedEvent const& other) const
+    {
+        return time > other.time || (time == other.time && sequence > other.sequence);
+    }
+
+    uint64 time;
+    uint64 sequence;
+    BasicEvent* event;
 };
 
-typedef std::multimap<uint64, BasicEvent*> EventList;
+typedef std::vector<QueuedEvent> EventList;
 
 class EventProcessor
 {
@@ -69,10 +88,24 @@ class EventProcessor
         void AddEvent(BasicEvent* Event, uint64 e_time, bool set_addtime = true);
         uint64 CalculateTime(uint64 t_offset) const;
 
+        // same as new T(args), but reuses the storage of events destroyed by this processor
+        template<class T, class... Args>
+        T* MakeEvent(Args&&... args)
+        {
+            T* Event = new (AllocateEventStorage(sizeof(T))) T(std::forward<Args>(args)...);
+            Event->m_storageSize = sizeof(T);
+            return Event;
+        }
+
     protected:
 
+        void DestroyEvent(BasicEvent* Event);
+        void* AllocateEventStorage(size_t size);
+
         uint64 m_time;
-        EventList m_events;
+        uint64 m_sequence;                                  // insertion counter, keeps same time events in order
+        EventList m_events;                                 // binary min heap, ordered by QueuedEvent::operator>
+        std::vector<std::pair<size_t, void*> > m_freeStorage; // storage of destroyed events, by size
         bool m_aborting;
 };
 
@@ -0,0 +1,101 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MPSCQUEUE_H
+#define MANGOS_MPSCQUEUE_H
+
+#include <atomic>
+#include <utility>
+
+/**
+ * Unbounded lock-free multi producer / single consumer FIFO queue (D. Vyukov's node based algorithm).
+ *
+ * Enqueue may be called from any number of threads at once and never blocks. Dequeue, DequeueIf
+ * and Peek must only be called by one thread at a time; the consumer may change between calls
+ * as long as the calls are ordered (e.g. map update threads joined before the world update).
+ * A value enqueued by a producer that was interrupted between its two steps is not visible to
+ * the consumer yet and is returned by a later call, order is still preserved.
+ */
+template<typename T>
+class MPSCQueue
+{
+    public:
+        MPSCQueue() : m_head(new Node()), m_tail(m_head.load(std::memory_order_relaxed)) {}
+
+        ~MPSCQueue()
+        {
+            T value;
+            while (Dequeue(value)) {}
+
+            delete m_tail;
+        }
+
+        void Enqueue(T&& value)
+        {
+            Node* node = new Node(std::move(value));
+            Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+            prev->next.store(node, std::memory_order_release);
+        }
+
+        bool Dequeue(T& result)
+        {
+            Node* next = m_tail->next.load(std::memory_order_acquire);
+            if (!next)
+                return false;
+
+            result = std::move(next->value);
+            delete m_tail;
+            m_tail = next;                                  // next becomes the new stub node
+            return true;
+        }
+
+        // dequeue only if pred(front) returns true, keeps the value otherwise
+        template<class Predicate>
+        bool DequeueIf(T& result, Predicate pred)
+        {
+            T const* front = Peek();
+            if (!front || !pred(*front))
+                return false;
+
+            return Dequeue(result);
+        }
+
+        T const* Peek() const
+        {
+            Node* next = m_tail->next.load(std::memory_order_acquire);
+            return next ? &next->value : nullptr;
+        }
+
+    private:
+        struct Node
+        {
+            Node() : next(nullptr) {}
+            explicit Node(T&& _value) : value(std::move(_value)), next(nullptr) {}
+
+            T value;
+            std::atomic<Node*> next;
+        };
+
+        MPSCQueue(MPSCQueue const&);
+        MPSCQueue& operator=(MPSCQueue const&);
+
+        std::atomic<Node*> m_head;                          // last enqueued node, producers side
+        Node* m_tail;                                       // stub node in front of the first value, consumer side
+};
+
+#endif
@@ -24,6 +24,7 @@
 #include "SystemConfig.h"
 #include "SQLStorages.h"
 #include "World.h"
+#include "Database/DatabaseEnv.h"
 
 // Format is YYYYMMDDRR where RR is the change in the conf file
 // for that day.
@@ -54,10 +55,37 @@ struct BuyerItemInfo
 typedef std::map<uint32, BuyerItemInfo > BuyerItemInfoMap;
 typedef std::map<uint32, BuyerAuctionEval > CheckEntryMap;
 
+// auction data the buyer planning job needs, copied in the world thread
+struct BuyerAuctionInfo
+{
+    uint32  ItemEntry;
+    uint32  ItemCount;
+    uint32  BuyPrice;                                       // of item template
+    uint32  SellPrice;                                      // of item template
+    uint32  Owner;
+    uint32  Bidder;
+    uint32  Bid;
+    uint32  StartBid;
+    uint32  Buyout;
+    uint32  OutBid;
+};
+
+typedef std::map<uint32, BuyerAuctionInfo> BuyerAuctionInfoMap; // by auction id
+
+// bid chosen by the planning job, only placed if the auction bid is still the planned one
+struct BuyerBid
+{
+    uint32  AuctionId;
+    uint32  CurrentBid;
+    uint32  Price;
+};
+
+typedef std::vector<BuyerBid> BuyerBidList;
+
 struct AHB_Buyer_Config
 {
     public:
-        AHB_Buyer_Config() : FactionChance(0), BuyerEnabled(false), BuyerPriceRatio(0), m_houseType(AUCTION_HOUSE_NEUTRAL) {}
+        AHB_Buyer_Config() : FactionChance(0), BuyerEnabled(false), BuyerPriceRatio(0), AppliedBids(0), Planning(false), m_houseType(AUCTION_HOUSE_NEUTRAL) {}
 
         void Initialize(AuctionHouseType houseType)
         {
@@ -73,6 +101,12 @@ struct AHB_Buyer_Config
         bool             BuyerEnabled;
         uint32           BuyerPriceRatio;
 
+        // owned by the planning job while Planning is set
+        BuyerAuctionInfoMap Auctions;
+        BuyerBidList     PlannedBids;
+        size_t           AppliedBids;
+        std::atomic<bool> Planning;
+
     private:
         AuctionHouseType m_houseType;
 };
@@ -85,6 +119,18 @@ struct RandomArrayEntry
 
 typedef std::vector<RandomArrayEntry> RandomArray;
 
+// auction chosen by the seller planning job, created by the world thread
+struct SellerAuction
+{
+    uint32 ItemId;
+    uint32 StackCount;
+    uint32 BidPrice;
+    uint32 BuyoutPrice;
+    uint32 Time;                                            // in seconds
+};
+
+typedef std::vector<SellerAuction> SellerAuctionList;
+
 struct SellerItemClassInfo
 {
     SellerItemClassInfo() : AmountOfItems(0), MissItems(0), Quantity(0) {}
@@ -171,7 +217,7 @@ class AHB_Seller_Config
 class AuctionBotBuyer : public AuctionBotAgent
 {
     public:
-        AuctionBotBuyer();
+        explicit AuctionBotBuyer(AuctionBotPlanner& planner);
         ~AuctionBotBuyer();
 
         bool        Initialize() override;
@@ -187,10 +233,12 @@ class AuctionBotBuyer : public AuctionBotAgent
         void        LoadBuyerValues(AHB_Buyer_Config& config) const;
         bool        IsBuyableEntry(uint32 buyoutPrice, double InGame_BuyPrice, double MaxBuyablePrice, uint32 MinBuyPrice, uint32 MaxChance, uint32 ChanceRatio) const;
         bool        IsBidableEntry(uint32 bidPrice, double InGame_BuyPrice, double MaxBidablePrice, uint32 MinBidPrice, uint32 MaxChance, uint32 ChanceRatio) const;
-        void        PlaceBidToEntry(AuctionEntry* auction, uint32 bidPrice) const;
-        void        BuyEntry(AuctionEntry* auction) const;
+        void        PlaceBidToEntry(AHB_Buyer_Config& config, uint32 auctionId, BuyerAuctionInfo const& auction, uint32 bidPrice) const;
+        void        BuyEntry(AHB_Buyer_Config& config, uint32 auctionId, BuyerAuctionInfo const& auction) const;
         void        PrepareListOfEntry(AHB_Buyer_Config& config) const;
         uint32      GetBuyableEntry(AHB_Buyer_Config& config) const;
+        void        LoadAuctions(AHB_Buyer_Config& config) const;
+        void        ApplyPlannedBids(AHB_Buyer_Config& config) const;
 };
 
 // This class handle all Selling method
@@ -200,13 +248,13 @@ class AuctionBotSeller : public AuctionBotAgent
     public:
         typedef std::vector<uint32> ItemPool;
 
-        AuctionBotSeller();
+        explicit AuctionBotSeller(AuctionBotPlanner& planner);
         ~AuctionBotSeller();
 
         bool Initialize() override;
         bool Update(AuctionHouseType houseType) override;
 
-        void addNewAuctions(AHB_Seller_Config& config);
+        void addNewAuctions(AHB_Seller_Config const& config, SellerAuctionList& auctions) const;
         void SetItemsRatio(uint32 al, uint32 ho, uint32 ne);
         void SetItemsRatioForHouse(AuctionHouseType house, uint32 val);
         void SetItemsAmount(uint32(&vals) [MAX_AUCTION_QUALITY]);
@@ -218,10 +266,17 @@ class AuctionBotSeller : public AuctionBotAgent
 
         ItemPool m_ItemPool[MAX_AUCTION_QUALITY][MAX_ITEM_CLASS];
 
+        // owned by the planning job of the house while m_Planning is set
+        SellerAuctionList   m_PlannedAuctions[MAX_AUCTION_HOUSE_TYPE];
+        size_t              m_AppliedAuctions[MAX_AUCTION_HOUSE_TYPE];
+        std::atomic<bool>   m_Planning[MAX_AUCTION_HOUSE_TYPE];
+
+        void        ApplyPlannedAuctions(AuctionHouseType houseType);
+
         void        LoadSellerValues(AHB_Seller_Config& config) const;
         uint32      SetStat(AHB_Seller_Config& config) const;
-        bool        getRandomArray(AHB_Seller_Config& config, RandomArray& ra, const std::vector<std::vector<uint32> >& addedItem) const;
-        void        SetPricesOfItem(AHB_Seller_Config& config, uint32& buyp, uint32& bidp, ItemQualities itemQuality);
+        bool        getRandomArray(AHB_Seller_Config const& config, RandomArray& ra, const std::vector<std::vector<uint32> >& addedItem) const;
+        void        SetPricesOfItem(AHB_Seller_Config const& config, uint32& buyp, uint32& bidp, ItemQualities itemQuality) const;
         void        LoadItemsQuantity(AHB_Seller_Config& config) const;
 };
 
@@ -402,6 +457,9 @@ void AuctionBotConfig::GetConfigFromFile()
     setConfig(CONFIG_UINT32_AHBOT_CLASS_TRADEGOOD_MAX_ITEM_LEVEL   , "AuctionHouseBot.Class.TradeGood.ItemLevel.Max" , 0);
     setConfig(CONFIG_UINT32_AHBOT_CLASS_CONTAINER_MIN_ITEM_LEVEL   , "AuctionHouseBot.Class.Container.ItemLevel.Min" , 0);
     setConfig(CONFIG_UINT32_AHBOT_CLASS_CONTAINER_MAX_ITEM_LEVEL   , "AuctionHouseBot.Class.Container.ItemLevel.Max" , 0);
+
+    setConfig(CONFIG_BOOL_AHBOT_PLANNING_THREAD              , "AuctionHouseBot.PlanningThread"             , false);
+    setConfig(CONFIG_UINT32_AHBOT_APPLY_BATCH_SIZE           , "AuctionHouseBot.ApplyBatchSize"             , 0);
 }
 
 bool AuctionBotConfig::Reload()
@@ -462,7 +520,7 @@ uint32 AuctionBotConfig::getConfigItemQualityAmount(AuctionQuality quality) cons
 
 //== AuctionBotBuyer functions =============================
 
-AuctionBotBuyer::AuctionBotBuyer(): m_CheckInterval(0)
+AuctionBotBuyer::AuctionBotBuyer(AuctionBotPlanner& planner) : AuctionBotAgent(planner), m_CheckInterval(0)
 {
     // Define faction for our main data class.
     for (int i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
@@ -527,66 +585,89 @@ void AuctionBotBuyer::LoadConfig()
     }
 }
 
-uint32 AuctionBotBuyer::GetBuyableEntry(AHB_Buyer_Config& config) const
+void AuctionBotBuyer::LoadAuctions(AHB_Buyer_Config& config) const
 {
-    config.SameItemInfo.clear();
-    uint32 count = 0;
-    time_t Now = time(nullptr);
+    config.Auctions.clear();
 
     AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(config.GetHouseType())->GetAuctionsBounds();
     for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
     {
         AuctionEntry* Aentry = itr->second;
         Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
-        if (item)
+        if (!item)                                          // auction item not accessible, possible auction in payment pending mode
+            continue;
+
+        ItemPrototype const* prototype = item->GetProto();
+        if (!prototype)
+            continue;
+
+        BuyerAuctionInfo& auction = config.Auctions[Aentry->Id];
+        auction.ItemEntry = item->GetEntry();
+        auction.ItemCount = item->GetCount();
+        auction.BuyPrice = prototype->BuyPrice;
+        auction.SellPrice = prototype->SellPrice;
+        auction.Owner = Aentry->owner;
+        auction.Bidder = Aentry->bidder;
+        auction.Bid = Aentry->bid;
+        auction.StartBid = Aentry->startbid;
+        auction.Buyout = Aentry->buyout;
+        auction.OutBid = Aentry->GetAuctionOutBid();
+    }
+}
+
+uint32 AuctionBotBuyer::GetBuyableEntry(AHB_Buyer_Config& config) const
+{
+    config.SameItemInfo.clear();
+    uint32 count = 0;
+    time_t Now = time(nullptr);
+
+    for (BuyerAuctionInfoMap::const_iterator itr = config.Auctions.begin(); itr != config.Auctions.end(); ++itr)
+    {
+        uint32 auctionId = itr->first;
+        BuyerAuctionInfo const& Aentry = itr->second;
+
+        BuyerItemInfo& buyerItem = config.SameItemInfo[Aentry.ItemEntry];    // Structure constructor will make sure Element are correctly initialised if entry is created here.
+        ++buyerItem.ItemCount;
+        buyerItem.BuyPrice = buyerItem.BuyPrice + (Aentry.Buyout / Aentry.ItemCount);
+        buyerItem.BidPrice = buyerItem.BidPrice + (Aentry.StartBid / Aentry.ItemCount);
+        if (Aentry.Buyout != 0)
         {
-            ItemPrototype const* prototype = item->GetProto();
-            if (prototype)
-            {
-                BuyerItemInfo& buyerItem = config.SameItemInfo[item->GetEntry()];    // Structure constructor will make sure Element are correctly initialised if entry is created here.
-                ++buyerItem.ItemCount;
-                buyerItem.BuyPrice = buyerItem.BuyPrice + (Aentry->buyout / item->GetCount());
-                buyerItem.BidPrice = buyerItem.BidPrice + (Aentry->startbid / item->GetCount());
-                if (Aentry->buyout != 0)
-                {
-                    if (Aentry->buyout / item->GetCount() < buyerItem.MinBuyPrice)
-                        buyerItem.MinBuyPrice = Aentry->buyout / item->GetCount();
-                    else if (buyerItem.MinBuyPrice == 0)
-                        buyerItem.MinBuyPrice = Aentry->buyout / item->GetCount();
-                }
-                if (Aentry->startbid / item->GetCount() < buyerItem.MinBidPrice)
-                    buyerItem.MinBidPrice = Aentry->startbid / item->GetCount();
-                else if (buyerItem.MinBidPrice == 0)
-                    buyerItem.MinBidPrice = Aentry->startbid / item->GetCount();
+            if (Aentry.Buyout / Aentry.ItemCount < buyerItem.MinBuyPrice)
+                buyerItem.MinBuyPrice = Aentry.Buyout / Aentry.ItemCount;
+            else if (buyerItem.MinBuyPrice == 0)
+                buyerItem.MinBuyPrice = Aentry.Buyout / Aentry.ItemCount;
+        }
+        if (Aentry.StartBid / Aentry.ItemCount < buyerItem.MinBidPrice)
+            buyerItem.MinBidPrice = Aentry.StartBid / Aentry.ItemCount;
+        else if (buyerItem.MinBidPrice == 0)
+            buyerItem.MinBidPrice = Aentry.StartBid / Aentry.ItemCount;
 
-                if (!Aentry->owner)
-                {
-                    if ((Aentry->bid != 0) && Aentry->bidder) // Add bided by player
-                    {
-                        config.CheckedEntry[Aentry->Id].LastExist = Now;
-                        config.CheckedEntry[Aentry->Id].AuctionId = Aentry->Id;
-                        ++count;
-                    }
-                }
-                else
+        if (!Aentry.Owner)
+        {
+            if ((Aentry.Bid != 0) && Aentry.Bidder)         // Add bided by player
+            {
+                config.CheckedEntry[auctionId].LastExist = Now;
+                config.CheckedEntry[auctionId].AuctionId = auctionId;
+                ++count;
+            }
+        }
+        else
+        {
+            if (Aentry.Bid != 0)
+            {
+                if (Aentry.Bidder)
                 {
-                    if (Aentry->bid != 0)
-                    {
-                        if (Aentry->bidder)
-                        {
-                            config.CheckedEntry[Aentry->Id].LastExist = Now;
-                            config.CheckedEntry[Aentry->Id].AuctionId = Aentry->Id;
-                            ++count;
-                        }
-                    }
-                    else
-                    {
-                        config.CheckedEntry[Aentry->Id].LastExist = Now;
-                        config.CheckedEntry[Aentry->Id].AuctionId = Aentry->Id;
-                        ++count;
-                    }
+                    config.CheckedEntry[auctionId].LastExist = Now;
+                    config.CheckedEntry[auctionId].AuctionId = auctionId;
+                    ++count;
                 }
             }
+            else
+            {
+                config.CheckedEntry[auctionId].LastExist = Now;
+                config.CheckedEntry[auctionId].AuctionId = auctionId;
+                ++count;
+            }
         }
     }
 
@@ -713,22 +794,51 @@ bool AuctionBotBuyer::IsBidableEntry(uint32 bidPrice, double InGame_BuyPrice, do
     }
 }
 
-void AuctionBotBuyer::PlaceBidToEntry(AuctionEntry* auction, uint32 bidPrice) const
+void AuctionBotBuyer::PlaceBidToEntry(AHB_Buyer_Config& config, uint32 auctionId, BuyerAuctionInfo const& auction, uint32 bidPrice) const
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Bid placed to entry %u, %.2fg", auction->Id, float(bidPrice) / 10000.0f);
-    auction->UpdateBid(bidPrice);
+    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Bid placed to entry %u, %.2fg", auctionId, float(bidPrice) / 10000.0f);
+
+    BuyerBid bid;
+    bid.AuctionId = auctionId;
+    bid.CurrentBid = auction.Bid;
+    bid.Price = bidPrice;
+    config.PlannedBids.push_back(bid);
 }
 
-void AuctionBotBuyer::BuyEntry(AuctionEntry* auction) const
+void AuctionBotBuyer::BuyEntry(AHB_Buyer_Config& config, uint32 auctionId, BuyerAuctionInfo const& auction) const
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u buyed at %.2fg", auction->Id, float(auction->buyout) / 10000.0f);
-    auction->UpdateBid(auction->buyout);
+    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u buyed at %.2fg", auctionId, float(auction.Buyout) / 10000.0f);
+
+    BuyerBid bid;
+    bid.AuctionId = auctionId;
+    bid.CurrentBid = auction.Bid;
+    bid.Price = auction.Buyout;
+    config.PlannedBids.push_back(bid);
 }
 
-void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
+void AuctionBotBuyer::ApplyPlannedBids(AHB_Buyer_Config& config) const
 {
     AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(config.GetHouseType());
+    uint32 batchSize = sAuctionBotConfig.getConfig(CONFIG_UINT32_AHBOT_APPLY_BATCH_SIZE);
+
+    for (uint32 count = 0; config.AppliedBids < config.PlannedBids.size() && (!batchSize || count < batchSize); ++count)
+    {
+        BuyerBid const& bid = config.PlannedBids[config.AppliedBids++];
+
+        // auction is gone or a player did bid since the bid was chosen
+        AuctionEntry* auction = auctionHouse->GetAuction(bid.AuctionId);
+        if (!auction || auction->bid != bid.CurrentBid)
+        {
+            DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u changed since bid was chosen, skipped", bid.AuctionId);
+            continue;
+        }
+
+        auction->UpdateBid(bid.Price);
+    }
+}
 
+void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
+{
     PrepareListOfEntry(config);
 
     time_t Now = time(nullptr);
@@ -744,11 +854,11 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
     for (CheckEntryMap::iterator itr = config.CheckedEntry.begin(); itr != config.CheckedEntry.end();)
     {
         BuyerAuctionEval& auctionEval = itr->second;
-        AuctionEntry* auction = auctionHouse->GetAuction(auctionEval.AuctionId);
-        if (!auction)                                       // is auction not active now
+        BuyerAuctionInfoMap::const_iterator auctionItr = config.Auctions.find(auctionEval.AuctionId);
+        if (auctionItr == config.Auctions.end())            // is auction not active now or item not accessible (payment pending mode)
         {
-            DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u on ah %u doesn't exists, perhaps bought already?",
-                             auctionEval.AuctionId, auction->GetHouseId());
+            DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Entry %u on ah type %u doesn't exists, perhaps bought already?",
+                             auctionEval.AuctionId, config.GetHouseType());
 
             config.CheckedEntry.erase(itr++);
             continue;
@@ -756,7 +866,7 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
 
         if ((auctionEval.LastChecked != 0) && ((Now - auctionEval.LastChecked) <= m_CheckInterval))
         {
-            DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: In time interval wait for entry %u!", auction->Id);
+            DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: In time interval wait for entry %u!", auctionEval.AuctionId);
             ++itr;
             continue;
         }
@@ -766,32 +876,25 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
 
         uint32 MaxChance = 5000;
 
-        Item* item = sAuctionMgr.GetAItem(auction->itemGuidLow);
-        if (!item)                                          // auction item not accessible, possible auction in payment pending mode
-        {
-            config.CheckedEntry.erase(itr++);
-            continue;
-        }
-
-        ItemPrototype const* prototype = item->GetProto();
+        BuyerAuctionInfo const& auction = auctionItr->second;
 
-        uint32 BasePrice = sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_BUYPRICE_BUYER) ? prototype->BuyPrice : prototype->SellPrice;
-        BasePrice *= item->GetCount();
+        uint32 BasePrice = sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_BUYPRICE_BUYER) ? auction.BuyPrice : auction.SellPrice;
+        BasePrice *= auction.ItemCount;
 
         double MaxBuyablePrice = (BasePrice * config.BuyerPriceRatio) / 100;
-        uint32 buyoutPrice = auction->buyout / item->GetCount();
+        uint32 buyoutPrice = auction.Buyout / auction.ItemCount;
         uint32 bidPrice;
         uint32 bidPriceByItem;
 
-        if (auction->bid >= auction->startbid)
+        if (auction.Bid >= auction.StartBid)
         {
-            bidPrice = auction->GetAuctionOutBid();
-            bidPriceByItem = auction->bid / item->GetCount();
+            bidPrice = auction.OutBid;
+            bidPriceByItem = auction.Bid / auction.ItemCount;
         }
         else
         {
-            bidPrice = auction->startbid;
-            bidPriceByItem = auction->startbid / item->GetCount();
+            bidPrice = auction.StartBid;
+            bidPriceByItem = auction.StartBid / auction.ItemCount;
         }
 
         double InGame_BuyPrice;
@@ -799,7 +902,7 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
         uint32 minBidPrice;
         uint32 minBuyPrice;
 
-        BuyerItemInfoMap::iterator sameitem_itr = config.SameItemInfo.find(item->GetEntry());
+        BuyerItemInfoMap::iterator sameitem_itr = config.SameItemInfo.find(auction.ItemEntry);
         if (sameitem_itr == config.SameItemInfo.end())
         {
             InGame_BuyPrice = 0;
@@ -829,28 +932,28 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
                          minBuyPrice / 10000, minBidPrice / 10000);
         DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: Actual Entry price,  Buy=%ug, Bid=%ug.", buyoutPrice / 10000, bidPrice / 10000);
 
-        if (!auction->owner)                // Original auction owner
+        if (!auction.Owner)                 // Original auction owner
         {
             MaxChance = MaxChance / 5;      // if Owner is AHBot this mean player placed bid on this auction. We divide by 5 chance for AhBuyer to place bid on it. (This make more challenge than ignore entry)
         }
-        if (auction->buyout != 0)           // Is the item directly buyable?
+        if (auction.Buyout != 0)            // Is the item directly buyable?
         {
             if (IsBuyableEntry(buyoutPrice, InGame_BuyPrice, MaxBuyablePrice, minBuyPrice, MaxChance, config.FactionChance))
             {
                 if (IsBidableEntry(bidPriceByItem, InGame_BuyPrice, MaxBidablePrice, minBidPrice, MaxChance / 2, config.FactionChance))
-                        if (urand(0, 5) == 0) PlaceBidToEntry(auction, bidPrice); else BuyEntry(auction);
+                        if (urand(0, 5) == 0) PlaceBidToEntry(config, auctionEval.AuctionId, auction, bidPrice); else BuyEntry(config, auctionEval.AuctionId, auction);
                 else
-                    BuyEntry(auction);
+                    BuyEntry(config, auctionEval.AuctionId, auction);
             }
             else
             {
                 if (IsBidableEntry(bidPriceByItem, InGame_BuyPrice, MaxBidablePrice, minBidPrice, MaxChance / 2, config.FactionChance))
-                    PlaceBidToEntry(auction, bidPrice);
+                    PlaceBidToEntry(config, auctionEval.AuctionId, auction, bidPrice);
             }
         }
         else // buyout = 0 mean only bid are possible
             if (IsBidableEntry(bidPriceByItem, InGame_BuyPrice, MaxBidablePrice, minBidPrice, MaxChance, config.FactionChance))
-                PlaceBidToEntry(auction, bidPrice);
+                PlaceBidToEntry(config, auctionEval.AuctionId, auction, bidPrice);
 
         auctionEval.LastChecked = Now;
         --BuyCycles;
@@ -861,23 +964,53 @@ void AuctionBotBuyer::addNewAuctionBuyerBotBid(AHB_Buyer_Config& config) const
 
 bool AuctionBotBuyer::Update(AuctionHouseType houseType)
 {
-    if (sAuctionBotConfig.getConfigBuyerEnabled(houseType))
+    if (!sAuctionBotConfig.getConfigBuyerEnabled(houseType))
+        return false;
+
+    AHB_Buyer_Config& config = m_HouseConfig[houseType];
+    if (config.Planning.load(std::memory_order_acquire))   // bids are still chosen
+        return false;
+
+    if (config.AppliedBids < config.PlannedBids.size())
     {
-        DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: %s buying ...", AuctionBotConfig::GetHouseTypeName(houseType));
-        if (GetBuyableEntry(m_HouseConfig[houseType]) > 0)
-            addNewAuctionBuyerBotBid(m_HouseConfig[houseType]);
+        ApplyPlannedBids(config);
         return true;
     }
-    else return false;
+
+    DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_BUYER, "AHBot: %s buying ...", AuctionBotConfig::GetHouseTypeName(houseType));
+
+    config.PlannedBids.clear();
+    config.AppliedBids = 0;
+    LoadAuctions(config);
+
+    config.Planning.store(true, std::memory_order_relaxed);
+    m_planner.Submit([this, &config]()
+    {
+        if (GetBuyableEntry(config) > 0)
+            addNewAuctionBuyerBotBid(config);
+
+        config.Auctions.clear();
+        config.Planning.store(false, std::memory_order_release);
+    });
+
+    // planned in place without planning thread
+    if (!config.Planning.load(std::memory_order_acquire))
+        ApplyPlannedBids(config);
+
+    return true;
 }
 
 //== AuctionBotSeller functions ============================
 
-AuctionBotSeller::AuctionBotSeller()
+AuctionBotSeller::AuctionBotSeller(AuctionBotPlanner& planner) : AuctionBotAgent(planner)
 {
     // Define faction for our main data class.
     for (int i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
+    {
         m_HouseConfig[i].Initialize(AuctionHouseType(i));
+        m_AppliedAuctions[i] = 0;
+        m_Planning[i] = false;
+    }
 }
 
 AuctionBotSeller::~AuctionBotSeller()
@@ -1448,7 +1581,7 @@ uint32 AuctionBotSeller::SetStat(AHB_Seller_Config& config) const
 }
 
 // getRandomArray is used to make aviable the possibility to add any of missed item in place of first one to last one.
-bool AuctionBotSeller::getRandomArray(AHB_Seller_Config& config, RandomArray& ra, const std::vector<std::vector<uint32> >& addedItem) const
+bool AuctionBotSeller::getRandomArray(AHB_Seller_Config const& config, RandomArray& ra, const std::vector<std::vector<uint32> >& addedItem) const
 {
     ra.clear();
     bool Ok = false;
@@ -1471,7 +1604,7 @@ bool AuctionBotSeller::getRandomArray(AHB_Seller_Config& config, RandomArray& ra
 }
 
 // Set items price. All important value are passed by address.
-void AuctionBotSeller::SetPricesOfItem(AHB_Seller_Config& config, uint32& buyp, uint32& bidp, ItemQualities itemQuality)
+void AuctionBotSeller::SetPricesOfItem(AHB_Seller_Config const& config, uint32& buyp, uint32& bidp, ItemQualities itemQuality) const
 {
     double temp_buyp = buyp * (itemQuality < MAX_AUCTION_QUALITY ? (config.GetPriceRatioPerQuality(AuctionQuality(itemQuality)) / 100) : 1);
 
@@ -1536,9 +1669,9 @@ void AuctionBotSeller::SetItemsAmountForQuality(AuctionQuality quality, uint32 v
         LoadItemsQuantity(m_HouseConfig[i]);
 }
 
-// Add new auction to one of the factions.
+// Choose new auctions for one of the factions, they are created later by ApplyPlannedAuctions.
 // Faction and setting assossiated is defined passed argument ( config )
-void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
+void AuctionBotSeller::addNewAuctions(AHB_Seller_Config const& config, SellerAuctionList& auctions) const
 {
     uint32 items;
 
@@ -1550,18 +1683,6 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
     }
     else items = sAuctionBotConfig.GetItemPerCycleNormal();
 
-    uint32 houseid;
-    switch (config.GetHouseType())
-    {
-        case AUCTION_HOUSE_ALLIANCE: houseid =  1; break;
-        case AUCTION_HOUSE_HORDE:    houseid =  6; break;
-        default:                     houseid =  7; break;
-    }
-
-    AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(houseid);
-
-    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(config.GetHouseType());
-
     RandomArray randArray;
     std::vector<std::vector<uint32> > ItemsAdded(MAX_AUCTION_QUALITY, std::vector<uint32> (MAX_ITEM_CLASS));
     // Main loop
@@ -1590,45 +1711,176 @@ void AuctionBotSeller::addNewAuctions(AHB_Seller_Config& config)
             continue;
         }
 
-        uint32 stackCount = urand(1, prototype->GetMaxStackSize());
-
-
-        Item* item = Item::CreateItem(itemID, stackCount);
-        if (!item)
-        {
-            sLog.outError("AHBot: Item::CreateItem() returned nullptr for item %u (stack: %u)", itemID, stackCount);
-            return;
-        }
-
-        uint32 buyoutPrice;
-        uint32 bidPrice = 0;
+        SellerAuction auction;
+        auction.ItemId = itemID;
+        auction.StackCount = urand(1, prototype->GetMaxStackSize());
+        auction.BidPrice = 0;
 
         // Not sure if i will keep the next test
         if (sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_BUYPRICE_SELLER))
-            buyoutPrice  = prototype->BuyPrice * item->GetCount();
+            auction.BuyoutPrice = prototype->BuyPrice * auction.StackCount;
         else
-            buyoutPrice  = prototype->SellPrice * item->GetCount();
+            auction.BuyoutPrice = prototype->SellPrice * auction.StackCount;
 
         // Price of items are set here
-        SetPricesOfItem(config, buyoutPrice, bidPrice, ItemQualities(prototype->Quality));
+        SetPricesOfItem(config, auction.BuyoutPrice, auction.BidPrice, ItemQualities(prototype->Quality));
+
+        auction.Time = urand(config.GetMinTime(), config.GetMaxTime()) * HOUR;
+        auctions.push_back(auction);
+    }
+}
+
+// Create planned auctions, up to AuctionHouseBot.ApplyBatchSize per call, saved in one transaction
+void AuctionBotSeller::ApplyPlannedAuctions(AuctionHouseType houseType)
+{
+    SellerAuctionList& auctions = m_PlannedAuctions[houseType];
+    size_t& applied = m_AppliedAuctions[houseType];
+
+    uint32 houseid;
+    switch (houseType)
+    {
+        case AUCTION_HOUSE_ALLIANCE: houseid =  1; break;
+        case AUCTION_HOUSE_HORDE:    houseid =  6; break;
+        default:                     houseid =  7; break;
+    }
+
+    AuctionHouseEntry const* ahEntry = sAuctionHouseStore.LookupEntry(houseid);
+
+    AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(houseType);
+
+    uint32 batchSize = sAuctionBotConfig.getConfig(CONFIG_UINT32_AHBOT_APPLY_BATCH_SIZE);
+
+    CharacterDatabase.BeginTransaction();
+
+    for (uint32 count = 0; applied < auctions.size() && (!batchSize || count < batchSize); ++count)
+    {
+        SellerAuction const& auction = auctions[applied++];
+
+        Item* item = Item::CreateItem(auction.ItemId, auction.StackCount);
+        if (!item)
+        {
+            sLog.outError("AHBot: Item::CreateItem() returned nullptr for item %u (stack: %u)", auction.ItemId, auction.StackCount);
+            applied = auctions.size();
+            break;
+        }
 
-        auctionHouse->AddAuction(ahEntry, item, urand(config.GetMinTime(), config.GetMaxTime()) * HOUR, bidPrice, buyoutPrice);
+        auctionHouse->AddAuction(ahEntry, item, auction.Time, auction.BidPrice, auction.BuyoutPrice);
     }
+
+    CharacterDatabase.CommitTransaction();
 }
 
 bool AuctionBotSeller::Update(AuctionHouseType houseType)
 {
     if (sAuctionBotConfig.getConfigItemAmountRatio(houseType) > 0)
     {
+        if (m_Planning[houseType].load(std::memory_order_acquire)) // auctions are still chosen
+            return false;
+
+        if (m_AppliedAuctions[houseType] < m_PlannedAuctions[houseType].size())
+        {
+            ApplyPlannedAuctions(houseType);
+            return true;
+        }
+
         DEBUG_FILTER_LOG(LOG_FILTER_AHBOT_SELLER, "AHBot: %s selling ...", AuctionBotConfig::GetHouseTypeName(houseType));
         if (SetStat(m_HouseConfig[houseType]))
-            addNewAuctions(m_HouseConfig[houseType]);
+        {
+            m_PlannedAuctions[houseType].clear();
+            m_AppliedAuctions[houseType] = 0;
+
+            // the job works on a copy, console commands may change the house config meanwhile
+            AHB_Seller_Config config = m_HouseConfig[houseType];
+
+            m_Planning[houseType].store(true, std::memory_order_relaxed);
+            m_planner.Submit([this, houseType, config]()
+            {
+                addNewAuctions(config, m_PlannedAuctions[houseType]);
+                m_Planning[houseType].store(false, std::memory_order_release);
+            });
+
+            // planned in place without planning thread
+            if (!m_Planning[houseType].load(std::memory_order_acquire))
+                ApplyPlannedAuctions(houseType);
+        }
         return true;
     }
     else
         return false;
 }
 
+//== AuctionBotPlanner functions ===========================
+
+void AuctionBotPlanner::Activate()
+{
+    if (IsActive())
+        return;
+
+    m_cancel = false;
+    m_worker = std::thread(&AuctionBotPlanner::WorkerThread, this);
+}
+
+void AuctionBotPlanner::Deactivate()
+{
+    if (!IsActive())
+        return;
+
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_cancel = true;
+    }
+    m_queueCondition.notify_all();
+
+    m_worker.join();
+}
+
+void AuctionBotPlanner::Submit(Job const& job)
+{
+    if (!IsActive())
+    {
+        job();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_queue.push_back(job);
+    }
+    m_queueCondition.notify_one();
+}
+
+void AuctionBotPlanner::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idleCondition.wait(lock, [this] { return m_queue.empty() && !m_busy; });
+}
+
+void AuctionBotPlanner::WorkerThread()
+{
+    for (;;)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queueCondition.wait(lock, [this] { return m_cancel || !m_queue.empty(); });
+
+        if (m_queue.empty())                                // cancelled
+            break;
+
+        Job job = m_queue.front();
+        m_queue.pop_front();
+        m_busy = true;
+        lock.unlock();
+
+        job();
+
+        lock.lock();
+        m_busy = false;
+        lock.unlock();
+        m_idleCondition.notify_all();
+    }
+}
+
 //== AuctionHouseBot functions =============================
 
 AuctionHouseBot::AuctionHouseBot() : m_Buyer(nullptr), m_Seller(nullptr), m_OperationSelector(0)
@@ -1637,16 +1889,21 @@ AuctionHouseBot::AuctionHouseBot() : m_Buyer(nullptr), m_Seller(nullptr), m_Oper
 
 AuctionHouseBot::~AuctionHouseBot()
 {
+    m_Planner.Deactivate();                                 // jobs use the agents
+
     delete m_Buyer;
     delete m_Seller;
 }
 
 void AuctionHouseBot::InitilizeAgents()
 {
+    // planning jobs use the agents and the config
+    m_Planner.Deactivate();
+
     if (sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_SELLER_ENABLED))
     {
         delete m_Seller;
-        m_Seller = new AuctionBotSeller();
+        m_Seller = new AuctionBotSeller(m_Planner);
         if (!m_Seller->Initialize())
         {
             delete m_Seller;
@@ -1656,13 +1913,16 @@ void AuctionHouseBot::InitilizeAgents()
     if (sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_BUYER_ENABLED))
     {
         delete m_Buyer;
-        m_Buyer = new AuctionBotBuyer();
+        m_Buyer = new AuctionBotBuyer(m_Planner);
         if (!m_Buyer->Initialize())
         {
             delete m_Buyer;
             m_Buyer = nullptr;
         }
     }
+
+    if ((m_Buyer || m_Seller) && sAuctionBotConfig.getConfig(CONFIG_BOOL_AHBOT_PLANNING_THREAD))
+        m_Planner.Activate();
 }
 
 void AuctionHouseBot::Initialize()
@@ -1697,6 +1957,8 @@ void AuctionHouseBot::SetItemsAmountForQuality(AuctionQuality quality, uint32 va
 
 bool AuctionHouseBot::ReloadAllConfig()
 {
+    m_Planner.Wait();                                       // jobs read the config
+
     if (!sAuctionBotConfig.Reload())
     {
         sLog.outError("AHBot: Error while trying to reload config from file!");
@@ -1739,13 +2001,14 @@ void AuctionHouseBot::Rebuild(bool all) const
 {
     for (uint32 i = 0; i < MAX_AUCTION_HOUSE_TYPE; ++i)
     {
-        AuctionHouseObject::AuctionEntryMapBounds bounds = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i))->GetAuctionsBounds();
+        AuctionHouseObject* auctionHouse = sAuctionMgr.GetAuctionsMap(AuctionHouseType(i));
+        AuctionHouseObject::AuctionEntryMapBounds bounds = auctionHouse->GetAuctionsBounds();
         for (AuctionHouseObject::AuctionEntryMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
         {
             AuctionEntry* entry = itr->second;
             if (!entry->owner)                              // ahbot auction
                 if (all || entry->bid == 0)                 // expire now auction if no bid or forced
-                    entry->expireTime = sWorld.GetGameTime();
+                    auctionHouse->SetAuctionExpireTime(entry, sWorld.GetGameTime());
         }
     }
 }
@@ -24,6 +24,13 @@
 #include "SharedDefines.h"
 #include "Item.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 // shadow of ItemQualities with skipped ITEM_QUALITY_HEIRLOOM, anything after ITEM_QUALITY_ARTIFACT(6) in fact
 enum AuctionQuality
 {
@@ -94,6 +101,7 @@ enum AuctionBotConfigUInt32Values
     CONFIG_UINT32_AHBOT_CLASS_TRADEGOOD_MAX_ITEM_LEVEL,
     CONFIG_UINT32_AHBOT_CLASS_CONTAINER_MIN_ITEM_LEVEL,
     CONFIG_UINT32_AHBOT_CLASS_CONTAINER_MAX_ITEM_LEVEL,
+    CONFIG_UINT32_AHBOT_APPLY_BATCH_SIZE,
     CONFIG_UINT32_AHBOT_UINT32_COUNT
 };
 
@@ -117,6 +125,7 @@ enum AuctionBotConfigBoolValues
     CONFIG_BOOL_AHBOT_SELLER_ENABLED,
     CONFIG_BOOL_AHBOT_BUYER_ENABLED,
     CONFIG_BOOL_AHBOT_LOCKBOX_ENABLED,
+    CONFIG_BOOL_AHBOT_PLANNING_THREAD,
     CONFIG_UINT32_AHBOT_BOOL_COUNT
 };
 
@@ -171,14 +180,53 @@ class AuctionBotConfig
 
 #define sAuctionBotConfig MaNGOS::Singleton<AuctionBotConfig>::Instance()
 
+/**
+ * Runs the planning work of the bot agents (item choice, pricing, bid choice) in its own thread.
+ *
+ * Jobs only work on data copied from the auction houses by the world thread and on agent data
+ * the world thread does not touch until the job reports completion, their results are applied
+ * by the agents in later AuctionHouseBot::Update calls. Without the thread (AuctionHouseBot.PlanningThread
+ * disabled) jobs run directly in Submit.
+ */
+class AuctionBotPlanner
+{
+    public:
+        typedef std::function<void()> Job;
+
+        AuctionBotPlanner() : m_cancel(false), m_busy(false) {}
+        ~AuctionBotPlanner() { Deactivate(); }
+
+        void Activate();
+        void Deactivate();                                  // finishes all submitted jobs first
+        bool IsActive() const { return m_worker.joinable(); }
+
+        void Submit(Job const& job);
+        void Wait();                                        // returns when no job is queued or running
+
+    private:
+        void WorkerThread();
+
+        std::thread m_worker;
+        std::deque<Job> m_queue;
+        bool m_cancel;
+        bool m_busy;                                        // worker runs a job
+
+        std::mutex m_mutex;
+        std::condition_variable m_queueCondition;
+        std::condition_variable m_idleCondition;
+};
+
 class AuctionBotAgent
 {
     public:
-        AuctionBotAgent() {}
+        explicit AuctionBotAgent(AuctionBotPlanner& planner) : m_planner(planner) {}
         virtual ~AuctionBotAgent() {}
     public:
         virtual bool Initialize() = 0;
         virtual bool Update(AuctionHouseType houseType) = 0;
+
+    protected:
+        AuctionBotPlanner& m_planner;
 };
 
 struct AuctionHouseBotStatusInfoPerType
@@ -214,6 +262,7 @@ class AuctionHouseBot
 
         AuctionBotAgent* m_Buyer;
         AuctionBotAgent* m_Seller;
+        AuctionBotPlanner m_Planner;
 
         uint32 m_OperationSelector;                         // 0..2*MAX_AUCTION_HOUSE_TYPE-1
 };
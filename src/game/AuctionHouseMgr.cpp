@@ -36,6 +36,8 @@
 
 #include "Policies/Singleton.h"
 
+#include <algorithm>
+
 INSTANTIATE_SINGLETON_1(AuctionHouseMgr);
 
 AuctionHouseMgr::AuctionHouseMgr()
@@ -524,30 +526,44 @@ AuctionHouseEntry const* AuctionHouseMgr::GetAuctionHouseEntry(Unit* unit)
 void AuctionHouseObject::Update()
 {
     time_t curTime = sWorld.GetGameTime();
-    ///- Handle expired auctions
-    for (AuctionEntryMap::iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end();)
+    std::vector<uint32> finished;
+
+    ///- Handle expired auctions, ordered by expire time so only these are visited
+    while (!m_expireIndex.empty() && m_expireIndex.begin()->first <= curTime)
     {
-        if (curTime < itr->second->expireTime)
-        {
-            itr++;
+        AuctionEntry* auction = GetAuction(m_expireIndex.begin()->second);
+        m_expireIndex.erase(m_expireIndex.begin());
+        if (!auction)
             continue;
-        }
+
+        finished.push_back(auction->Id);
 
         ///- perform the transaction if there was bidder.  this will alyways have the side effect of
-        ///- removing the auction from the collection.  therefore we must increment the iterator here.
-        if (itr->second->bid)
-            (itr++)->second->AuctionBidWinning();
+        ///- removing the auction from the collection and the expire index.
+        if (auction->bid)
+            auction->AuctionBidWinning(nullptr, false);
         ///- cancel the auction if there was no bidder and clear the auction
         else
         {
-            sAuctionMgr.SendAuctionExpiredMail(itr->second);
+            sAuctionMgr.SendAuctionExpiredMail(auction);
 
-            itr->second->DeleteFromDB();
-            sAuctionMgr.RemoveAItem(itr->second->itemGuidLow);
-            delete itr->second;
-            AuctionsMap.erase(itr++);
+            sAuctionMgr.RemoveAItem(auction->itemGuidLow);
+            RemoveAuction(auction->Id);
+            delete auction;
         }
     }
+
+    ///- delete the finished auctions with one statement per batch instead of one per auction
+    for (size_t i = 0; i < finished.size();)
+    {
+        std::ostringstream ss;
+        ss << "DELETE FROM auction WHERE id IN (";
+        for (size_t j = 0; j < 500 && i < finished.size(); ++i, ++j)
+            ss << (j ? "," : "") << finished[i];
+        ss << ")";
+
+        CharacterDatabase.Execute(ss.str().c_str());
+    }
 }
 
 void AuctionHouseObject::BuildListBidderItems(WorldPacket& data, Player* player, uint32& count, uint32& totalcount)
@@ -584,64 +600,335 @@ void AuctionHouseObject::BuildListAuctionItems(WorldPacket& data, Player* player
         uint32& count, uint32& totalcount)
 {
     int loc_idx = player->GetSession()->GetSessionDbLocaleIndex();
+    AuctionNameIndex const& nameIndex = GetNameIndex(loc_idx);
 
-    for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+    // visit only the auctions of the most selective index, the filters below still check everything
+    AuctionIdSetList candidates;
+    size_t candidateCount = AuctionsMap.size();
+    bool allAuctions = true;
+
+    AuctionIdSetList sets;
+    for (uint32 i = 0; i < 6; ++i)
+    {
+        sets.clear();
+        switch (i)
+        {
+            case 0:
+                if (itemClass == 0xffffffff)
+                    continue;
+                SelectIndexRange(m_classIndex, itemClass, itemClass, sets);
+                break;
+            case 1:
+                if (itemClass == 0xffffffff || itemSubClass == 0xffffffff)
+                    continue;
+                SelectIndexRange(m_subClassIndex, itemClass << 16 | itemSubClass, itemClass << 16 | itemSubClass, sets);
+                break;
+            case 2:
+                if (inventoryType == 0xffffffff)
+                    continue;
+                SelectIndexRange(m_inventoryTypeIndex, inventoryType, inventoryType, sets);
+                break;
+            case 3:
+                if (quality == 0xffffffff)
+                    continue;
+                SelectIndexRange(m_qualityIndex, quality, 0xffffffff, sets);
+                break;
+            case 4:
+                if (levelmin == 0x00)
+                    continue;
+                SelectIndexRange(m_levelIndex, levelmin, levelmax != 0x00 ? levelmax : 0xffffffff, sets);
+                break;
+            case 5:
+                if (wsearchedname.empty() || !SelectNameIndex(nameIndex, wsearchedname, sets))
+                    continue;
+                break;
+        }
+
+        size_t size = 0;
+        for (AuctionIdSetList::const_iterator itr = sets.begin(); itr != sets.end(); ++itr)
+            size += (*itr)->size();
+
+        if (size < candidateCount)
+        {
+            candidates.swap(sets);
+            candidateCount = size;
+            allAuctions = false;
+        }
+    }
+
+    auto checkAuction = [&](AuctionEntry* Aentry)
     {
-        AuctionEntry* Aentry = itr->second;
         Item* item = sAuctionMgr.GetAItem(Aentry->itemGuidLow);
         if (!item)
-            continue;
+            return;
 
-        {
-            ItemPrototype const* proto = item->GetProto();
+        ItemPrototype const* proto = item->GetProto();
 
-            if (itemClass != 0xffffffff && proto->Class != itemClass)
-                continue;
+        if (itemClass != 0xffffffff && proto->Class != itemClass)
+            return;
 
-            if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
-                continue;
+        if (itemSubClass != 0xffffffff && proto->SubClass != itemSubClass)
+            return;
 
-            if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
-                continue;
+        if (inventoryType != 0xffffffff && proto->InventoryType != inventoryType)
+            return;
 
-            if (quality != 0xffffffff && proto->Quality < quality)
-                continue;
+        if (quality != 0xffffffff && proto->Quality < quality)
+            return;
 
-            if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
-                continue;
+        if (levelmin != 0x00 && (proto->RequiredLevel < levelmin || (levelmax != 0x00 && proto->RequiredLevel > levelmax)))
+            return;
 
-            if (usable != 0x00)
-            {
-                if (player->CanUseItem(item) != EQUIP_ERR_OK)
-                    continue;
+        if (usable != 0x00)
+        {
+            if (player->CanUseItem(item) != EQUIP_ERR_OK)
+                return;
 
-                if (proto->Class == ITEM_CLASS_RECIPE)
+            if (proto->Class == ITEM_CLASS_RECIPE)
+            {
+                if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
                 {
-                    if (SpellEntry const* spell = sSpellTemplate.LookupEntry<SpellEntry>(proto->Spells[0].SpellId))
-                    {
-                        if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
-                            continue;
-                    }
+                    if (player->HasSpell(spell->EffectTriggerSpell[EFFECT_INDEX_0]))
+                        return;
                 }
             }
+        }
 
-            std::string name = proto->Name1;
-            sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &name);
+        if (!wsearchedname.empty())
+        {
+            std::unordered_map<uint32, std::wstring>::const_iterator name = nameIndex.names.find(proto->ItemId);
+            if (name == nameIndex.names.end() || name->second.find(wsearchedname) == std::wstring::npos)
+                return;
+        }
+
+        if (count < 50 && totalcount >= listfrom)
+        {
+            ++count;
+            Aentry->BuildAuctionInfo(data);
+        }
+
+        ++totalcount;
+    };
+
+    if (allAuctions)
+    {
+        for (AuctionEntryMap::const_iterator itr = AuctionsMap.begin(); itr != AuctionsMap.end(); ++itr)
+            checkAuction(itr->second);
+    }
+    else if (candidates.size() == 1)
+    {
+        for (AuctionIdSet::const_iterator itr = candidates[0]->begin(); itr != candidates[0]->end(); ++itr)
+            checkAuction(AuctionsMap.find(*itr)->second);
+    }
+    else
+    {
+        std::vector<uint32> ids;
+        ids.reserve(candidateCount);
+        for (AuctionIdSetList::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+            ids.insert(ids.end(), (*itr)->begin(), (*itr)->end());
+
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
 
-            if (!wsearchedname.empty() && !Utf8FitTo(name, wsearchedname))
-                continue;
+        for (std::vector<uint32>::const_iterator itr = ids.begin(); itr != ids.end(); ++itr)
+            checkAuction(AuctionsMap.find(*itr)->second);
+    }
+}
+
+void AuctionHouseObject::AddAuction(AuctionEntry* ah)
+{
+    MANGOS_ASSERT(ah);
+
+    AuctionEntryMap::iterator itr = AuctionsMap.find(ah->Id);
+    if (itr != AuctionsMap.end())
+    {
+        UnindexAuction(itr->second);
+        itr->second = ah;
+    }
+    else
+        AuctionsMap[ah->Id] = ah;
+
+    IndexAuction(ah);
+}
+
+bool AuctionHouseObject::RemoveAuction(uint32 id)
+{
+    AuctionEntryMap::iterator itr = AuctionsMap.find(id);
+    if (itr == AuctionsMap.end())
+        return false;
+
+    UnindexAuction(itr->second);
+    AuctionsMap.erase(itr);
+    return true;
+}
+
+void AuctionHouseObject::SetAuctionExpireTime(AuctionEntry* auction, time_t expireTime)
+{
+    m_expireIndex.erase(std::make_pair(auction->expireTime, auction->Id));
+    auction->expireTime = expireTime;
+    m_expireIndex.insert(std::make_pair(auction->expireTime, auction->Id));
+}
+
+void AuctionHouseObject::IndexAuction(AuctionEntry const* auction)
+{
+    m_expireIndex.insert(std::make_pair(auction->expireTime, auction->Id));
 
-            if (count < 50 && totalcount >= listfrom)
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+        return;
+
+    m_classIndex[proto->Class].insert(auction->Id);
+    m_subClassIndex[proto->Class << 16 | proto->SubClass].insert(auction->Id);
+    m_inventoryTypeIndex[proto->InventoryType].insert(auction->Id);
+    m_qualityIndex[proto->Quality].insert(auction->Id);
+    m_levelIndex[proto->RequiredLevel].insert(auction->Id);
+
+    for (AuctionNameIndexMap::iterator itr = m_nameIndexes.begin(); itr != m_nameIndexes.end(); ++itr)
+        IndexAuctionName(itr->second, itr->first, auction);
+}
+
+static void RemoveFromIndex(std::map<uint32, std::set<uint32> >& index, uint32 key, uint32 auctionId)
+{
+    std::map<uint32, std::set<uint32> >::iterator itr = index.find(key);
+    if (itr == index.end())
+        return;
+
+    itr->second.erase(auctionId);
+    if (itr->second.empty())
+        index.erase(itr);
+}
+
+void AuctionHouseObject::UnindexAuction(AuctionEntry const* auction)
+{
+    m_expireIndex.erase(std::make_pair(auction->expireTime, auction->Id));
+
+    ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+    if (!proto)
+        return;
+
+    RemoveFromIndex(m_classIndex, proto->Class, auction->Id);
+    RemoveFromIndex(m_subClassIndex, proto->Class << 16 | proto->SubClass, auction->Id);
+    RemoveFromIndex(m_inventoryTypeIndex, proto->InventoryType, auction->Id);
+    RemoveFromIndex(m_qualityIndex, proto->Quality, auction->Id);
+    RemoveFromIndex(m_levelIndex, proto->RequiredLevel, auction->Id);
+
+    for (AuctionNameIndexMap::iterator itr = m_nameIndexes.begin(); itr != m_nameIndexes.end(); ++itr)
+        UnindexAuctionName(itr->second, auction);
+}
+
+void AuctionHouseObject::IndexAuctionName(AuctionNameIndex& nameIndex, int loc_idx, AuctionEntry const* auction)
+{
+    std::unordered_map<uint32, std::wstring>::iterator name = nameIndex.names.find(auction->itemTemplate);
+    if (name == nameIndex.names.end())
+    {
+        ItemPrototype const* proto = ObjectMgr::GetItemPrototype(auction->itemTemplate);
+        if (!proto)
+            return;
+
+        std::string localeName = proto->Name1;
+        sObjectMgr.GetItemLocaleStrings(proto->ItemId, loc_idx, &localeName);
+
+        // name stays empty if not convertible, such items never match a name search
+        std::wstring wname;
+        if (Utf8toWStr(localeName, wname))
+            wstrToLower(wname);
+        else
+            wname.clear();
+
+        name = nameIndex.names.insert(std::make_pair(auction->itemTemplate, wname)).first;
+    }
+
+    std::wstring const& wname = name->second;
+    for (size_t start = 0; start < wname.size();)
+    {
+        size_t end = wname.find(L' ', start);
+        if (end == std::wstring::npos)
+            end = wname.size();
+
+        if (end > start)
+            nameIndex.words[wname.substr(start, end - start)].insert(auction->Id);
+
+        start = end + 1;
+    }
+}
+
+void AuctionHouseObject::UnindexAuctionName(AuctionNameIndex& nameIndex, AuctionEntry const* auction)
+{
+    std::unordered_map<uint32, std::wstring>::const_iterator name = nameIndex.names.find(auction->itemTemplate);
+    if (name == nameIndex.names.end())
+        return;
+
+    std::wstring const& wname = name->second;
+    for (size_t start = 0; start < wname.size();)
+    {
+        size_t end = wname.find(L' ', start);
+        if (end == std::wstring::npos)
+            end = wname.size();
+
+        if (end > start)
+        {
+            std::map<std::wstring, AuctionIdSet>::iterator word = nameIndex.words.find(wname.substr(start, end - start));
+            if (word != nameIndex.words.end())
             {
-                ++count;
-                Aentry->BuildAuctionInfo(data);
+                word->second.erase(auction->Id);
+                if (word->second.empty())
+                    nameIndex.words.erase(word);
             }
         }
 
-        ++totalcount;
+        start = end + 1;
     }
 }
 
+AuctionHouseObject::AuctionNameIndex& AuctionHouseObject::GetNameIndex(int loc_idx)
+{
+    AuctionNameIndexMap::iterator itr = m_nameIndexes.find(loc_idx);
+    if (itr != m_nameIndexes.end())
+        return itr->second;
+
+    AuctionNameIndex& nameIndex = m_nameIndexes[loc_idx];
+    for (AuctionEntryMap::const_iterator auction = AuctionsMap.begin(); auction != AuctionsMap.end(); ++auction)
+        IndexAuctionName(nameIndex, loc_idx, auction->second);
+
+    return nameIndex;
+}
+
+void AuctionHouseObject::SelectIndexRange(AuctionIndex const& index, uint32 minKey, uint32 maxKey, AuctionIdSetList& sets)
+{
+    if (minKey > maxKey)
+        return;
+
+    for (AuctionIndex::const_iterator itr = index.lower_bound(minKey); itr != index.end() && itr->first <= maxKey; ++itr)
+        sets.push_back(&itr->second);
+}
+
+bool AuctionHouseObject::SelectNameIndex(AuctionNameIndex const& nameIndex, std::wstring const& wsearchedname, AuctionIdSetList& sets)
+{
+    // every word of the searched text is part of a word of a matching name (the first and last
+    // ones may be cut), so the auctions of all name words containing the longest one are a superset
+    std::wstring longest;
+    for (size_t start = 0; start < wsearchedname.size();)
+    {
+        size_t end = wsearchedname.find(L' ', start);
+        if (end == std::wstring::npos)
+            end = wsearchedname.size();
+
+        if (end - start > longest.size())
+            longest = wsearchedname.substr(start, end - start);
+
+        start = end + 1;
+    }
+
+    if (longest.empty())                                    // only spaces searched, no word to select by
+        return false;
+
+    for (std::map<std::wstring, AuctionIdSet>::const_iterator itr = nameIndex.words.begin(); itr != nameIndex.words.end(); ++itr)
+        if (itr->first.size() >= longest.size() && itr->first.find(longest) != std::wstring::npos)
+            sets.push_back(&itr->second);
+
+    return true;
+}
+
 AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout, uint32 deposit, Player* pl /*= nullptr*/)
 {
     uint32 auction_time = uint32(etime * sWorld.getConfig(CONFIG_FLOAT_RATE_AUCTION_TIME));
@@ -668,7 +955,10 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
     if (pl)
         pl->MoveItemFromInventory(newItem->GetBagSlot(), newItem->GetSlot(), true);
 
-    CharacterDatabase.BeginTransaction();
+    // server generated auctions may be saved in one transaction by the caller
+    bool ownTransaction = !CharacterDatabase.IsInTransaction();
+    if (ownTransaction)
+        CharacterDatabase.BeginTransaction();
 
     if (pl)
         newItem->DeleteFromInventoryDB();
@@ -679,7 +969,8 @@ AuctionEntry* AuctionHouseObject::AddAuction(AuctionHouseEntry const* auctionHou
     if (pl)
         pl->SaveInventoryAndGoldToDB();
 
-    CharacterDatabase.CommitTransaction();
+    if (ownTransaction)
+        CharacterDatabase.CommitTransaction();
 
     return AH;
 }
@@ -746,7 +1037,7 @@ void AuctionEntry::SaveToDB() const
                                Id, auctionHouseEntry->houseId, itemGuidLow, itemTemplate, itemCount, itemRandomPropertyId, owner, buyout, (uint64)expireTime, bidder, bid, startbid, deposit);
 }
 
-void AuctionEntry::AuctionBidWinning(Player* newbidder)
+void AuctionEntry::AuctionBidWinning(Player* newbidder, bool deleteFromDB)
 {
     sAuctionMgr.SendAuctionSuccessfulMail(this);
     sAuctionMgr.SendAuctionWonMail(this);
@@ -754,11 +1045,15 @@ void AuctionEntry::AuctionBidWinning(Player* newbidder)
     sAuctionMgr.RemoveAItem(this->itemGuidLow);
     sAuctionMgr.GetAuctionsMap(this->auctionHouseEntry)->RemoveAuction(this->Id);
 
-    CharacterDatabase.BeginTransaction();
-    this->DeleteFromDB();
-    if (newbidder)
-        newbidder->SaveInventoryAndGoldToDB();
-    CharacterDatabase.CommitTransaction();
+    if (deleteFromDB || newbidder)
+    {
+        CharacterDatabase.BeginTransaction();
+        if (deleteFromDB)
+            this->DeleteFromDB();
+        if (newbidder)
+            newbidder->SaveInventoryAndGoldToDB();
+        CharacterDatabase.CommitTransaction();
+    }
 
     delete this;
 }
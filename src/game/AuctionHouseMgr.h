@@ -73,7 +73,7 @@ struct AuctionEntry
     bool BuildAuctionInfo(WorldPacket& data) const;
     void DeleteFromDB() const;
     void SaveToDB() const;
-    void AuctionBidWinning(Player* bidder = nullptr);
+    void AuctionBidWinning(Player* bidder = nullptr, bool deleteFromDB = true);// deleteFromDB false if the caller deletes the row
     bool UpdateBid(uint32 newbid, Player* newbidder = nullptr);// true if normal bid, false if buyout, bidder==nullptr for generated bid
 };
 
@@ -96,11 +96,7 @@ class AuctionHouseObject
         AuctionEntryMap const& GetAuctions() const { return AuctionsMap; }
         AuctionEntryMapBounds GetAuctionsBounds() const {return AuctionEntryMapBounds(AuctionsMap.begin(), AuctionsMap.end()); }
 
-        void AddAuction(AuctionEntry* ah)
-        {
-            MANGOS_ASSERT(ah);
-            AuctionsMap[ah->Id] = ah;
-        }
+        void AddAuction(AuctionEntry* ah);
 
         AuctionEntry* GetAuction(uint32 id) const
         {
@@ -108,7 +104,9 @@ class AuctionHouseObject
             return itr != AuctionsMap.end() ? itr->second : nullptr;
         }
 
-        bool RemoveAuction(uint32 id) { return !!AuctionsMap.erase(id); }
+        bool RemoveAuction(uint32 id);
+
+        void SetAuctionExpireTime(AuctionEntry* auction, time_t expireTime);
 
         void Update();
 
@@ -120,7 +118,38 @@ class AuctionHouseObject
                                    uint32& count, uint32& totalcount);
         AuctionEntry* AddAuction(AuctionHouseEntry const* auctionHouseEntry, Item* newItem, uint32 etime, uint32 bid, uint32 buyout = 0, uint32 deposit = 0, Player* pl = nullptr);
     private:
+        // search indexes, all keep auction ids so candidates are visited in AuctionsMap order as before
+        typedef std::set<uint32> AuctionIdSet;
+        typedef std::map<uint32, AuctionIdSet> AuctionIndex;
+        typedef std::vector<AuctionIdSet const*> AuctionIdSetList;
+
+        struct AuctionNameIndex                             // for one db locale
+        {
+            std::unordered_map<uint32, std::wstring> names; // item template -> lowered localized name
+            std::map<std::wstring, AuctionIdSet> words;     // lowered word of item names -> auctions
+        };
+
+        typedef std::map<int, AuctionNameIndex> AuctionNameIndexMap;
+        typedef std::set<std::pair<time_t, uint32> > AuctionExpireSet; // expire time, auction id
+
+        void IndexAuction(AuctionEntry const* auction);
+        void UnindexAuction(AuctionEntry const* auction);
+        void IndexAuctionName(AuctionNameIndex& nameIndex, int loc_idx, AuctionEntry const* auction);
+        void UnindexAuctionName(AuctionNameIndex& nameIndex, AuctionEntry const* auction);
+        AuctionNameIndex& GetNameIndex(int loc_idx);
+
+        static void SelectIndexRange(AuctionIndex const& index, uint32 minKey, uint32 maxKey, AuctionIdSetList& sets);
+        static bool SelectNameIndex(AuctionNameIndex const& nameIndex, std::wstring const& wsearchedname, AuctionIdSetList& sets);
+
         AuctionEntryMap AuctionsMap;
+
+        AuctionIndex m_classIndex;                          // item class
+        AuctionIndex m_subClassIndex;                       // item class << 16 | subclass
+        AuctionIndex m_inventoryTypeIndex;
+        AuctionIndex m_qualityIndex;
+        AuctionIndex m_levelIndex;                          // required level
+        AuctionNameIndexMap m_nameIndexes;                  // built on first search of a locale
+        AuctionExpireSet m_expireIndex;                     // Update only visits the expired auctions
 };
 
 enum AuctionHouseType
@@ -440,13 +440,15 @@ void BattleGround::SetTeamStartLoc(Team team, float X, float Y, float Z, float O
 
 void BattleGround::SendPacketToAll(WorldPacket const& packet) const
 {
+    PacketBroadcaster broadcaster(packet);
+
     for (BattleGroundPlayerMap::const_iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
     {
         if (itr->second.OfflineRemoveTime)
             continue;
 
         if (Player* plr = sObjectMgr.GetPlayer(itr->first))
-            plr->GetSession()->SendPacket(packet);
+            broadcaster.SendTo(plr->GetSession());
         else
             sLog.outError("BattleGround:SendPacketToAll: %s not found!", itr->first.GetString().c_str());
     }
@@ -454,6 +456,8 @@ void BattleGround::SendPacketToAll(WorldPacket const& packet) const
 
 void BattleGround::SendPacketToTeam(Team teamId, WorldPacket const& packet, Player* sender, bool self) const
 {
+    PacketBroadcaster broadcaster(packet);
+
     for (BattleGroundPlayerMap::const_iterator itr = m_Players.begin(); itr != m_Players.end(); ++itr)
     {
         if (itr->second.OfflineRemoveTime)
@@ -473,7 +477,7 @@ void BattleGround::SendPacketToTeam(Team teamId, WorldPacket const& packet, Play
         if (!team) team = plr->GetTeam();
 
         if (team == teamId)
-            plr->GetSession()->SendPacket(packet);
+            broadcaster.SendTo(plr->GetSession());
     }
 }
 
@@ -674,10 +674,12 @@ void Channel::SetOwner(ObjectGuid guid, bool exclaim)
 
 void Channel::SendToAll(WorldPacket const& data, ObjectGuid guid) const
 {
+    PacketBroadcaster broadcaster(data);
+
     for (PlayerList::const_iterator i = m_players.begin(); i != m_players.end(); ++i)
         if (Player* plr = sObjectMgr.GetPlayer(i->first))
             if (!guid || !plr->GetSocial()->HasIgnore(guid))
-                plr->GetSession()->SendPacket(data);
+                broadcaster.SendTo(plr->GetSession());
 }
 
 void Channel::SendToOne(WorldPacket const& data, ObjectGuid who) const
@@ -67,6 +67,7 @@ class LoginQueryHolder : public SqlQueryHolder
 bool LoginQueryHolder::Initialize()
 {
     SetSize(MAX_PLAYER_LOGIN_QUERY);
+    SetOrderKey(m_guid.GetCounter());                       // load after pending saves of the character
 
     bool res = true;
 
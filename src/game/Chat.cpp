@@ -184,6 +184,29 @@ ChatCommand* ChatHandler::getCommandTable()
         { nullptr,          0,                  false, nullptr,                                        "", nullptr }
     };
 
+    static ChatCommand debugCompressBenchCommandTable[] =
+    {
+        { "record",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugCompressBenchRecordCommand, "", nullptr },
+        { "",               SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugCompressBenchCommand,       "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                             "", nullptr }
+    };
+
+    static ChatCommand debugLosBenchCommandTable[] =
+    {
+        { "record",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugLosBenchRecordCommand,      "", nullptr },
+        { "",               SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugLosBenchCommand,            "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                             "", nullptr }
+    };
+
+    static ChatCommand debugOpcodeProfileCommandTable[] =
+    {
+        { "enable",         SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeProfileEnableCommand, "", nullptr },
+        { "reset",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeProfileResetCommand,  "", nullptr },
+        { "write",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeProfileWriteCommand,  "", nullptr },
+        { "",               SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugOpcodeProfileCommand,       "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                             "", nullptr }
+    };
+
     static ChatCommand debugPlayCommandTable[] =
     {
         { "cinematic",      SEC_MODERATOR,      false, &ChatHandler::HandleDebugPlayCinematicCommand,       "", nullptr },
@@ -206,17 +229,30 @@ ChatCommand* ChatHandler::getCommandTable()
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
+    static ChatCommand debugUpdateCacheCommandTable[] =
+    {
+        { "reset",          SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugUpdateCacheResetCommand,    "", nullptr },
+        { "",               SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugUpdateCacheCommand,         "", nullptr },
+        { nullptr,          0,                  false, nullptr,                                             "", nullptr }
+    };
+
     static ChatCommand debugCommandTable[] =
     {
         { "anim",           SEC_GAMEMASTER,     false, &ChatHandler::HandleDebugAnimCommand,                "", nullptr },
         { "bg",             SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugBattlegroundCommand,        "", nullptr },
+        { "compressbench",  SEC_ADMINISTRATOR,  true,  nullptr,                                             "", debugCompressBenchCommandTable },
+        { "eventbench",     SEC_CONSOLE,        true,  &ChatHandler::HandleDebugEventBenchCommand,          "", nullptr },
+        { "flushlatency",   SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugFlushLatencyCommand,        "", nullptr },
         { "getitemstate",   SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugGetItemStateCommand,        "", nullptr },
         { "lootrecipient",  SEC_GAMEMASTER,     false, &ChatHandler::HandleDebugGetLootRecipientCommand,    "", nullptr },
+        { "losbench",       SEC_ADMINISTRATOR,  true,  nullptr,                                             "", debugLosBenchCommandTable },
         { "getitemvalue",   SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugGetItemValueCommand,        "", nullptr },
         { "getvalue",       SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugGetValueCommand,            "", nullptr },
         { "moditemvalue",   SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugModItemValueCommand,        "", nullptr },
         { "modvalue",       SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugModValueCommand,            "", nullptr },
+        { "opcodeprofile",  SEC_ADMINISTRATOR,  true,  nullptr,                                             "", debugOpcodeProfileCommandTable },
         { "play",           SEC_MODERATOR,      false, nullptr,                                             "", debugPlayCommandTable },
+        { "recvqueuebench", SEC_CONSOLE,        true,  &ChatHandler::HandleDebugRecvQueueBenchCommand,      "", nullptr },
         { "send",           SEC_ADMINISTRATOR,  false, nullptr,                                             "", debugSendCommandTable },
         { "setaurastate",   SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugSetAuraStateCommand,        "", nullptr },
         { "setitemvalue",   SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugSetItemValueCommand,        "", nullptr },
@@ -224,7 +260,11 @@ ChatCommand* ChatHandler::getCommandTable()
         { "spellcheck",     SEC_CONSOLE,        true,  &ChatHandler::HandleDebugSpellCheckCommand,          "", nullptr },
         { "spellcoefs",     SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugSpellCoefsCommand,          "", nullptr },
         { "spellmods",      SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugSpellModsCommand,           "", nullptr },
+        { "sqlbench",       SEC_CONSOLE,        true,  &ChatHandler::HandleDebugSqlBenchCommand,            "", nullptr },
+        { "sqlqueue",       SEC_ADMINISTRATOR,  true,  &ChatHandler::HandleDebugSqlQueueCommand,            "", nullptr },
+        { "updatecache",    SEC_ADMINISTRATOR,  true,  nullptr,                                             "", debugUpdateCacheCommandTable },
         { "uws",            SEC_ADMINISTRATOR,  false, &ChatHandler::HandleDebugUpdateWorldStateCommand,    "", nullptr },
+        { "whobench",       SEC_CONSOLE,        true,  &ChatHandler::HandleDebugWhoBenchCommand,            "", nullptr },
         { nullptr,          0,                  false, nullptr,                                             "", nullptr }
     };
 
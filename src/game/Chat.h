@@ -218,6 +218,22 @@ class MANGOS_DLL_SPEC ChatHandler
         bool HandleDebugSpellCheckCommand(char* args);
         bool HandleDebugSpellCoefsCommand(char* args);
         bool HandleDebugSpellModsCommand(char* args);
+        bool HandleDebugEventBenchCommand(char* args);
+        bool HandleDebugRecvQueueBenchCommand(char* args);
+        bool HandleDebugSqlBenchCommand(char* args);
+        bool HandleDebugWhoBenchCommand(char* args);
+        bool HandleDebugSqlQueueCommand(char* args);
+        bool HandleDebugCompressBenchCommand(char* args);
+        bool HandleDebugCompressBenchRecordCommand(char* args);
+        bool HandleDebugFlushLatencyCommand(char* args);
+        bool HandleDebugLosBenchCommand(char* args);
+        bool HandleDebugLosBenchRecordCommand(char* args);
+        bool HandleDebugOpcodeProfileCommand(char* args);
+        bool HandleDebugOpcodeProfileEnableCommand(char* args);
+        bool HandleDebugOpcodeProfileResetCommand(char* args);
+        bool HandleDebugOpcodeProfileWriteCommand(char* args);
+        bool HandleDebugUpdateCacheCommand(char* args);
+        bool HandleDebugUpdateCacheResetCommand(char* args);
         bool HandleDebugUpdateWorldStateCommand(char* args);
 
         bool HandleDebugPlayCinematicCommand(char* args);
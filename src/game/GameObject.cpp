@@ -1791,7 +1791,12 @@ void GameObject::UpdateCollisionState() const
     if (!m_model || !IsInWorld())
         return;
 
-    m_model->enable(IsCollisionEnabled() ? true : false);
+    bool enabled = IsCollisionEnabled() ? true : false;
+    if (m_model->isEnabled() == enabled)
+        return;
+
+    m_model->enable(enabled);
+    GetMap()->InvalidateLineOfSightCache();
 }
 
 void GameObject::UpdateModel()
@@ -28,6 +28,9 @@
 #include "Policies/Singleton.h"
 #include "Util.h"
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
 #include <mutex>
 
 char const* MAP_MAGIC         = "MAPS";
@@ -39,6 +42,26 @@ char const* MAP_LIQUID_MAGIC  = "MLIQ";
 static uint16 holetab_h[4] = { 0x1111, 0x2222, 0x4444, 0x8888 };
 static uint16 holetab_v[4] = { 0x000F, 0x00F0, 0x0F00, 0xF000 };
 
+struct GridMapMapping
+{
+    boost::interprocess::mapped_region region;
+};
+
+// pointer to count elements of T at offset inside the mapped file, nullptr if out of bounds or not aligned for T
+template<class T>
+static T* GetMappedArray(uint8 const* base, size_t size, size_t offset, size_t count)
+{
+    if (offset > size || count * sizeof(T) > size - offset)
+        return nullptr;
+
+    uint8 const* data = base + offset;
+    if (reinterpret_cast<uintptr_t>(data) % alignof(T) != 0)
+        return nullptr;
+
+    // data is never written, the pointers are only non const to share members with the heap copy
+    return reinterpret_cast<T*>(const_cast<uint8*>(data));
+}
+
 GridMap::GridMap(): m_gridIntHeightMultiplier(0)
 {
     m_flags = 0;
@@ -64,6 +87,8 @@ GridMap::GridMap(): m_gridIntHeightMultiplier(0)
     m_liquidFlags = nullptr;
     m_liquidEntry = nullptr;
     m_liquid_map  = nullptr;
+
+    m_mapping = nullptr;
 }
 
 GridMap::~GridMap()
@@ -86,6 +111,13 @@ bool GridMap::loadData(char* filename)
     if (header.mapMagic     == *((uint32 const*)(MAP_MAGIC)) &&
             header.versionMagic == *((uint32 const*)(MAP_VERSION_MAGIC)))
     {
+        // files with not aligned sections (older extractor) fall back to the copy below
+        if (sWorld.getConfig(CONFIG_BOOL_GRIDMAP_MEMORY_MAPPED) && mapData(filename, header))
+        {
+            fclose(in);
+            return true;
+        }
+
         // loadup area data
         if (header.areaMapOffset && !loadAreaData(in, header.areaMapOffset, header.areaMapSize))
         {
@@ -129,12 +161,20 @@ bool GridMap::loadData(char* filename)
 
 void GridMap::unloadData()
 {
-    delete[] m_area_map;
-    delete[] m_V9;
-    delete[] m_V8;
-    delete[] m_liquidEntry;
-    delete[] m_liquidFlags;
-    delete[] m_liquid_map;
+    if (m_mapping)
+    {
+        delete m_mapping;
+        m_mapping = nullptr;
+    }
+    else
+    {
+        delete[] m_area_map;
+        delete[] m_V9;
+        delete[] m_V8;
+        delete[] m_liquidEntry;
+        delete[] m_liquidFlags;
+        delete[] m_liquid_map;
+    }
 
     m_area_map = nullptr;
     m_V9 = nullptr;
@@ -250,6 +290,135 @@ bool GridMap::loadGridMapLiquidData(FILE* in, uint32 offset, uint32 /*size*/)
     return true;
 }
 
+bool GridMap::mapData(char const* filename, GridMapFileHeader const& header)
+{
+    m_mapping = new GridMapMapping;
+    try
+    {
+        boost::interprocess::file_mapping file(filename, boost::interprocess::read_only);
+        boost::interprocess::mapped_region(file, boost::interprocess::read_only).swap(m_mapping->region);
+    }
+    catch (boost::interprocess::interprocess_exception const& e)
+    {
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Can't map file '%s' (%s), reading it instead", filename, e.what());
+        unloadData();
+        return false;
+    }
+
+    uint8 const* base = static_cast<uint8 const*>(m_mapping->region.get_address());
+    size_t size = m_mapping->region.get_size();
+
+    if ((header.areaMapOffset && !mapAreaData(base, size, header.areaMapOffset)) ||
+            (header.holesOffset && !mapHolesData(base, size, header.holesOffset)) ||
+            (header.heightMapOffset && !mapHeightData(base, size, header.heightMapOffset)) ||
+            (header.liquidMapOffset && !mapGridMapLiquidData(base, size, header.liquidMapOffset)))
+    {
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Map file '%s' has not aligned or truncated sections, reading it instead", filename);
+        unloadData();
+        return false;
+    }
+
+    return true;
+}
+
+bool GridMap::mapAreaData(uint8 const* base, size_t size, uint32 offset)
+{
+    GridMapAreaHeader const* header = GetMappedArray<GridMapAreaHeader>(base, size, offset, 1);
+    if (!header || header->fourcc != *((uint32 const*)(MAP_AREA_MAGIC)))
+        return false;
+
+    m_gridArea = header->gridArea;
+    if (!(header->flags & MAP_AREA_NO_AREA))
+    {
+        m_area_map = GetMappedArray<uint16>(base, size, offset + sizeof(GridMapAreaHeader), 16 * 16);
+        if (!m_area_map)
+            return false;
+    }
+
+    return true;
+}
+
+bool GridMap::mapHeightData(uint8 const* base, size_t size, uint32 offset)
+{
+    GridMapHeightHeader const* header = GetMappedArray<GridMapHeightHeader>(base, size, offset, 1);
+    if (!header || header->fourcc != *((uint32 const*)(MAP_HEIGHT_MAGIC)))
+        return false;
+
+    m_gridHeight = header->gridHeight;
+    m_gridGetHeight = &GridMap::getHeightFromFlat;
+    if (header->flags & MAP_HEIGHT_NO_HEIGHT)
+        return true;
+
+    size_t v9Offset = offset + sizeof(GridMapHeightHeader);
+    if ((header->flags & MAP_HEIGHT_AS_INT16))
+    {
+        m_uint16_V9 = GetMappedArray<uint16>(base, size, v9Offset, 129 * 129);
+        m_uint16_V8 = GetMappedArray<uint16>(base, size, v9Offset + sizeof(uint16) * 129 * 129, 128 * 128);
+        m_gridIntHeightMultiplier = (header->gridMaxHeight - header->gridHeight) / 65535;
+        m_gridGetHeight = &GridMap::getHeightFromUint16;
+    }
+    else if ((header->flags & MAP_HEIGHT_AS_INT8))
+    {
+        m_uint8_V9 = GetMappedArray<uint8>(base, size, v9Offset, 129 * 129);
+        m_uint8_V8 = GetMappedArray<uint8>(base, size, v9Offset + sizeof(uint8) * 129 * 129, 128 * 128);
+        m_gridIntHeightMultiplier = (header->gridMaxHeight - header->gridHeight) / 255;
+        m_gridGetHeight = &GridMap::getHeightFromUint8;
+    }
+    else
+    {
+        m_V9 = GetMappedArray<float>(base, size, v9Offset, 129 * 129);
+        m_V8 = GetMappedArray<float>(base, size, v9Offset + sizeof(float) * 129 * 129, 128 * 128);
+        m_gridGetHeight = &GridMap::getHeightFromFloat;
+    }
+
+    // union members, set for every height format
+    return m_V9 && m_V8;
+}
+
+bool GridMap::mapHolesData(uint8 const* base, size_t size, uint32 offset)
+{
+    uint8 const* holes = GetMappedArray<uint8>(base, size, offset, sizeof(m_holes));
+    if (!holes)
+        return false;
+
+    memcpy(m_holes, holes, sizeof(m_holes));
+    return true;
+}
+
+bool GridMap::mapGridMapLiquidData(uint8 const* base, size_t size, uint32 offset)
+{
+    GridMapLiquidHeader const* header = GetMappedArray<GridMapLiquidHeader>(base, size, offset, 1);
+    if (!header || header->fourcc != *((uint32 const*)(MAP_LIQUID_MAGIC)))
+        return false;
+
+    m_liquidType    = header->liquidType;
+    m_liquid_offX   = header->offsetX;
+    m_liquid_offY   = header->offsetY;
+    m_liquid_width  = header->width;
+    m_liquid_height = header->height;
+    m_liquidLevel   = header->liquidLevel;
+
+    size_t dataOffset = offset + sizeof(GridMapLiquidHeader);
+    if (!(header->flags & MAP_LIQUID_NO_TYPE))
+    {
+        m_liquidEntry = GetMappedArray<uint16>(base, size, dataOffset, 16 * 16);
+        m_liquidFlags = GetMappedArray<uint8>(base, size, dataOffset + sizeof(uint16) * 16 * 16, 16 * 16);
+        if (!m_liquidEntry || !m_liquidFlags)
+            return false;
+
+        dataOffset += (sizeof(uint16) + sizeof(uint8)) * 16 * 16;
+    }
+
+    if (!(header->flags & MAP_LIQUID_NO_HEIGHT))
+    {
+        m_liquid_map = GetMappedArray<float>(base, size, dataOffset, m_liquid_width * m_liquid_height);
+        if (!m_liquid_map)
+            return false;
+    }
+
+    return true;
+}
+
 uint16 GridMap::getArea(float x, float y) const
 {
     if (!m_area_map)
@@ -699,6 +868,8 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
         {
             m_GridMaps[i][k] = nullptr;
             m_GridRef[i][k] = 0;
+            m_PrefetchedGridMaps[i][k] = nullptr;
+            m_GridPrefetched[i][k] = false;
         }
     }
 
@@ -714,8 +885,13 @@ TerrainInfo::TerrainInfo(uint32 mapid) : m_mapId(mapid)
 TerrainInfo::~TerrainInfo()
 {
     for (int k = 0; k < MAX_NUMBER_OF_GRIDS; ++k)
+    {
         for (int i = 0; i < MAX_NUMBER_OF_GRIDS; ++i)
+        {
             delete m_GridMaps[i][k];
+            delete m_PrefetchedGridMaps[i][k];
+        }
+    }
 
     VMAP::VMapFactory::createOrGetVMapManager()->unloadMap(m_mapId);
     MMAP::MMapFactory::createOrGetMMapManager()->unloadMap(m_mapId);
@@ -760,6 +936,11 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
     if (!i_timer.Passed())
         return;
 
+    // a prefetch thread is loading a grid, retry at next update
+    std::unique_lock<LOCK_TYPE> lock(m_mutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+
     for (int y = 0; y < MAX_NUMBER_OF_GRIDS; ++y)
     {
         for (int x = 0; x < MAX_NUMBER_OF_GRIDS; ++x)
@@ -767,6 +948,18 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
             const int16& iRef = m_GridRef[x][y];
             GridMap* pMap = m_GridMaps[x][y];
 
+            // give prefetched terrain one full interval to get used by a grid load
+            if (GridMap* pPrefetched = m_PrefetchedGridMaps[x][y])
+            {
+                if (m_GridPrefetched[x][y])
+                    m_GridPrefetched[x][y] = false;
+                else
+                {
+                    m_PrefetchedGridMaps[x][y] = nullptr;
+                    delete pPrefetched;
+                }
+            }
+
             // delete those GridMap objects which have refcount = 0
             if (pMap && iRef == 0)
             {
@@ -787,6 +980,32 @@ void TerrainInfo::CleanUpGrids(const uint32 diff)
     i_timer.Reset();
 }
 
+void TerrainInfo::PrefetchGrid(const uint32 x, const uint32 y)
+{
+    MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
+    MANGOS_ASSERT(y < MAX_NUMBER_OF_GRIDS);
+
+    {
+        LOCK_GUARD lock(m_mutex);
+        if (m_GridMaps[x][y] || m_PrefetchedGridMaps[x][y])
+            return;
+    }
+
+    // only the .map file is read here, vmap and mmap tiles are queried by map threads without locks
+    // so LoadMapAndVMap loads them in the map update together with taking over this GridMap
+    GridMap* map = LoadGridMapFile(x, y);
+
+    LOCK_GUARD lock(m_mutex);
+    if (m_GridMaps[x][y] || m_PrefetchedGridMaps[x][y])
+    {
+        delete map;
+        return;
+    }
+
+    m_PrefetchedGridMaps[x][y] = map;
+    m_GridPrefetched[x][y] = true;
+}
+
 int TerrainInfo::RefGrid(const uint32& x, const uint32& y)
 {
     MANGOS_ASSERT(x < MAX_NUMBER_OF_GRIDS);
@@ -1116,22 +1335,15 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
         if (!m_GridMaps[x][y])
         {
-            GridMap* map = new GridMap();
-
-            // map file name
-            int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
-            char* tmp = new char[len];
-            snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
-            DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
-
-            if (!map->loadData(tmp))
+            // take over terrain read by TerrainPrefetcher if any
+            GridMap* map = m_PrefetchedGridMaps[x][y];
+            if (map)
             {
-                sLog.outError("Error load map file: \n %s\n", tmp);
-                // ASSERT(false);
+                m_PrefetchedGridMaps[x][y] = nullptr;
+                m_GridPrefetched[x][y] = false;
             }
-
-            delete[] tmp;
-            m_GridMaps[x][y] = map;
+            else
+                map = LoadGridMapFile(x, y);
 
             // load VMAPs for current map/grid...
             const MapEntry* i_mapEntry = sMapStore.LookupEntry(m_mapId);
@@ -1153,12 +1365,35 @@ GridMap* TerrainInfo::LoadMapAndVMap(const uint32 x, const uint32 y)
 
             // load navmesh
             MMAP::MMapFactory::createOrGetMMapManager()->loadMap(m_mapId, x, y);
+
+            // publish the grid only when all its data is loaded, readers check it without lock
+            m_GridMaps[x][y] = map;
         }
     }
 
     return  m_GridMaps[x][y];
 }
 
+GridMap* TerrainInfo::LoadGridMapFile(const uint32 x, const uint32 y) const
+{
+    GridMap* map = new GridMap();
+
+    // map file name
+    int len = sWorld.GetDataPath().length() + strlen("maps/%03u%02u%02u.map") + 1;
+    char* tmp = new char[len];
+    snprintf(tmp, len, (char*)(sWorld.GetDataPath() + "maps/%03u%02u%02u.map").c_str(), m_mapId, x, y);
+    DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "Loading map %s", tmp);
+
+    if (!map->loadData(tmp))
+    {
+        sLog.outError("Error load map file: \n %s\n", tmp);
+        // ASSERT(false);
+    }
+
+    delete[] tmp;
+    return map;
+}
+
 float TerrainInfo::GetWaterLevel(float x, float y, float z, float* pGround /*= nullptr*/) const
 {
     if (const_cast<TerrainInfo*>(this)->GetGrid(x, y))
@@ -1192,6 +1427,8 @@ TerrainManager::TerrainManager()
 
 TerrainManager::~TerrainManager()
 {
+    m_prefetcher.Deactivate();
+
     for (TerrainDataMap::iterator it = i_TerrainMap.begin(); it != i_TerrainMap.end(); ++it)
         delete it->second;
 }
@@ -1239,12 +1476,22 @@ void TerrainManager::Update(const uint32 diff)
 
 void TerrainManager::UnloadAll()
 {
+    m_prefetcher.Deactivate();
+
     for (TerrainDataMap::iterator it = i_TerrainMap.begin(); it != i_TerrainMap.end(); ++it)
         delete it->second;
 
     i_TerrainMap.clear();
 }
 
+void TerrainManager::SetPrefetchThreads(uint32 numThreads)
+{
+    if (numThreads == 0)
+        m_prefetcher.Deactivate();
+    else
+        m_prefetcher.Activate(numThreads);
+}
+
 uint32 TerrainManager::GetAreaIdByAreaFlag(uint16 areaflag, uint32 map_id)
 {
     AreaTableEntry const* entry = GetAreaEntryByAreaFlagAndMap(areaflag, map_id);
@@ -22,6 +22,7 @@
 #include "Platform/Define.h"
 #include "Policies/Singleton.h"
 #include "GridDefines.h"
+#include "TerrainPrefetcher.h"
 
 #include <atomic>
 #include <mutex>
@@ -113,6 +114,8 @@ struct GridMapLiquidData
     float depth_level;
 };
 
+struct GridMapMapping;
+
 class GridMap
 {
     private:
@@ -151,10 +154,18 @@ class GridMap
         uint8* m_liquidFlags;
         float* m_liquid_map;
 
+        // read-only mapping of the .map file the data arrays point into, nullptr for heap copies
+        GridMapMapping* m_mapping;
+
         bool loadAreaData(FILE* in, uint32 offset, uint32 size);
         bool loadHeightData(FILE* in, uint32 offset, uint32 size);
         bool loadGridMapLiquidData(FILE* in, uint32 offset, uint32 size);
         bool loadHolesData(FILE* in, uint32 offset, uint32 size);
+        bool mapData(char const* filename, GridMapFileHeader const& header);
+        bool mapAreaData(uint8 const* base, size_t size, uint32 offset);
+        bool mapHeightData(uint8 const* base, size_t size, uint32 offset);
+        bool mapGridMapLiquidData(uint8 const* base, size_t size, uint32 offset);
+        bool mapHolesData(uint8 const* base, size_t size, uint32 offset);
         bool isHole(int row, int col) const;
 
         // Get height functions and pointers
@@ -244,6 +255,12 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<std::atomic_long>
         // THIS METHOD IS NOT THREAD-SAFE!!!! AND IT SHOULDN'T BE THREAD-SAFE!!!!
         void CleanUpGrids(const uint32 diff);
 
+        // x, y are grid indexes as used by Load/Unload
+        bool IsGridLoaded(const uint32 x, const uint32 y) const { return m_GridMaps[x][y] != nullptr; }
+        // read .map file of the grid without taking a reference, called from TerrainPrefetcher threads
+        // vmap and mmap tiles are loaded later by LoadMapAndVMap in the map update
+        void PrefetchGrid(const uint32 x, const uint32 y);
+
     protected:
         friend class Map;
         // load/unload terrain data
@@ -256,6 +273,7 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<std::atomic_long>
 
         GridMap* GetGrid(const float x, const float y);
         GridMap* LoadMapAndVMap(const uint32 x, const uint32 y);
+        GridMap* LoadGridMapFile(const uint32 x, const uint32 y) const;
 
         int RefGrid(const uint32& x, const uint32& y);
         int UnrefGrid(const uint32& x, const uint32& y);
@@ -264,6 +282,8 @@ class MANGOS_DLL_SPEC TerrainInfo : public Referencable<std::atomic_long>
 
         GridMap* m_GridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
         int16 m_GridRef[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
+        GridMap* m_PrefetchedGridMaps[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];   // read ahead, not taken by LoadMapAndVMap yet
+        bool m_GridPrefetched[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];   // prefetched since last clean up, keep it one more
 
         // global garbage collection timer
         ShortIntervalTimer i_timer;
@@ -287,6 +307,10 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
         void Update(const uint32 diff);
         void UnloadAll();
 
+        void SetPrefetchThreads(uint32 numThreads);
+        bool IsPrefetchActive() const { return m_prefetcher.IsActive(); }
+        void PrefetchGrid(TerrainInfo* terrain, uint32 x, uint32 y) { m_prefetcher.Prefetch(terrain, x, y); }
+
         uint16 GetAreaFlag(uint32 mapid, float x, float y, float z) const
         {
             TerrainInfo* pData = const_cast<TerrainManager*>(this)->LoadTerrain(mapid);
@@ -318,6 +342,7 @@ class TerrainManager : public MaNGOS::Singleton<TerrainManager, MaNGOS::ClassLev
 
         typedef MaNGOS::ClassLevelLockable<TerrainManager, std::mutex>::Lock Guard;
         TerrainDataMap i_TerrainMap;
+        TerrainPrefetcher m_prefetcher;
 };
 
 #define sTerrainMgr TerrainManager::Instance()
@@ -104,7 +104,7 @@ void MessageDeliverer::Visit(CameraMapType& m)
         if (i_toSelf || owner != &i_player)
         {
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                i_broadcaster.SendTo(session);
         }
     }
 }
@@ -119,7 +119,7 @@ void MessageDelivererExcept::Visit(CameraMapType& m)
             continue;
 
         if (WorldSession* session = owner->GetSession())
-            session->SendPacket(i_message);
+            i_broadcaster.SendTo(session);
     }
 }
 
@@ -128,7 +128,7 @@ void ObjectMessageDeliverer::Visit(CameraMapType& m)
     for (CameraMapType::iterator iter = m.begin(); iter != m.end(); ++iter)
     {
         if (WorldSession* session = iter->getSource()->GetOwner()->GetSession())
-            session->SendPacket(i_message);
+            i_broadcaster.SendTo(session);
     }
 }
 
@@ -143,7 +143,7 @@ void MessageDistDeliverer::Visit(CameraMapType& m)
                 (!i_dist || iter->getSource()->GetBody()->IsWithinDist(&i_player, i_dist)))
         {
             if (WorldSession* session = owner->GetSession())
-                session->SendPacket(i_message);
+                i_broadcaster.SendTo(session);
         }
     }
 }
@@ -155,7 +155,7 @@ void ObjectMessageDistDeliverer::Visit(CameraMapType& m)
         if (!i_dist || iter->getSource()->GetBody()->IsWithinDist(&i_object, i_dist))
         {
             if (WorldSession* session = iter->getSource()->GetOwner()->GetSession())
-                session->SendPacket(i_message);
+                i_broadcaster.SendTo(session);
         }
     }
 }
@@ -57,20 +57,20 @@ namespace MaNGOS
     struct MessageDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        PacketBroadcaster i_broadcaster;
         bool i_toSelf;
-        MessageDeliverer(Player const& pl, WorldPacket const& msg, bool to_self) : i_player(pl), i_message(msg), i_toSelf(to_self) {}
+        MessageDeliverer(Player const& pl, WorldPacket const& msg, bool to_self) : i_player(pl), i_broadcaster(msg), i_toSelf(to_self) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
 
     struct MessageDelivererExcept
     {
-        WorldPacket const&  i_message;
+        PacketBroadcaster i_broadcaster;
         Player const* i_skipped_receiver;
 
         MessageDelivererExcept(WorldPacket const& msg, Player const* skipped)
-            : i_message(msg), i_skipped_receiver(skipped) {}
+            : i_broadcaster(msg), i_skipped_receiver(skipped) {}
 
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
@@ -78,8 +78,8 @@ namespace MaNGOS
 
     struct ObjectMessageDeliverer
     {
-        WorldPacket const& i_message;
-        explicit ObjectMessageDeliverer(WorldPacket const& msg) : i_message(msg) {}
+        PacketBroadcaster i_broadcaster;
+        explicit ObjectMessageDeliverer(WorldPacket const& msg) : i_broadcaster(msg) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
@@ -87,13 +87,13 @@ namespace MaNGOS
     struct MessageDistDeliverer
     {
         Player const& i_player;
-        WorldPacket const& i_message;
+        PacketBroadcaster i_broadcaster;
         bool i_toSelf;
         bool i_ownTeamOnly;
         float i_dist;
 
         MessageDistDeliverer(Player const& pl, WorldPacket const& msg, float dist, bool to_self, bool ownTeamOnly)
-            : i_player(pl), i_message(msg), i_toSelf(to_self), i_ownTeamOnly(ownTeamOnly), i_dist(dist) {}
+            : i_player(pl), i_broadcaster(msg), i_toSelf(to_self), i_ownTeamOnly(ownTeamOnly), i_dist(dist) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
@@ -101,9 +101,9 @@ namespace MaNGOS
     struct ObjectMessageDistDeliverer
     {
         WorldObject const& i_object;
-        WorldPacket const& i_message;
+        PacketBroadcaster i_broadcaster;
         float i_dist;
-        ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket const& msg, float dist) : i_object(obj), i_message(msg), i_dist(dist) {}
+        ObjectMessageDistDeliverer(WorldObject const& obj, WorldPacket const& msg, float dist) : i_object(obj), i_broadcaster(msg), i_dist(dist) {}
         void Visit(CameraMapType& m);
         template<class SKIP> void Visit(GridRefManager<SKIP>&) {}
     };
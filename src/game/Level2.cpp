@@ -49,6 +49,7 @@
 #include "TargetedMovementGenerator.h"                      // for HandleNpcUnFollowCommand
 #include "MoveMap.h"                                        // for mmap manager
 #include "PathFinder.h"                                     // for mmap commands
+#include "PathCache.h"                                      // for mmap stats
 #include "movement/MoveSplineInit.h"
 
 #include <fstream>
@@ -4798,6 +4799,17 @@ bool ChatHandler::HandleMmapStatsCommand(char* /*args*/)
     PSendSysMessage(" %u triangles (%u vertices)", triCount, triVertCount);
     PSendSysMessage(" %.2f MB of data (not including pointers)", ((float)dataSize / sizeof(unsigned char)) / 1048576);
 
+    PathCache const* pathCache = m_session->GetPlayer()->GetMap()->GetPathCache();
+    PathCache::Stats stats = pathCache->GetStats();
+    PSendSysMessage("Path cache on current map (%s):", pathCache->IsEnabled() ? "enabled" : "disabled");
+    PSendSysMessage(" %u corridors cached", pathCache->GetCorridorCount());
+    PSendSysMessage(" " UI64FMTD " path searches, " UI64FMTD " hits (%.1f%%), " UI64FMTD " corridors stored",
+                    stats.lookups, stats.hits, stats.lookups ? stats.hits * 100.0f / stats.lookups : 0.0f, stats.stores);
+    PSendSysMessage(" " UI64FMTD " corridor ends moved with the target", stats.corridorMoves);
+
+    PathFinderPool const& pool = sMapMgr.GetPathFinderPool();
+    PSendSysMessage("Path search threads: %u, queued searches: %u", pool.GetThreadCount(), pool.GetQueueSize());
+
     return true;
 }
 
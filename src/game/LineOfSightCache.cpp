@@ -0,0 +1,73 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "LineOfSightCache.h"
+
+#include <algorithm>
+#include <cmath>
+
+LineOfSightCache::LineOfSightCache(bool enabled) : m_enabled(enabled)
+{
+}
+
+bool LineOfSightCache::Find(float x1, float y1, float z1, float x2, float y2, float z2, bool& result) const
+{
+    if (!m_enabled || m_results.empty())
+        return false;
+
+    ResultMap::const_iterator itr = m_results.find(MakeKey(x1, y1, z1, x2, y2, z2));
+    if (itr == m_results.end())
+        return false;
+
+    result = itr->second;
+    return true;
+}
+
+void LineOfSightCache::Store(float x1, float y1, float z1, float x2, float y2, float z2, bool result)
+{
+    if (!m_enabled)
+        return;
+
+    if (m_results.size() >= MaxResults)
+        m_results.clear();
+
+    m_results[MakeKey(x1, y1, z1, x2, y2, z2)] = result;
+}
+
+LineOfSightCache::RayKey LineOfSightCache::MakeKey(float x1, float y1, float z1, float x2, float y2, float z2)
+{
+    int32 start[3] = { int32(std::floor(x1 * 4.0f)), int32(std::floor(y1 * 4.0f)), int32(std::floor(z1 * 4.0f)) };
+    int32 end[3] = { int32(std::floor(x2 * 4.0f)), int32(std::floor(y2 * 4.0f)), int32(std::floor(z2 * 4.0f)) };
+
+    RayKey key;
+    bool swapped = std::lexicographical_compare(end, end + 3, start, start + 3);
+    std::copy(start, start + 3, key.coords + (swapped ? 3 : 0));
+    std::copy(end, end + 3, key.coords + (swapped ? 0 : 3));
+    return key;
+}
+
+size_t LineOfSightCache::RayKeyHash::operator()(RayKey const& key) const
+{
+    uint64 hash = 14695981039346656037ULL;                  // FNV-1a over the coordinates
+    for (int i = 0; i < 6; ++i)
+    {
+        hash ^= uint32(key.coords[i]);
+        hash *= 1099511628211ULL;
+    }
+    return size_t(hash);
+}
@@ -0,0 +1,80 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_LINEOFSIGHTCACHE_H
+#define MANGOS_LINEOFSIGHTCACHE_H
+
+#include "Common.h"
+
+#include <unordered_map>
+
+/**
+ * Line of sight results of one map instance, valid for the current map update only.
+ *
+ * An area spell tests every target against its caster and the caster again when the effect hits,
+ * creatures of a pack test the same target each, so the same rays are traced many times per tick.
+ * Endpoints are rounded to a quarter yard and ordered, line of sight does not depend on the
+ * direction of the ray (vmap triangles are two sided).
+ *
+ * The cache is cleared at the start of every map update and whenever a game object model is
+ * added, removed or changes its collision state. Only the map update thread uses it.
+ */
+class LineOfSightCache
+{
+    public:
+        explicit LineOfSightCache(bool enabled);
+
+        bool IsEnabled() const { return m_enabled; }
+
+        // returns true and fills result if the ray was traced since the last Clear
+        bool Find(float x1, float y1, float z1, float x2, float y2, float z2, bool& result) const;
+        void Store(float x1, float y1, float z1, float x2, float y2, float z2, bool result);
+
+        void Clear() { m_results.clear(); }
+
+    private:
+        struct RayKey
+        {
+            bool operator==(RayKey const& other) const
+            {
+                for (int i = 0; i < 6; ++i)
+                    if (coords[i] != other.coords[i])
+                        return false;
+                return true;
+            }
+
+            int32 coords[6];                                // quantized start and end point, smaller point first
+        };
+
+        struct RayKeyHash
+        {
+            size_t operator()(RayKey const& key) const;
+        };
+
+        typedef std::unordered_map<RayKey, bool, RayKeyHash> ResultMap;
+
+        // crowded maps trace a lot of distinct rays per tick, start over instead of growing without limit
+        static const uint32 MaxResults = 4096;
+
+        static RayKey MakeKey(float x1, float y1, float z1, float x2, float y2, float z2);
+
+        ResultMap m_results;
+        bool m_enabled;                                     // vmap.losCache at creation
+};
+
+#endif
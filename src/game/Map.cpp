@@ -36,12 +36,19 @@
 #include "MoveMap.h"
 #include "Chat.h"
 #include "Weather.h"
+#include "PathCache.h"
+#include "LineOfSightCache.h"
 #include "ObjectGridLoader.h"
 
+#include <memory>
+
 Map::~Map()
 {
     UnloadAll(true);
 
+    // path searches of this map use its path cache and terrain
+    sMapMgr.GetPathFinderPool().CancelRequests(this);
+
     if (!m_scriptSchedule.empty())
         sScriptMgr.DecreaseScheduledScriptCount(m_scriptSchedule.size());
 
@@ -60,6 +67,12 @@ Map::~Map()
 
     delete m_weatherSystem;
     m_weatherSystem = nullptr;
+
+    delete m_pathCache;
+    m_pathCache = nullptr;
+
+    delete m_losCache;
+    m_losCache = nullptr;
 }
 
 void Map::LoadMapAndVMap(int gx, int gy)
@@ -69,6 +82,47 @@ void Map::LoadMapAndVMap(int gx, int gy)
 
     if (m_TerrainData->Load(gx, gy))
         m_bLoadedGrids[gx][gy] = true;
+
+    // rays traced before through the not loaded vmap tile were cached as clear
+    m_losCache->Clear();
+}
+
+// queue terrain files of not loaded grids the visibility area will reach soon along the movement direction
+void Map::PrefetchGridsAhead(float oldX, float oldY, float x, float y)
+{
+    if (!sTerrainMgr.IsPrefetchActive())
+        return;
+
+    float dx = x - oldX;
+    float dy = y - oldY;
+    float dist = sqrt(dx * dx + dy * dy);
+    if (dist < 0.1f)
+        return;
+
+    dx /= dist;
+    dy /= dist;
+
+    float minDist = GetVisibilityDistance();
+    float maxDist = minDist + sWorld.getConfig(CONFIG_FLOAT_GRID_PREFETCH_DISTANCE);
+
+    // sample the movement ray and both edges of the visibility circle, half a grid apart so no grid is skipped
+    for (float ahead = minDist; ahead <= maxDist; ahead += SIZE_OF_GRIDS / 2)
+    {
+        for (int side = -1; side <= 1; ++side)
+        {
+            float px = x + dx * ahead - dy * minDist * side;
+            float py = y + dy * ahead + dx * minDist * side;
+            if (!MaNGOS::IsValidMapCoord(px, py))
+                continue;
+
+            GridPair p = MaNGOS::ComputeGridPair(px, py);
+            int gx = (MAX_NUMBER_OF_GRIDS - 1) - p.x_coord;
+            int gy = (MAX_NUMBER_OF_GRIDS - 1) - p.y_coord;
+
+            if (!m_bLoadedGrids[gx][gy])
+                sTerrainMgr.PrefetchGrid(m_TerrainData, gx, gy);
+        }
+    }
 }
 
 Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
@@ -102,6 +156,8 @@ Map::Map(uint32 id, time_t expiry, uint32 InstanceId)
     m_persistentState->SetUsedByMapState(this);
 
     m_weatherSystem = new WeatherSystem(this);
+    m_pathCache = new PathCache(sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_CACHE_TIME));
+    m_losCache = new LineOfSightCache(sWorld.getConfig(CONFIG_BOOL_VMAP_LOS_CACHE));
 }
 
 void Map::InitVisibilityDistance()
@@ -445,6 +501,7 @@ bool Map::loaded(const GridPair& p) const
 void Map::Update(const uint32& t_diff)
 {
     m_dyn_tree.update(t_diff);
+    m_losCache->Clear();
 
     /// update worldsessions for existing players
     for (m_mapRefIter = m_mapRefManager.begin(); m_mapRefIter != m_mapRefManager.end(); ++m_mapRefIter)
@@ -575,6 +632,7 @@ void Map::Update(const uint32& t_diff)
         i_data->Update(t_diff);
 
     m_weatherSystem->UpdateWeathers(t_diff);
+    m_pathCache->Update(t_diff);
 }
 
 void Map::Remove(Player* player, bool remove)
@@ -677,7 +735,10 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
 {
     MANGOS_ASSERT(player);
 
-    CellPair old_val = MaNGOS::ComputeCellPair(player->GetPositionX(), player->GetPositionY());
+    float old_x = player->GetPositionX();
+    float old_y = player->GetPositionY();
+
+    CellPair old_val = MaNGOS::ComputeCellPair(old_x, old_y);
     CellPair new_val = MaNGOS::ComputeCellPair(x, y);
 
     Cell old_cell(old_val);
@@ -688,6 +749,8 @@ Map::PlayerRelocation(Player* player, float x, float y, float z, float orientati
 
     if (old_cell.DiffGrid(new_cell) || old_cell.DiffCell(new_cell))
     {
+        PrefetchGridsAhead(old_x, old_y, x, y);
+
         DEBUG_FILTER_LOG(LOG_FILTER_PLAYER_MOVES, "Player %s relocation grid[%u,%u]cell[%u,%u]->grid[%u,%u]cell[%u,%u]", player->GetName(), old_cell.GridX(), old_cell.GridY(), old_cell.CellX(), old_cell.CellY(), new_cell.GridX(), new_cell.GridY(), new_cell.CellX(), new_cell.CellY());
 
         NGridType* oldGrid = getNGrid(old_cell.GridX(), old_cell.GridY());
@@ -1977,8 +2040,47 @@ void Map::PlayDirectSoundToMap(uint32 soundId, uint32 zoneId /*=0*/) const
  */
 bool Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float destX, float destY, float destZ) const
 {
-    return VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
-           && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+    bool result;
+    if (m_losCache->Find(srcX, srcY, srcZ, destX, destY, destZ, result))
+        return result;
+
+    result = VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, destX, destY, destZ)
+             && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, destX, destY, destZ);
+
+    m_losCache->Store(srcX, srcY, srcZ, destX, destY, destZ, result);
+    return result;
+}
+
+/**
+ * Function to check line of sight from one point to several points, results already in the cache are reused
+ */
+void Map::IsInLineOfSight(float srcX, float srcY, float srcZ, float const* dests, uint32 count, bool* results) const
+{
+    std::vector<float> missedDests;
+    std::vector<uint32> missedIndexes;
+    for (uint32 i = 0; i < count; ++i)
+    {
+        if (m_losCache->Find(srcX, srcY, srcZ, dests[i * 3], dests[i * 3 + 1], dests[i * 3 + 2], results[i]))
+            continue;
+
+        missedDests.insert(missedDests.end(), dests + i * 3, dests + i * 3 + 3);
+        missedIndexes.push_back(i);
+    }
+
+    if (missedIndexes.empty())
+        return;
+
+    std::unique_ptr<bool[]> staticResults(new bool[missedIndexes.size()]);
+    VMAP::VMapFactory::createOrGetVMapManager()->isInLineOfSight(GetId(), srcX, srcY, srcZ, &missedDests[0], missedIndexes.size(), staticResults.get());
+
+    for (uint32 i = 0; i < missedIndexes.size(); ++i)
+    {
+        float const* dest = &missedDests[i * 3];
+        bool result = staticResults[i] && m_dyn_tree.isInLineOfSight(srcX, srcY, srcZ, dest[0], dest[1], dest[2]);
+
+        m_losCache->Store(srcX, srcY, srcZ, dest[0], dest[1], dest[2], result);
+        results[missedIndexes[i]] = result;
+    }
 }
 
 /**
@@ -2076,11 +2178,13 @@ float Map::GetHeight(float x, float y, float z) const
 void Map::InsertGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.insert(mdl);
+    m_losCache->Clear();
 }
 
 void Map::RemoveGameObjectModel(const GameObjectModel& mdl)
 {
     m_dyn_tree.remove(mdl);
+    m_losCache->Clear();
 }
 
 bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
@@ -2088,6 +2192,11 @@ bool Map::ContainsGameObjectModel(const GameObjectModel& mdl) const
     return m_dyn_tree.contains(mdl);
 }
 
+void Map::InvalidateLineOfSightCache()
+{
+    m_losCache->Clear();
+}
+
 // This will generate a random point to all directions in water for the provided point in radius range.
 bool Map::GetRandomPointUnderWater(float& x, float& y, float& z, float radius, GridMapLiquidData& liquid_status) const
 {
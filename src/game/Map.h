@@ -52,6 +52,8 @@ class BattleGround;
 class GridMap;
 class GameObjectModel;
 class WeatherSystem;
+class PathCache;
+class LineOfSightCache;
 
 // GCC have alternative #pragma pack(N) syntax and old gcc version not support pack(push,N), also any gcc version not support it at some platform
 #if defined( __GNUC__ )
@@ -185,9 +187,22 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         void UpdateObjectVisibility(WorldObject* obj, Cell cell, CellPair cellpair);
 
-        void resetMarkedCells() { marked_cells.reset(); }
+        void resetMarkedCells()
+        {
+            // only the cells marked in this update, instead of the whole bitset
+            for (std::vector<uint32>::const_iterator itr = marked_cell_ids.begin(); itr != marked_cell_ids.end(); ++itr)
+                marked_cells.reset(*itr);
+            marked_cell_ids.clear();
+        }
         bool isCellMarked(uint32 pCellId) const { return marked_cells.test(pCellId); }
-        void markCell(uint32 pCellId) { marked_cells.set(pCellId); }
+        void markCell(uint32 pCellId)
+        {
+            if (marked_cells.test(pCellId))
+                return;
+
+            marked_cells.set(pCellId);
+            marked_cell_ids.push_back(pCellId);
+        }
 
         bool HavePlayers() const { return !m_mapRefManager.isEmpty(); }
         uint32 GetPlayersCountExceptGMs() const;
@@ -258,12 +273,16 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         float GetHeight(float x, float y, float z) const;
         bool GetHeightInRange(float x, float y, float& z, float maxSearchDist = 4.0f) const;
         bool IsInLineOfSight(float x1, float y1, float z1, float x2, float y2, float z2) const;
+        // line of sight from one point to count points (x,y,z triples in dests), traces the static tree once for all rays
+        void IsInLineOfSight(float x1, float y1, float z1, float const* dests, uint32 count, bool* results) const;
         bool GetHitPosition(float srcX, float srcY, float srcZ, float& destX, float& destY, float& destZ, float modifyDist) const;
 
         // Object Model insertion/remove/test for dynamic vmaps use
         void InsertGameObjectModel(const GameObjectModel& mdl);
         void RemoveGameObjectModel(const GameObjectModel& mdl);
         bool ContainsGameObjectModel(const GameObjectModel& mdl) const;
+        // a game object model changed its collision state, see LineOfSightCache
+        void InvalidateLineOfSightCache();
 
         // Get Holder for Creature Linking
         CreatureLinkingHolder* GetCreatureLinkingHolder() { return &m_creatureLinkingHolder; }
@@ -281,6 +300,11 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
          */
         void SetWeather(uint32 zoneId, WeatherType type, float grade, bool permanently);
 
+        // recently found paths of creatures on this map, see PathFinder
+        PathCache* GetPathCache() const { return m_pathCache; }
+        // line of sight results of the current update, see IsInLineOfSight
+        LineOfSightCache* GetLineOfSightCache() const { return m_losCache; }
+
         // Random on map generation
         bool GetReachableRandomPosition(Unit* unit, float& x, float& y, float& z, float radius) const;
         bool GetReachableRandomPointOnGround(float& x, float& y, float& z, float radius) const;
@@ -289,6 +313,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
     private:
         void LoadMapAndVMap(int gx, int gy);
+        void PrefetchGridsAhead(float oldX, float oldY, float x, float y);
 
         void SetTimer(uint32 t) { i_gridExpiry = t < MIN_GRID_DELAY ? MIN_GRID_DELAY : t; }
 
@@ -348,6 +373,7 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
         bool m_bLoadedGrids[MAX_NUMBER_OF_GRIDS][MAX_NUMBER_OF_GRIDS];
 
         std::bitset<TOTAL_NUMBER_OF_CELLS_PER_MAP* TOTAL_NUMBER_OF_CELLS_PER_MAP> marked_cells;
+        std::vector<uint32> marked_cell_ids;                // set bits of marked_cells, capacity kept between updates
 
         std::set<WorldObject*> i_objectsToRemove;
 
@@ -377,6 +403,9 @@ class MANGOS_DLL_SPEC Map : public GridRefManager<NGridType>
 
         // WeatherSystem
         WeatherSystem* m_weatherSystem;
+
+        PathCache* m_pathCache;
+        LineOfSightCache* m_losCache;
 };
 
 class MANGOS_DLL_SPEC WorldMap : public Map
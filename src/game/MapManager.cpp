@@ -39,6 +39,9 @@ MapManager::MapManager()
 
 MapManager::~MapManager()
 {
+    i_updater.Deactivate();
+    i_pathFinderPool.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         delete iter->second;
 
@@ -53,6 +56,24 @@ MapManager::Initialize()
 {
     InitStateMachine();
     InitMaxInstanceId();
+    SetMapUpdateThreads(sWorld.getConfig(CONFIG_UINT32_MAPUPDATE_THREADS));
+    SetPathFinderThreads(sWorld.getConfig(CONFIG_UINT32_MMAP_PATH_THREADS));
+}
+
+void MapManager::SetMapUpdateThreads(uint32 numThreads)
+{
+    if (numThreads == 0)
+        i_updater.Deactivate();
+    else
+        i_updater.Activate(numThreads);
+}
+
+void MapManager::SetPathFinderThreads(uint32 numThreads)
+{
+    if (numThreads == 0)
+        i_pathFinderPool.Deactivate();
+    else
+        i_pathFinderPool.Activate(numThreads);
 }
 
 void MapManager::InitStateMachine()
@@ -172,8 +193,35 @@ void MapManager::Update(uint32 diff)
     if (!i_timer.Passed())
         return;
 
-    for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
-        iter->second->Update((uint32)i_timer.GetCurrent());
+    if (i_updater.IsActive())
+    {
+        // i_maps is ordered by map id, so all instances of a map id are adjacent and can be
+        // handed over as one job, they share terrain, vmap and mmap data
+        {
+            Guard _guard(*this);
+
+            std::vector<Map*> sameMapId;
+            for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            {
+                if (!sameMapId.empty() && sameMapId.front()->GetId() != iter->first.nMapId)
+                {
+                    i_updater.ScheduleUpdate(std::move(sameMapId), (uint32)i_timer.GetCurrent());
+                    sameMapId.clear();
+                }
+                sameMapId.push_back(iter->second);
+            }
+
+            if (!sameMapId.empty())
+                i_updater.ScheduleUpdate(std::move(sameMapId), (uint32)i_timer.GetCurrent());
+        }
+
+        i_updater.Wait();
+    }
+    else
+    {
+        for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
+            iter->second->Update((uint32)i_timer.GetCurrent());
+    }
 
     for (TransportSet::iterator iter = m_Transports.begin(); iter != m_Transports.end(); ++iter)
     {
@@ -226,6 +274,8 @@ bool MapManager::IsValidMAP(uint32 mapid)
 
 void MapManager::UnloadAll()
 {
+    i_pathFinderPool.Deactivate();
+
     for (MapMapType::iterator iter = i_maps.begin(); iter != i_maps.end(); ++iter)
         iter->second->UnloadAll(true);
 
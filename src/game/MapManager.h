@@ -24,6 +24,8 @@
 #include "Policies/Singleton.h"
 #include "Map.h"
 #include "GridStates.h"
+#include "MapUpdater.h"
+#include "PathFinderPool.h"
 
 class Transport;
 class BattleGround;
@@ -70,6 +72,12 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         void Initialize(void);
         void Update(uint32);
 
+        // (re)start the map update worker pool, 0 threads updates all maps in the world thread
+        void SetMapUpdateThreads(uint32 numThreads);
+        // (re)start the path search worker pool, 0 threads searches paths in the map update
+        void SetPathFinderThreads(uint32 numThreads);
+        PathFinderPool& GetPathFinderPool() { return i_pathFinderPool; }
+
         void SetGridCleanUpDelay(uint32 t)
         {
             if (t < MIN_GRID_DELAY)
@@ -176,6 +184,8 @@ class MapManager : public MaNGOS::Singleton<MapManager, MaNGOS::ClassLevelLockab
         uint32 i_gridCleanUpDelay;
         MapMapType i_maps;
         IntervalTimer i_timer;
+        MapUpdater i_updater;
+        PathFinderPool i_pathFinderPool;
 
         uint32 i_MaxInstanceId;
 };
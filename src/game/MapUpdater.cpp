@@ -0,0 +1,95 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "MapUpdater.h"
+#include "Map.h"
+#include "Log.h"
+#include "Database/DatabaseEnv.h"
+
+void MapUpdater::Activate(uint32 numThreads)
+{
+    Deactivate();
+
+    m_cancel = false;
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workers.push_back(std::thread(&MapUpdater::WorkerThread, this));
+
+    sLog.outString("MapUpdater: started %u map update threads", numThreads);
+}
+
+void MapUpdater::Deactivate()
+{
+    if (m_workers.empty())
+        return;
+
+    Wait();
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_cancel = true;
+    }
+    m_queueCondition.notify_all();
+
+    for (std::vector<std::thread>::iterator itr = m_workers.begin(); itr != m_workers.end(); ++itr)
+        itr->join();
+
+    m_workers.clear();
+}
+
+void MapUpdater::ScheduleUpdate(std::vector<Map*>&& maps, uint32 diff)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_queue.push(UpdateRequest(std::move(maps), diff));
+        ++m_pending;
+    }
+    m_queueCondition.notify_one();
+}
+
+void MapUpdater::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCondition.wait(lock, [this] { return m_pending == 0; });
+}
+
+void MapUpdater::WorkerThread()
+{
+    WorldDatabase.ThreadStart();                            // let thread do safe mySQL requests (one connection call enough)
+
+    for (;;)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queueCondition.wait(lock, [this] { return m_cancel || !m_queue.empty(); });
+
+        if (m_queue.empty())                                // only possible on cancel
+            break;
+
+        UpdateRequest request = std::move(m_queue.front());
+        m_queue.pop();
+        lock.unlock();
+
+        for (std::vector<Map*>::const_iterator itr = request.maps.begin(); itr != request.maps.end(); ++itr)
+            (*itr)->Update(request.diff);
+
+        lock.lock();
+        if (--m_pending == 0)
+            m_doneCondition.notify_all();
+    }
+
+    WorldDatabase.ThreadEnd();                              // free mySQL thread resources
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_MAPUPDATER_H
+#define MANGOS_MAPUPDATER_H
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+class Map;
+
+/**
+ * Worker pool running Map::Update for independent maps in parallel.
+ *
+ * MapManager::Update hands over one job per map id (all instances of that map id are updated
+ * one after another inside the same job) and joins the pool with Wait() before transports are
+ * updated and before World::Update calls RemoveAllObjectsInRemoveList.
+ *
+ * Rules for code running inside Map::Update while the pool is active:
+ *  - terrain, vmap and mmap data is shared between all instances of a map id, which is why
+ *    those are always grouped into the same job; never touch another map id's grids.
+ *  - far teleports only remove the player from its current map. Adding it to the new map is
+ *    done by MSG_MOVE_WORLDPORT_ACK, which is PROCESS_THREADUNSAFE and therefore runs in the
+ *    serial World::UpdateSessions phase.
+ *  - objects returned by ObjectAccessor may live on another map. They may be used to send
+ *    packets (group/guild/channel broadcasts go through the locked socket buffers), but must
+ *    not be modified; handlers doing so have to be PROCESS_THREADUNSAFE.
+ *  - group, guild, mail, auction and chat opcodes are PROCESS_THREADUNSAFE and are never
+ *    executed from a map worker.
+ */
+class MapUpdater
+{
+    public:
+        MapUpdater() : m_pending(0), m_cancel(false) {}
+        ~MapUpdater() { Deactivate(); }
+
+        void Activate(uint32 numThreads);
+        void Deactivate();
+        bool IsActive() const { return !m_workers.empty(); }
+
+        // queue the given maps to be updated one after another by the same worker
+        void ScheduleUpdate(std::vector<Map*>&& maps, uint32 diff);
+        // block until all scheduled jobs are finished
+        void Wait();
+
+    private:
+        MapUpdater(MapUpdater const&);
+        MapUpdater& operator=(MapUpdater const&);
+
+        struct UpdateRequest
+        {
+            UpdateRequest(std::vector<Map*>&& maps, uint32 diff) : maps(std::move(maps)), diff(diff) {}
+
+            std::vector<Map*> maps;
+            uint32 diff;
+        };
+
+        void WorkerThread();
+
+        std::vector<std::thread> m_workers;
+        std::queue<UpdateRequest> m_queue;
+
+        std::mutex m_mutex;
+        std::condition_variable m_queueCondition;           // signaled when a request is queued or on cancel
+        std::condition_variable m_doneCondition;            // signaled when m_pending drops to zero
+
+        uint32 m_pending;
+        bool m_cancel;
+};
+
+#endif
@@ -38,6 +38,7 @@
 #include "OutdoorPvP/OutdoorPvP.h"
 #include "Pet.h"
 #include "SocialMgr.h"
+#include "WhoListIndex.h"
 
 void WorldSession::HandleRepopRequestOpcode(WorldPacket& recv_data)
 {
@@ -116,6 +117,18 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
         DEBUG_LOG("String %u: %s", i, temp.c_str());
     }
 
+    // addons may send /who in a loop, the query visits every player of the level range
+    if (uint32 minDelay = sWorld.getConfig(CONFIG_UINT32_WHO_LIST_MIN_QUERY_DELAY))
+    {
+        uint32 now = WorldTimer::getMSTime();
+        if (m_whoQueryTime && WorldTimer::getMSTimeDiff(m_whoQueryTime, now) < minDelay)
+        {
+            DEBUG_LOG("WORLD: CMSG_WHO from account %u ignored, sent too often", GetAccountId());
+            return;
+        }
+        m_whoQueryTime = now;
+    }
+
     std::wstring wplayer_name;
     std::wstring wguild_name;
     if (!(Utf8toWStr(player_name, wplayer_name) && Utf8toWStr(guild_name, wguild_name)))
@@ -131,7 +144,14 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
     Team team = _player->GetTeam();
     AccountTypes security = GetSecurity();
     bool allowTwoSideWhoList = sWorld.getConfig(CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST);
-    AccountTypes gmLevelInWhoList = (AccountTypes)sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST);
+    uint32 gmLevelInWhoList = sWorld.getConfig(CONFIG_UINT32_GM_LEVEL_IN_WHO_LIST);
+    ObjectGuid viewerGuid = _player->GetObjectGuid();
+
+    // zone filter only passes the players of the listed zones, each zone visited once
+    std::vector<uint32> zones;
+    for (uint32 i = 0; i < zones_count; ++i)
+        if (std::find(zones.begin(), zones.end(), zoneids[i]) == zones.end())
+            zones.push_back(zoneids[i]);
 
     uint32 matchcount = 0;
     uint32 displaycount = 0;
@@ -140,115 +160,83 @@ void WorldSession::HandleWhoOpcode(WorldPacket& recv_data)
     data << uint32(matchcount);                             // placeholder, count of players matching criteria
     data << uint32(displaycount);                           // placeholder, count of players displayed
 
-    // TODO: Guard Player map
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::const_iterator itr = m.begin(); itr != m.end(); ++itr)
-    {
-        Player* pl = itr->second;
-
-        if (security == SEC_PLAYER)
-        {
-            // player can see member of other team only if CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST
-            if (pl->GetTeam() != team && !allowTwoSideWhoList)
-                continue;
-
-            // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
-            if (pl->GetSession()->GetSecurity() > gmLevelInWhoList)
-                continue;
-        }
-
-        // do not process players which are not in world
-        if (!pl->IsInWorld())
-            continue;
-
-        // check if target is globally visible for player
-        if (!pl->IsVisibleGloballyFor(_player))
-            continue;
-
-        // check if target's level is in level range
-        uint32 lvl = pl->getLevel();
-        if (lvl < level_min || lvl > level_max)
-            continue;
-
-        // check if class matches classmask
-        uint32 class_ = pl->getClass();
-        if (!(classmask & (1 << class_)))
-            continue;
-
-        // check if race matches racemask
-        uint32 race = pl->getRace();
-        if (!(racemask & (1 << race)))
-            continue;
+    sWhoListIndex.Update();
 
-        uint32 pzoneid = pl->GetZoneId();
+    auto checkPlayer = [&](WhoListIndex::PlayerInfo const& info)
+    {
+        // player can see MODERATOR, GAME MASTER, ADMINISTRATOR only if CONFIG_GM_IN_WHO_LIST
+        if (security == SEC_PLAYER && info.security > gmLevelInWhoList)
+            return;
 
-        bool z_show = true;
-        for (uint32 i = 0; i < zones_count; ++i)
+        // check if target is globally visible for player, same as Player::IsVisibleGloballyFor
+        if (info.guid != viewerGuid && info.visibility != VISIBILITY_ON)
         {
-            if (zoneids[i] == pzoneid)
+            if (security > SEC_PLAYER)
             {
-                z_show = true;
-                break;
+                if (info.security > uint32(security))
+                    return;
             }
-
-            z_show = false;
+            else if (info.visibility == VISIBILITY_OFF)
+                return;
         }
-        if (!z_show)
-            continue;
-
-        std::string pname = pl->GetName();
-        std::wstring wpname;
-        if (!Utf8toWStr(pname, wpname))
-            continue;
-        wstrToLower(wpname);
 
-        if (!(wplayer_name.empty() || wpname.find(wplayer_name) != std::wstring::npos))
-            continue;
+        // check if class matches classmask
+        if (!(classmask & (1 << info.class_)))
+            return;
 
-        std::string gname = sGuildMgr.GetGuildNameById(pl->GetGuildId());
-        std::wstring wgname;
-        if (!Utf8toWStr(gname, wgname))
-            continue;
-        wstrToLower(wgname);
+        // check if race matches racemask
+        if (!(racemask & (1 << info.race)))
+            return;
 
-        if (!(wguild_name.empty() || wgname.find(wguild_name) != std::wstring::npos))
-            continue;
+        if (!(wplayer_name.empty() || info.wideName.find(wplayer_name) != std::wstring::npos))
+            return;
 
-        std::string aname;
-        if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(pzoneid))
-            aname = areaEntry->area_name[GetSessionDbcLocale()];
+        if (!(wguild_name.empty() || info.wideGuildName.find(wguild_name) != std::wstring::npos))
+            return;
 
-        bool s_show = true;
-        for (uint32 i = 0; i < str_count; ++i)
+        if (str_count)
         {
-            if (!str[i].empty())
+            std::string aname;
+            if (AreaTableEntry const* areaEntry = GetAreaEntryByAreaID(info.zoneId))
+                aname = areaEntry->area_name[GetSessionDbcLocale()];
+
+            bool s_show = true;
+            for (uint32 i = 0; i < str_count; ++i)
             {
-                if (wgname.find(str[i]) != std::wstring::npos ||
-                        wpname.find(str[i]) != std::wstring::npos ||
-                        Utf8FitTo(aname, str[i]))
+                if (!str[i].empty())
                 {
-                    s_show = true;
-                    break;
+                    if (info.wideGuildName.find(str[i]) != std::wstring::npos ||
+                            info.wideName.find(str[i]) != std::wstring::npos ||
+                            Utf8FitTo(aname, str[i]))
+                    {
+                        s_show = true;
+                        break;
+                    }
+                    s_show = false;
                 }
-                s_show = false;
             }
+            if (!s_show)
+                return;
         }
-        if (!s_show)
-            continue;
 
         // 49 is maximum player count sent to client
         if (++matchcount > 49)
-            continue;
+            return;
 
         ++displaycount;
 
-        data << pname;                                      // player name
-        data << gname;                                      // guild name
-        data << uint32(lvl);                                // player level
-        data << uint32(class_);                             // player class
-        data << uint32(race);                               // player race
-        data << uint32(pzoneid);                            // player zone id
-    }
+        data << info.name;                                  // player name
+        data << info.guildName;                             // guild name
+        data << uint32(info.level);                         // player level
+        data << uint32(info.class_);                        // player class
+        data << uint32(info.race);                          // player race
+        data << uint32(info.zoneId);                        // player zone id
+    };
+
+    // player can see member of other team only if CONFIG_BOOL_ALLOW_TWO_SIDE_WHO_LIST
+    sWhoListIndex.VisitCandidates(team, level_min, level_max, zones, checkPlayer);
+    if (security > SEC_PLAYER || allowTwoSideWhoList)
+        sWhoListIndex.VisitCandidates(team == ALLIANCE ? HORDE : ALLIANCE, level_min, level_max, zones, checkPlayer);
 
     if (sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS) && matchcount > sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS))
         matchcount = sWorld.getConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS);
@@ -134,7 +134,7 @@ namespace MMAP
     bool MMapManager::loadMapData(uint32 mapId)
     {
         // we already have this map loaded?
-        if (loadedMMaps.find(mapId) != loadedMMaps.end())
+        if (getMMapData(mapId))
             return true;
 
         // load and init dtNavMesh - read parameters from file
@@ -174,10 +174,18 @@ namespace MMAP
         MMapData* mmap_data = new MMapData(mesh);
         mmap_data->mmapLoadedTiles.clear();
 
+        std::lock_guard<std::mutex> guard(loadedMMapsLock);
         loadedMMaps.insert(std::pair<uint32, MMapData*>(mapId, mmap_data));
         return true;
     }
 
+    MMapData* MMapManager::getMMapData(uint32 mapId) const
+    {
+        std::lock_guard<std::mutex> guard(loadedMMapsLock);
+        MMapDataSet::const_iterator itr = loadedMMaps.find(mapId);
+        return itr != loadedMMaps.end() ? itr->second : nullptr;
+    }
+
     uint32 MMapManager::packTileID(int32 x, int32 y) const
     {
         return uint32(x << 16 | y);
@@ -190,7 +198,7 @@ namespace MMAP
             return false;
 
         // get this mmap data
-        MMapData* mmap = loadedMMaps[mapId];
+        MMapData* mmap = getMMapData(mapId);
         MANGOS_ASSERT(mmap->navMesh);
 
         // check if we already have this tile loaded
@@ -251,7 +259,11 @@ namespace MMAP
         dtTileRef tileRef = 0;
 
         // memory allocated for data is now managed by detour, and will be deallocated when the tile is removed
-        dtStatus dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        dtStatus dtResult;
+        {
+            boost::unique_lock<boost::shared_mutex> guard(mmap->navMeshLock);
+            dtResult = mmap->navMesh->addTile(data, fileHeader.size, DT_TILE_FREE_DATA, 0, &tileRef);
+        }
         if (dtStatusFailed(dtResult))
         {
             sLog.outError("MMAP:loadMap: Could not load %03u%02i%02i.mmtile into navmesh", mapId, x, y);
@@ -268,15 +280,14 @@ namespace MMAP
     bool MMapManager::unloadMap(uint32 mapId, int32 x, int32 y)
     {
         // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = getMMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map. %03u%02i%02i.mmtile", mapId, x, y);
             return false;
         }
 
-        MMapData* mmap = loadedMMaps[mapId];
-
         // check if we have this tile loaded
         uint32 packedGridPos = packTileID(x, y);
         if (mmap->mmapLoadedTiles.find(packedGridPos) == mmap->mmapLoadedTiles.end())
@@ -289,7 +300,11 @@ namespace MMAP
         dtTileRef tileRef = mmap->mmapLoadedTiles[packedGridPos];
 
         // unload, and mark as non loaded
-        dtStatus dtResult = mmap->navMesh->removeTile(tileRef, nullptr, nullptr);
+        dtStatus dtResult;
+        {
+            boost::unique_lock<boost::shared_mutex> guard(mmap->navMeshLock);
+            dtResult = mmap->navMesh->removeTile(tileRef, nullptr, nullptr);
+        }
         if (dtStatusFailed(dtResult))
         {
             // this is technically a memory leak
@@ -311,7 +326,8 @@ namespace MMAP
 
     bool MMapManager::unloadMap(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = getMMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Asked to unload not loaded navmesh map %03u", mapId);
@@ -319,7 +335,6 @@ namespace MMAP
         }
 
         // unload all tiles from given map
-        MMapData* mmap = loadedMMaps[mapId];
         for (MMapTileSet::iterator i = mmap->mmapLoadedTiles.begin(); i != mmap->mmapLoadedTiles.end(); ++i)
         {
             uint32 x = (i->first >> 16);
@@ -334,8 +349,11 @@ namespace MMAP
             }
         }
 
+        {
+            std::lock_guard<std::mutex> guard(loadedMMapsLock);
+            loadedMMaps.erase(mapId);
+        }
         delete mmap;
-        loadedMMaps.erase(mapId);
         DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMap: Unloaded %03i.mmap", mapId);
 
         return true;
@@ -344,14 +362,13 @@ namespace MMAP
     bool MMapManager::unloadMapInstance(uint32 mapId, uint32 instanceId)
     {
         // check if we have this map loaded
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = getMMapData(mapId);
+        if (!mmap)
         {
             // file may not exist, therefore not loaded
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded navmesh map %03u", mapId);
             return false;
         }
-
-        MMapData* mmap = loadedMMaps[mapId];
         if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
         {
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:unloadMapInstance: Asked to unload not loaded dtNavMeshQuery mapId %03u instanceId %u", mapId, instanceId);
@@ -369,18 +386,16 @@ namespace MMAP
 
     dtNavMesh const* MMapManager::GetNavMesh(uint32 mapId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
-            return nullptr;
-
-        return loadedMMaps[mapId]->navMesh;
+        MMapData* mmap = getMMapData(mapId);
+        return mmap ? mmap->navMesh : nullptr;
     }
 
     dtNavMeshQuery const* MMapManager::GetNavMeshQuery(uint32 mapId, uint32 instanceId)
     {
-        if (loadedMMaps.find(mapId) == loadedMMaps.end())
+        MMapData* mmap = getMMapData(mapId);
+        if (!mmap)
             return nullptr;
 
-        MMapData* mmap = loadedMMaps[mapId];
         if (mmap->navMeshQueries.find(instanceId) == mmap->navMeshQueries.end())
         {
             // allocate mesh query
@@ -400,4 +415,36 @@ namespace MMAP
 
         return mmap->navMeshQueries[instanceId];
     }
+
+    dtNavMeshQuery const* MMapManager::GetWorkerNavMeshQuery(uint32 mapId, uint32 workerId)
+    {
+        MMapData* mmap = getMMapData(mapId);
+        if (!mmap)
+            return nullptr;
+
+        std::lock_guard<std::mutex> guard(mmap->workerQueriesLock);
+        NavMeshQuerySet::const_iterator itr = mmap->workerQueries.find(workerId);
+        if (itr != mmap->workerQueries.end())
+            return itr->second;
+
+        dtNavMeshQuery* query = dtAllocNavMeshQuery();
+        MANGOS_ASSERT(query);
+        dtStatus dtResult = query->init(mmap->navMesh, 1024);
+        if (dtStatusFailed(dtResult))
+        {
+            dtFreeNavMeshQuery(query);
+            sLog.outError("MMAP:GetWorkerNavMeshQuery: Failed to initialize dtNavMeshQuery for mapId %03u worker %u", mapId, workerId);
+            return nullptr;
+        }
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "MMAP:GetWorkerNavMeshQuery: created dtNavMeshQuery for mapId %03u worker %u", mapId, workerId);
+        mmap->workerQueries.insert(std::pair<uint32, dtNavMeshQuery*>(workerId, query));
+        return query;
+    }
+
+    boost::shared_mutex* MMapManager::GetNavMeshLock(uint32 mapId)
+    {
+        MMapData* mmap = getMMapData(mapId);
+        return mmap ? &mmap->navMeshLock : nullptr;
+    }
 }
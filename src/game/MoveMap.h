@@ -20,6 +20,9 @@
 #define _MOVE_MAP_H
 
 #include "Common.h"
+#include <atomic>
+#include <mutex>
+#include <boost/thread/shared_mutex.hpp>
 #include "../../dep/recastnavigation/Detour/Include/DetourAlloc.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMesh.h"
 #include "../../dep/recastnavigation/Detour/Include/DetourNavMeshQuery.h"
@@ -52,6 +55,9 @@ namespace MMAP
             for (NavMeshQuerySet::iterator i = navMeshQueries.begin(); i != navMeshQueries.end(); ++i)
                 dtFreeNavMeshQuery(i->second);
 
+            for (NavMeshQuerySet::iterator i = workerQueries.begin(); i != workerQueries.end(); ++i)
+                dtFreeNavMeshQuery(i->second);
+
             if (navMesh)
                 dtFreeNavMesh(navMesh);
         }
@@ -61,6 +67,11 @@ namespace MMAP
         // we have to use single dtNavMeshQuery for every instance, since those are not thread safe
         NavMeshQuerySet navMeshQueries;     // instanceId to query
         MMapTileSet mmapLoadedTiles;        // maps [map grid coords] to [dtTile]
+
+        // PathFinderPool threads search on the navmesh while grids of the map are loaded or unloaded
+        boost::shared_mutex navMeshLock;    // exclusive while adding/removing tiles, shared while searching
+        NavMeshQuerySet workerQueries;      // PathFinderPool worker id to query
+        std::mutex workerQueriesLock;
     };
 
 
@@ -68,6 +79,7 @@ namespace MMAP
 
     // singelton class
     // holds all all access to mmap loading unloading and meshes
+    // MMapData of a map id is only used by the thread updating that map id, loadedMMaps itself is shared
     class MMapManager
     {
         public:
@@ -81,16 +93,26 @@ namespace MMAP
 
             // the returned [dtNavMeshQuery const*] is NOT threadsafe
             dtNavMeshQuery const* GetNavMeshQuery(uint32 mapId, uint32 instanceId);
+            // query owned by the given PathFinderPool worker, shared by all instances of the map
+            dtNavMeshQuery const* GetWorkerNavMeshQuery(uint32 mapId, uint32 workerId);
             dtNavMesh const* GetNavMesh(uint32 mapId);
+            // hold shared while using the navmesh outside of the thread updating the map
+            boost::shared_mutex* GetNavMeshLock(uint32 mapId);
 
             uint32 getLoadedTilesCount() const { return loadedTiles; }
-            uint32 getLoadedMapsCount() const { return loadedMMaps.size(); }
+            uint32 getLoadedMapsCount() const
+            {
+                std::lock_guard<std::mutex> guard(loadedMMapsLock);
+                return loadedMMaps.size();
+            }
         private:
             bool loadMapData(uint32 mapId);
+            MMapData* getMMapData(uint32 mapId) const;
             uint32 packTileID(int32 x, int32 y) const;
 
             MMapDataSet loadedMMaps;
-            uint32 loadedTiles;
+            mutable std::mutex loadedMMapsLock;
+            std::atomic<uint32> loadedTiles;
     };
 
     // static class
@@ -201,6 +201,67 @@ void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) c
     data->AddUpdateBlock(buf);
 }
 
+std::atomic<uint64> ValuesUpdateBlockCache::s_hits(0);
+std::atomic<uint64> ValuesUpdateBlockCache::s_misses(0);
+
+void Object::BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateBlockCache& cache) const
+{
+    // other players only see the visible part of a player's fields, so players need a second block
+    ValuesUpdateBlockCache::Entry& entry = cache.entries[GetTypeId() == TYPEID_PLAYER && target != this ? 1 : 0];
+
+    if (entry.built)
+        ++ValuesUpdateBlockCache::s_hits;
+    else
+    {
+        ++ValuesUpdateBlockCache::s_misses;
+
+        entry.block.clear();
+        entry.viewerFields.clear();
+
+        entry.block << uint8(UPDATETYPE_VALUES);
+        entry.block << GetPackGUID();
+
+        UpdateMask updateMask;
+        updateMask.SetCount(m_valuesCount);
+
+        _SetUpdateBits(&updateMask, target);
+        SetViewerIndependentUpdateBits(UPDATETYPE_VALUES, &updateMask);
+
+        entry.block << (uint8)updateMask.GetBlockCount();
+        entry.block.append(updateMask.GetMask(), updateMask.GetLength());
+
+        // viewer dependent fields are written as placeholder and patched for every receiver
+        for (uint16 index = 0; index < m_valuesCount; ++index)
+        {
+            if (!updateMask.GetBit(index))
+                continue;
+
+            if (IsViewerDependentUpdateField(index))
+            {
+                entry.viewerFields.push_back(std::make_pair(index, entry.block.wpos()));
+                entry.block << uint32(0);
+            }
+            else
+                entry.block << GetUpdateFieldValue(index);
+        }
+
+        entry.built = true;
+    }
+
+    cache.patches.clear();
+    if (!entry.viewerFields.empty())
+    {
+        bool sendPercent;
+        bool activateToQuest;
+        GetViewerUpdateState(target, sendPercent, activateToQuest);
+
+        for (std::vector<std::pair<uint16, size_t> >::const_iterator itr = entry.viewerFields.begin(); itr != entry.viewerFields.end(); ++itr)
+            cache.patches.push_back(std::make_pair(itr->second, GetViewerUpdateFieldValue(itr->first, target, sendPercent, activateToQuest)));
+    }
+
+    data->AddUpdateBlock(entry.block, cache.patches);
+}
+
 void Object::BuildOutOfRangeUpdateBlock(UpdateData* data) const
 {
     data->AddOutOfRangeGUID(GetObjectGuid());
@@ -297,14 +358,10 @@ void Object::BuildMovementUpdate(ByteBuffer* data, uint8 updateFlags) const
         *data << uint32(WorldTimer::getMSTime());
 }
 
-void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const
+void Object::GetViewerUpdateState(Player* target, bool& sendPercent, bool& activateToQuest) const
 {
-    if (!target)
-        return;
-
-    bool IsActivateToQuest = false;
-    bool IsPerCasterAuraState = false;
-    bool sendPercent = false;
+    sendPercent = false;
+    activateToQuest = false;
 
     if (isType(TYPEMASK_UNIT))
     {
@@ -329,243 +386,255 @@ void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* u
             }
         }
     }
+    else if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
+    {
+        if (((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster())
+            activateToQuest = true;
+    }
+}
 
-    if (updatetype == UPDATETYPE_CREATE_OBJECT || updatetype == UPDATETYPE_CREATE_OBJECT2)
+bool Object::IsViewerDependentUpdateField(uint16 index) const
+{
+    if (isType(TYPEMASK_UNIT))
     {
-        if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
+        switch (index)
         {
-            if (((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster())
-                IsActivateToQuest = true;
-
-            updateMask->SetBit(GAMEOBJECT_DYN_FLAGS);
+            case UNIT_FIELD_HEALTH:
+            case UNIT_FIELD_MAXHEALTH:
+            case UNIT_FIELD_FLAGS:
+                return true;
+            case UNIT_NPC_FLAGS:
+            case UNIT_DYNAMIC_FLAGS:
+                return GetTypeId() == TYPEID_UNIT;
+            default:
+                return false;
         }
     }
-    else                                                    // case UPDATETYPE_VALUES
+
+    if (isType(TYPEMASK_GAMEOBJECT))
+        return index == GAMEOBJECT_DYN_FLAGS;
+
+    return false;
+}
+
+uint32 Object::GetUpdateFieldValue(uint16 index) const
+{
+    if (isType(TYPEMASK_UNIT))
     {
-        if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
+        // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
+        if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
         {
-            if (((GameObject*)this)->ActivateToQuest(target) || target->isGameMaster())
-                IsActivateToQuest = true;
+            // convert from float to uint32 and send
+            return uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
+        }
 
-            updateMask->SetBit(GAMEOBJECT_DYN_FLAGS);
-            updateMask->SetBit(GAMEOBJECT_ANIMPROGRESS);
+        // there are some float values which may be negative or can't get negative due to other checks
+        if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
+            (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
+            (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
+            (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
+        {
+            return uint32(m_floatValues[index]);
         }
     }
 
-    MANGOS_ASSERT(updateMask && updateMask->GetCount() == m_valuesCount);
-
-    *data << (uint8)updateMask->GetBlockCount();
-    data->append(updateMask->GetMask(), updateMask->GetLength());
+    // send in current format (float as float, uint32 as uint32)
+    return m_uint32Values[index];
+}
 
-    // 2 specialized loops for speed optimization in non-unit case
-    if (isType(TYPEMASK_UNIT))                              // unit (creature/player) case
+uint32 Object::GetViewerUpdateFieldValue(uint16 index, Player* target, bool sendPercent, bool activateToQuest) const
+{
+    if (isType(TYPEMASK_GAMEOBJECT))
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        if (index != GAMEOBJECT_DYN_FLAGS)
+            return GetUpdateFieldValue(index);
+
+        if (!activateToQuest)
+            return 0;                                       // disable quest object
+
+        // low and high 16 bits are sent as separate uint16 values
+        GameObject const* gameObject = static_cast<GameObject const*>(this);
+        switch (gameObject->GetGoType())
         {
-            if (updateMask->GetBit(index))
-            {
-                if (index == UNIT_NPC_FLAGS)
-                {
-                    uint32 appendValue = m_uint32Values[index];
+            case GAMEOBJECT_TYPE_QUESTGIVER:
+            case GAMEOBJECT_TYPE_CHEST:
+                if (gameObject->getLootState() == GO_READY || gameObject->getLootState() == GO_ACTIVATED)
+                    return GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE;
+                return 0;
+            case GAMEOBJECT_TYPE_GENERIC:
+            case GAMEOBJECT_TYPE_SPELL_FOCUS:
+            case GAMEOBJECT_TYPE_GOOBER:
+                return GO_DYNFLAG_LO_ACTIVATE;
+            default:
+                return 0;                                   // unknown, not happen.
+        }
+    }
 
-                    if (GetTypeId() == TYPEID_UNIT)
-                    {
-                        if (appendValue & UNIT_NPC_FLAG_TRAINER)
-                        {
-                            if (!((Creature*)this)->IsTrainerOf(target, false))
-                                appendValue &= ~UNIT_NPC_FLAG_TRAINER;
-                        }
-
-                        if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
-                        {
-                            if (target->getClass() != CLASS_HUNTER)
-                                appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
-                        }
-                        
-                        if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
-                        {
-                            QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
-                            {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanSeeStartQuest(pQuest))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
-                            }
-
-                            bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
-                            for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
-                            {
-                                Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
-                                if (target->CanRewardQuest(pQuest, false))
-                                {
-                                    appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
-                                    break;
-                                }
-                            }
-                        }
-                    }
+    if (!isType(TYPEMASK_UNIT))
+        return GetUpdateFieldValue(index);
 
-                    *data << uint32(appendValue);
-                }
-                else if (sendPercent && index == UNIT_FIELD_HEALTH)
-                {
-                    // send health percentage instead of real value to enemy
-                    if (m_uint32Values[UNIT_FIELD_HEALTH] == 0)
-                        *data << uint32(0);
-                    else
-                        *data << uint32(ceil(m_uint32Values[UNIT_FIELD_HEALTH] * 100 / float(m_uint32Values[UNIT_FIELD_MAXHEALTH]))); // never less than 1 as health is not zero
-                }
-                else if (sendPercent && index == UNIT_FIELD_MAXHEALTH)
-                {
-                    *data << uint32(100);
-                }
-                // FIXME: Some values at server stored in float format but must be sent to client in uint32 format
-                else if (index >= UNIT_FIELD_BASEATTACKTIME && index <= UNIT_FIELD_RANGEDATTACKTIME)
-                {
-                    // convert from float to uint32 and send
-                    *data << uint32(m_floatValues[index] < 0 ? 0 : m_floatValues[index]);
-                }
+    if (index == UNIT_NPC_FLAGS)
+    {
+        uint32 appendValue = m_uint32Values[index];
 
-                // there are some float values which may be negative or can't get negative due to other checks
-                else if ((index >= PLAYER_FIELD_NEGSTAT0    && index <= PLAYER_FIELD_NEGSTAT4) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSPOSITIVE + 6)) ||
-                         (index >= PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE  && index <= (PLAYER_FIELD_RESISTANCEBUFFMODSNEGATIVE + 6)) ||
-                         (index >= PLAYER_FIELD_POSSTAT0    && index <= PLAYER_FIELD_POSSTAT4))
-                {
-                    *data << uint32(m_floatValues[index]);
-                }
+        if (GetTypeId() == TYPEID_UNIT)
+        {
+            if (appendValue & UNIT_NPC_FLAG_TRAINER)
+            {
+                if (!((Creature*)this)->IsTrainerOf(target, false))
+                    appendValue &= ~UNIT_NPC_FLAG_TRAINER;
+            }
 
-                // Gamemasters should be always able to select units - remove not selectable flag
-                else if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
-                {
-                    *data << (m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE);
-                }
-                // Hide lootable animation for unallowed players
-                // Handle tapped flag
-                else if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
-                {
-                    Creature* creature = (Creature*)this;
-                    uint32 dynflagsValue = m_uint32Values[index];
-                    bool setTapFlags = false;
+            if (appendValue & UNIT_NPC_FLAG_STABLEMASTER)
+            {
+                if (target->getClass() != CLASS_HUNTER)
+                    appendValue &= ~UNIT_NPC_FLAG_STABLEMASTER;
+            }
 
-                    if (creature->isAlive())
-                    {
-                        // creature is alive so, not lootable
-                        dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-
-                        if (creature->isInCombat())
-                        {
-                            // as creature is in combat we have to manage tap flags
-                            setTapFlags = true;
-                        }
-                        else
-                        {
-                            // creature is not in combat so its not tapped
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED;
-                            //sLog.outString(">> %s is not in combat so not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                    }
-                    else
+            if (appendValue & UNIT_NPC_FLAG_FLIGHTMASTER)
+            {
+                QuestRelationsMapBounds bounds = sObjectMgr.GetCreatureQuestRelationsMapBounds(((Creature*)this)->GetEntry());
+                for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                {
+                    Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                    if (target->CanSeeStartQuest(pQuest))
                     {
-                        // check loot flag
-                        if (creature->loot && creature->loot->CanLoot(target))
-                        {
-                            // creature is dead and this player can loot it
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                        else
-                        {
-                            // creature is dead but this player cannot loot it
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
-                            //sLog.outString(">> %s is not lootable for %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-
-                        // as creature is died we have to manage tap flags
-                        setTapFlags = true;
+                        appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                        break;
                     }
+                }
 
-                    // check tap flags
-                    if (setTapFlags)
+                bounds = sObjectMgr.GetCreatureQuestInvolvedRelationsMapBounds(((Creature*)this)->GetEntry());
+                for (QuestRelationsMap::const_iterator itr = bounds.first; itr != bounds.second; ++itr)
+                {
+                    Quest const* pQuest = sObjectMgr.GetQuestTemplate(itr->second);
+                    if (target->CanRewardQuest(pQuest, false))
                     {
-                        if (creature->IsTappedBy(target))
-                        {
-                            // creature is in combat or died and tapped by this player
-                            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED;
-                            //sLog.outString(">> %s is tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
-                        else
-                        {
-                            // creature is in combat or died but not tapped by this player
-                            dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
-                            //sLog.outString(">> %s is not tapped by %s", this->GetObjectGuid().GetString().c_str(), target->GetObjectGuid().GetString().c_str());
-                        }
+                        appendValue &= ~UNIT_NPC_FLAG_FLIGHTMASTER;
+                        break;
                     }
-
-                    *data << dynflagsValue;
-                }
-                else                                        // Unhandled index, just send
-                {
-                    // send in current format (float as float, uint32 as uint32)
-                    *data << m_uint32Values[index];
                 }
             }
         }
+
+        return appendValue;
     }
-    else if (isType(TYPEMASK_GAMEOBJECT))                   // gameobject case
+
+    if (sendPercent && index == UNIT_FIELD_HEALTH)
     {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        // send health percentage instead of real value to enemy
+        if (m_uint32Values[UNIT_FIELD_HEALTH] == 0)
+            return 0;
+
+        return uint32(ceil(m_uint32Values[UNIT_FIELD_HEALTH] * 100 / float(m_uint32Values[UNIT_FIELD_MAXHEALTH]))); // never less than 1 as health is not zero
+    }
+
+    if (sendPercent && index == UNIT_FIELD_MAXHEALTH)
+        return 100;
+
+    // Gamemasters should be always able to select units - remove not selectable flag
+    if (index == UNIT_FIELD_FLAGS && target->isGameMaster())
+        return m_uint32Values[index] & ~UNIT_FLAG_NOT_SELECTABLE;
+
+    // Hide lootable animation for unallowed players
+    // Handle tapped flag
+    if (index == UNIT_DYNAMIC_FLAGS && GetTypeId() == TYPEID_UNIT)
+    {
+        Creature* creature = (Creature*)this;
+        uint32 dynflagsValue = m_uint32Values[index];
+        bool setTapFlags = false;
+
+        if (creature->isAlive())
         {
-            if (updateMask->GetBit(index))
+            // creature is alive so, not lootable
+            dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+
+            if (creature->isInCombat())
             {
-                // send in current format (float as float, uint32 as uint32)
-                if (index == GAMEOBJECT_DYN_FLAGS)
-                {
-                    if (IsActivateToQuest)
-                    {
-                        GameObject const* gameObject = static_cast<GameObject const*>(this);
-                        switch (((GameObject*)this)->GetGoType())
-                        {
-                            case GAMEOBJECT_TYPE_QUESTGIVER:
-                            case GAMEOBJECT_TYPE_CHEST:
-                                if (gameObject->getLootState() == GO_READY || gameObject->getLootState() == GO_ACTIVATED)
-                                    *data << uint16(GO_DYNFLAG_LO_ACTIVATE | GO_DYNFLAG_LO_SPARKLE);
-                                else
-                                    *data << uint16(0);
-                                *data << uint16(0);
-                                break;
-                            case GAMEOBJECT_TYPE_GENERIC:
-                            case GAMEOBJECT_TYPE_SPELL_FOCUS:
-                            case GAMEOBJECT_TYPE_GOOBER:
-                                *data << uint16(GO_DYNFLAG_LO_ACTIVATE);
-                                *data << uint16(0);
-                                break;
-                            default:
-                                *data << uint32(0);         // unknown, not happen.
-                                break;
-                        }
-                    }
-                    else
-                        *data << uint32(0);                 // disable quest object
-                }
-                else
-                    *data << m_uint32Values[index];         // other cases
+                // as creature is in combat we have to manage tap flags
+                setTapFlags = true;
+            }
+            else
+            {
+                // creature is not in combat so its not tapped
+                dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED;
             }
         }
-    }
-    else                                                    // other objects case (no special index checks)
-    {
-        for (uint16 index = 0; index < m_valuesCount; ++index)
+        else
         {
-            if (updateMask->GetBit(index))
+            // check loot flag
+            if (creature->loot && creature->loot->CanLoot(target))
             {
-                // send in current format (float as float, uint32 as uint32)
-                *data << m_uint32Values[index];
+                // creature is dead and this player can loot it
+                dynflagsValue = dynflagsValue | UNIT_DYNFLAG_LOOTABLE;
             }
+            else
+            {
+                // creature is dead but this player cannot loot it
+                dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_LOOTABLE;
+            }
+
+            // as creature is died we have to manage tap flags
+            setTapFlags = true;
         }
+
+        // check tap flags
+        if (setTapFlags)
+        {
+            if (creature->IsTappedBy(target))
+            {
+                // creature is in combat or died and tapped by this player
+                dynflagsValue = dynflagsValue & ~UNIT_DYNFLAG_TAPPED;
+            }
+            else
+            {
+                // creature is in combat or died but not tapped by this player
+                dynflagsValue = dynflagsValue | UNIT_DYNFLAG_TAPPED;
+            }
+        }
+
+        return dynflagsValue;
+    }
+
+    return GetUpdateFieldValue(index);
+}
+
+void Object::SetViewerIndependentUpdateBits(uint8 updatetype, UpdateMask* updateMask) const
+{
+    if (isType(TYPEMASK_GAMEOBJECT) && !((GameObject*)this)->IsTransport())
+    {
+        updateMask->SetBit(GAMEOBJECT_DYN_FLAGS);
+
+        if (updatetype == UPDATETYPE_VALUES)
+            updateMask->SetBit(GAMEOBJECT_ANIMPROGRESS);
+    }
+}
+
+void Object::BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const
+{
+    if (!target)
+        return;
+
+    bool sendPercent;
+    bool activateToQuest;
+    GetViewerUpdateState(target, sendPercent, activateToQuest);
+
+    SetViewerIndependentUpdateBits(updatetype, updateMask);
+
+    MANGOS_ASSERT(updateMask && updateMask->GetCount() == m_valuesCount);
+
+    *data << (uint8)updateMask->GetBlockCount();
+    data->append(updateMask->GetMask(), updateMask->GetLength());
+
+    for (uint16 index = 0; index < m_valuesCount; ++index)
+    {
+        if (!updateMask->GetBit(index))
+            continue;
+
+        if (IsViewerDependentUpdateField(index))
+            *data << GetViewerUpdateFieldValue(index, target, sendPercent, activateToQuest);
+        else
+            *data << GetUpdateFieldValue(index);
     }
 }
 
@@ -872,6 +941,20 @@ void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_play
     BuildValuesUpdateBlockForPlayer(&iter->second, iter->first);
 }
 
+void Object::BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateBlockCache& cache) const
+{
+    UpdateDataMapType::iterator iter = update_players.find(pl);
+
+    if (iter == update_players.end())
+    {
+        std::pair<UpdateDataMapType::iterator, bool> p = update_players.insert(UpdateDataMapType::value_type(pl, UpdateData()));
+        MANGOS_ASSERT(p.second);
+        iter = p.first;
+    }
+
+    BuildValuesUpdateBlockForPlayer(&iter->second, iter->first, cache);
+}
+
 void Object::AddToClientUpdateList()
 {
     sLog.outError("Unexpected call of Object::AddToClientUpdateList for object (TypeId: %u Update fields: %u)", GetTypeId(), m_valuesCount);
@@ -1857,12 +1940,13 @@ struct WorldObjectChangeAccumulator
 {
     UpdateDataMapType& i_updateDatas;
     WorldObject& i_object;
+    ValuesUpdateBlockCache i_cache;                         // values block is serialized once for all viewers
     WorldObjectChangeAccumulator(WorldObject& obj, UpdateDataMapType& d) : i_updateDatas(d), i_object(obj)
     {
         // send self fields changes in another way, otherwise
         // with new camera system when player's camera too far from player, camera wouldn't receive packets and changes from player
         if (i_object.isType(TYPEMASK_PLAYER))
-            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas);
+            i_object.BuildUpdateDataForPlayer((Player*)&i_object, i_updateDatas, i_cache);
     }
 
     void Visit(CameraMapType& m)
@@ -1871,7 +1955,7 @@ struct WorldObjectChangeAccumulator
         {
             Player* owner = iter->getSource()->GetOwner();
             if (owner != &i_object && owner->HaveAtClient(&i_object))
-                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas);
+                i_object.BuildUpdateDataForPlayer(owner, i_updateDatas, i_cache);
         }
     }
 
@@ -27,6 +27,7 @@
 #include "Camera.h"
 
 #include <set>
+#include <atomic>
 
 #define CONTACT_DISTANCE            0.5f
 #define INTERACTION_DISTANCE        5.0f
@@ -81,6 +82,30 @@ class Loot;
 
 typedef std::unordered_map<Player*, UpdateData> UpdateDataMapType;
 
+// UPDATETYPE_VALUES block of one object, serialized once and shared by all receivers
+// of a BuildUpdateData call, only viewer dependent fields are patched per receiver
+struct ValuesUpdateBlockCache
+{
+    struct Entry
+    {
+        Entry() : built(false) {}
+
+        ByteBuffer block;
+        std::vector<std::pair<uint16, size_t> > viewerFields;   // field index, position in block
+        bool built;
+    };
+
+    Entry entries[2];                                       // full field set, visible fields only (players seen by others)
+    UpdateBlockPatches patches;                             // reused for every receiver
+
+    static uint64 GetHits() { return s_hits; }
+    static uint64 GetMisses() { return s_misses; }
+    static void ResetCounters() { s_hits = 0; s_misses = 0; }
+
+    static std::atomic<uint64> s_hits;
+    static std::atomic<uint64> s_misses;
+};
+
 struct Position
 {
     Position() : x(0.0f), y(0.0f), z(0.0f), o(0.0f) {}
@@ -175,6 +200,7 @@ class MANGOS_DLL_SPEC Object
         void SendForcedObjectUpdate();
 
         void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target) const;
+        void BuildValuesUpdateBlockForPlayer(UpdateData* data, Player* target, ValuesUpdateBlockCache& cache) const;
         void BuildOutOfRangeUpdateBlock(UpdateData* data) const;
         void BuildMovementUpdateBlock(UpdateData* data, uint8 flags = 0) const;
 
@@ -380,6 +406,14 @@ class MANGOS_DLL_SPEC Object
         void BuildMovementUpdate(ByteBuffer* data, uint8 updateFlags) const;
         void BuildValuesUpdate(uint8 updatetype, ByteBuffer* data, UpdateMask* updateMask, Player* target) const;
         void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players) const;
+        void BuildUpdateDataForPlayer(Player* pl, UpdateDataMapType& update_players, ValuesUpdateBlockCache& cache) const;
+
+        // update field serialization, split into the parts shared by all receivers and the per receiver ones
+        void GetViewerUpdateState(Player* target, bool& sendPercent, bool& activateToQuest) const;
+        void SetViewerIndependentUpdateBits(uint8 updatetype, UpdateMask* updateMask) const;
+        bool IsViewerDependentUpdateField(uint16 index) const;
+        uint32 GetUpdateFieldValue(uint16 index) const;
+        uint32 GetViewerUpdateFieldValue(uint16 index, Player* target, bool sendPercent, bool activateToQuest) const;
 
         uint16 m_objectType;
 
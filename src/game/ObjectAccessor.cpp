@@ -85,13 +85,41 @@ Player* ObjectAccessor::FindPlayer(ObjectGuid guid, bool inWorld /*= true*/)
 
 Player* ObjectAccessor::FindPlayerByName(const char* name)
 {
-    HashMapHolder<Player>::ReadGuard g(HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType& m = sObjectAccessor.GetPlayers();
-    for (HashMapHolder<Player>::MapType::iterator iter = m.begin(); iter != m.end(); ++iter)
-        if (iter->second->IsInWorld() && (::strcmp(name, iter->second->GetName()) == 0))
-            return iter->second;
+    std::string key = GetPlayerNameKey(name);
+
+    ObjectAccessor& accessor = sObjectAccessor;
+    boost::shared_lock<boost::shared_mutex> guard(accessor.i_playersByNameLock);
+
+    PlayerNameMapType::const_iterator itr = accessor.i_playersByName.find(key);
+    if (itr == accessor.i_playersByName.end() || !itr->second->IsInWorld())
+        return nullptr;
+
+    return itr->second;
+}
+
+void ObjectAccessor::AddObject(Player* object)
+{
+    HashMapHolder<Player>::Insert(object);
+
+    boost::unique_lock<boost::shared_mutex> guard(i_playersByNameLock);
+    i_playersByName[GetPlayerNameKey(object->GetName())] = object;
+}
+
+void ObjectAccessor::RemoveObject(Player* object)
+{
+    HashMapHolder<Player>::Remove(object);
+
+    boost::unique_lock<boost::shared_mutex> guard(i_playersByNameLock);
+    PlayerNameMapType::iterator itr = i_playersByName.find(GetPlayerNameKey(object->GetName()));
+    if (itr != i_playersByName.end() && itr->second == object)
+        i_playersByName.erase(itr);
+}
 
-    return nullptr;
+std::string ObjectAccessor::GetPlayerNameKey(char const* name)
+{
+    std::string key = name;
+    normalizePlayerName(key);                               // keeps the name as it is if not valid utf8
+    return key;
 }
 
 void
@@ -269,7 +297,7 @@ void ObjectAccessor::RemoveOldCorpses()
 /// Define the static member of HashMapHolder
 
 template <class T> typename HashMapHolder<T>::MapType HashMapHolder<T>::m_objectMap;
-template <class T> std::mutex HashMapHolder<T>::i_lock;
+template <class T> typename HashMapHolder<T>::LockType HashMapHolder<T>::i_lock;
 
 /// Global definitions for the hashmap storage
 
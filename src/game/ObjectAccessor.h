@@ -32,6 +32,10 @@
 #include "Corpse.h"
 
 #include <mutex>
+#include <string>
+
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 class Unit;
 class WorldObject;
@@ -43,9 +47,9 @@ class HashMapHolder
     public:
 
         typedef std::unordered_map<ObjectGuid, T*>   MapType;
-        typedef std::mutex LockType;
-        typedef std::lock_guard<std::mutex> ReadGuard;
-        typedef std::lock_guard<std::mutex> WriteGuard;
+        typedef boost::shared_mutex LockType;               // lookups by many map threads at once, rare inserts/removes
+        typedef boost::shared_lock<LockType> ReadGuard;
+        typedef boost::unique_lock<LockType> WriteGuard;
 
         static void Insert(T* o)
         {
@@ -97,7 +101,7 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
 
         // Player access
         static Player* FindPlayer(ObjectGuid guid, bool inWorld = true);// if need player at specific map better use Map::GetPlayer
-        static Player* FindPlayerByName(const char* name);
+        static Player* FindPlayerByName(const char* name);   // name is normalized, case does not matter
         static void KickPlayer(ObjectGuid guid);
 
         HashMapHolder<Player>::MapType& GetPlayers()
@@ -118,14 +122,20 @@ class ObjectAccessor : public MaNGOS::Singleton<ObjectAccessor, MaNGOS::ClassLev
 
         // For call from Player/Corpse AddToWorld/RemoveFromWorld only
         void AddObject(Corpse* object) { HashMapHolder<Corpse>::Insert(object); }
-        void AddObject(Player* object) { HashMapHolder<Player>::Insert(object); }
+        void AddObject(Player* object);
         void RemoveObject(Corpse* object) { HashMapHolder<Corpse>::Remove(object); }
-        void RemoveObject(Player* object) { HashMapHolder<Player>::Remove(object); }
+        void RemoveObject(Player* object);
 
     private:
+        typedef std::unordered_map<std::string, Player*> PlayerNameMapType;
+
+        static std::string GetPlayerNameKey(char const* name);
 
         Player2CorpsesMapType   i_player2corpse;
 
+        PlayerNameMapType i_playersByName;                  // all players of HashMapHolder<Player>, by normalized name
+        boost::shared_mutex i_playersByNameLock;
+
         typedef std::mutex LockType;
         typedef MaNGOS::GeneralLock<LockType > Guard;
 
@@ -107,12 +107,13 @@ LanguageDesc const* GetLanguageDescByID(uint32 lang)
 template<typename T>
 T IdGenerator<T>::Generate()
 {
-    if (m_nextGuid >= std::numeric_limits<T>::max() - 1)
+    T guid = m_nextGuid++;
+    if (guid >= std::numeric_limits<T>::max() - 1)
     {
         sLog.outError("%s guid overflow!! Can't continue, shutting down server. ", m_name);
         World::StopNow(ERROR_EXIT_CODE);
     }
-    return m_nextGuid++;
+    return guid;
 }
 
 template uint32 IdGenerator<uint32>::Generate();
@@ -960,7 +961,7 @@ void ObjectMgr::LoadCreatures()
 {
     uint32 count = 0;
     //                                                0                       1   2    3
-    QueryResult* result = WorldDatabase.Query("SELECT creature.guid, creature.id, map, modelid,"
+    QueryResult* result = WorldDatabase.QueryBinary("SELECT creature.guid, creature.id, map, modelid,"
                           //   4             5           6           7           8            9              10         11
                           "equipment_id, position_x, position_y, position_z, orientation, spawntimesecs, spawndist, currentwaypoint,"
                           //   12         13       14          15            16
@@ -1132,7 +1133,7 @@ void ObjectMgr::LoadGameObjects()
     uint32 count = 0;
 
     //                                                0                           1   2    3           4           5           6
-    QueryResult* result = WorldDatabase.Query("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
+    QueryResult* result = WorldDatabase.QueryBinary("SELECT gameobject.guid, gameobject.id, map, position_x, position_y, position_z, orientation,"
                           //   7          8          9          10         11             12            13     14
                           "rotation0, rotation1, rotation2, rotation3, spawntimesecs, animprogress, state, event,"
                           //   15                          16
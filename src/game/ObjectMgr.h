@@ -441,7 +441,7 @@ class IdGenerator
 
     private:                                                // fields
         char const* m_name;
-        T m_nextGuid;
+        std::atomic<T> m_nextGuid;
 };
 
 class ObjectMgr
@@ -0,0 +1,149 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "OpcodeProfiler.h"
+#include "Policies/Singleton.h"
+#include "TSS.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+INSTANTIATE_SINGLETON_1(OpcodeProfiler);
+
+static MaNGOS::thread_local_ptr<uint64> threadBytesSent([] () { return new uint64(0); });
+
+OpcodeProfiler::OpcodeProfiler() : m_enabled(false)
+{
+    Reset();
+}
+
+void OpcodeProfiler::SetEnabled(bool enabled)
+{
+    m_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void OpcodeProfiler::Reset()
+{
+    for (int i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        OpcodeCounters& counters = m_counters[i];
+        counters.calls.store(0, std::memory_order_relaxed);
+        counters.totalTimeUs.store(0, std::memory_order_relaxed);
+        counters.maxTimeUs.store(0, std::memory_order_relaxed);
+        counters.bytesIn.store(0, std::memory_order_relaxed);
+        counters.bytesOut.store(0, std::memory_order_relaxed);
+    }
+
+    m_startTime = time(nullptr);
+}
+
+uint64 OpcodeProfiler::GetThreadBytesSent() const
+{
+    return *threadBytesSent.get();
+}
+
+void OpcodeProfiler::AddThreadBytesSent(size_t bytes)
+{
+    *threadBytesSent.get() += bytes;
+}
+
+void OpcodeProfiler::Record(uint16 opcode, Clock::duration time, size_t bytesIn, uint64 bytesOut)
+{
+    if (opcode >= NUM_MSG_TYPES)
+        return;
+
+    uint64 timeUs = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+
+    OpcodeCounters& counters = m_counters[opcode];
+    counters.calls.fetch_add(1, std::memory_order_relaxed);
+    counters.totalTimeUs.fetch_add(timeUs, std::memory_order_relaxed);
+    counters.bytesIn.fetch_add(bytesIn, std::memory_order_relaxed);
+    counters.bytesOut.fetch_add(bytesOut, std::memory_order_relaxed);
+
+    uint64 maxTimeUs = counters.maxTimeUs.load(std::memory_order_relaxed);
+    while (timeUs > maxTimeUs && !counters.maxTimeUs.compare_exchange_weak(maxTimeUs, timeUs, std::memory_order_relaxed)) {}
+}
+
+void OpcodeProfiler::BuildReport(std::vector<OpcodeReport>& report, SortOrder order) const
+{
+    report.clear();
+
+    for (int i = 0; i < NUM_MSG_TYPES; ++i)
+    {
+        OpcodeCounters const& counters = m_counters[i];
+
+        OpcodeReport entry;
+        entry.calls = counters.calls.load(std::memory_order_relaxed);
+        if (!entry.calls)
+            continue;
+
+        entry.opcode = uint16(i);
+        entry.totalTimeUs = counters.totalTimeUs.load(std::memory_order_relaxed);
+        entry.maxTimeUs = counters.maxTimeUs.load(std::memory_order_relaxed);
+        entry.bytesIn = counters.bytesIn.load(std::memory_order_relaxed);
+        entry.bytesOut = counters.bytesOut.load(std::memory_order_relaxed);
+        report.push_back(entry);
+    }
+
+    std::stable_sort(report.begin(), report.end(), [order] (OpcodeReport const& a, OpcodeReport const& b)
+    {
+        switch (order)
+        {
+            case SORT_BY_MAX_TIME:  return a.maxTimeUs > b.maxTimeUs;
+            case SORT_BY_CALLS:     return a.calls > b.calls;
+            case SORT_BY_BYTES_OUT: return a.bytesOut > b.bytesOut;
+            default:                return a.totalTimeUs > b.totalTimeUs;
+        }
+    });
+}
+
+bool OpcodeProfiler::IsValidReportFileName(char const* fileName)
+{
+    // no directories and no "..", the command must not reach files outside of the logs directory
+    if (!fileName || !*fileName || *fileName == '.')
+        return false;
+
+    return strpbrk(fileName, "/\\:") == nullptr;
+}
+
+bool OpcodeProfiler::WriteReport(char const* fileName) const
+{
+    if (!IsValidReportFileName(fileName))
+        return false;
+
+    FILE* file = fopen((sLog.GetLogsDir() + fileName).c_str(), "w");
+    if (!file)
+        return false;
+
+    std::vector<OpcodeReport> report;
+    BuildReport(report, SORT_BY_TOTAL_TIME);
+
+    fprintf(file, "# opcode handler profile, started " UI64FMTD ", written " UI64FMTD "\n", uint64(m_startTime), uint64(time(nullptr)));
+    fprintf(file, "opcode,name,calls,total_us,avg_us,max_us,bytes_in,bytes_out\n");
+
+    for (std::vector<OpcodeReport>::const_iterator itr = report.begin(); itr != report.end(); ++itr)
+        fprintf(file, "0x%04X,%s," UI64FMTD "," UI64FMTD "," UI64FMTD "," UI64FMTD "," UI64FMTD "," UI64FMTD "\n",
+                itr->opcode, LookupOpcodeName(itr->opcode), itr->calls, itr->totalTimeUs, itr->totalTimeUs / itr->calls,
+                itr->maxTimeUs, itr->bytesIn, itr->bytesOut);
+
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
@@ -0,0 +1,100 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_OPCODEPROFILER_H
+#define MANGOS_OPCODEPROFILER_H
+
+#include "Common.h"
+#include "Policies/Singleton.h"
+#include "Opcodes.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+/**
+ * Cost of client packet handlers per opcode: calls, total and worst wall time, packet bytes
+ * received and bytes of all packets sent while the handler ran.
+ *
+ * Disabled by default (see Network.OpcodeProfiler and .debug opcodeprofile), a disabled profiler
+ * costs one relaxed atomic load per handled packet and per sent packet. Handlers run in the world
+ * thread and in map update threads, so all counters are atomics updated without locks; a report
+ * taken while handlers run may mix counters of one call.
+ */
+class OpcodeProfiler
+{
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        struct OpcodeReport
+        {
+            uint16 opcode;
+            uint64 calls;
+            uint64 totalTimeUs;
+            uint64 maxTimeUs;
+            uint64 bytesIn;
+            uint64 bytesOut;
+        };
+
+        // sort order of BuildReport
+        enum SortOrder
+        {
+            SORT_BY_TOTAL_TIME,
+            SORT_BY_MAX_TIME,
+            SORT_BY_CALLS,
+            SORT_BY_BYTES_OUT,
+        };
+
+        OpcodeProfiler();
+
+        void SetEnabled(bool enabled);
+        bool IsEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+        void Reset();
+        time_t GetStartTime() const { return m_startTime; }
+
+        // bytes out are counted per thread, take the value before and after the handler call
+        uint64 GetThreadBytesSent() const;
+        void AddThreadBytesSent(size_t bytes);
+
+        void Record(uint16 opcode, Clock::duration time, size_t bytesIn, uint64 bytesOut);
+
+        // only opcodes called at least once
+        void BuildReport(std::vector<OpcodeReport>& report, SortOrder order) const;
+        // CSV with one line per called opcode, written to the logs directory (LogsDir)
+        // only plain file names are accepted, false for other names or if the file can't be written
+        bool WriteReport(char const* fileName) const;
+        static bool IsValidReportFileName(char const* fileName);
+
+    private:
+        struct OpcodeCounters
+        {
+            std::atomic<uint64> calls;
+            std::atomic<uint64> totalTimeUs;
+            std::atomic<uint64> maxTimeUs;
+            std::atomic<uint64> bytesIn;
+            std::atomic<uint64> bytesOut;
+        };
+
+        std::atomic<bool> m_enabled;
+        time_t m_startTime;                                 // start of the collected data, set at Reset
+        OpcodeCounters m_counters[NUM_MSG_TYPES];
+};
+
+#define sOpcodeProfiler MaNGOS::Singleton<OpcodeProfiler>::Instance()
+
+#endif
@@ -0,0 +1,144 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PathCache.h"
+
+#include <algorithm>
+
+PathCache::PathCache(uint32 lifetime) : m_corridorCount(0), m_lifetime(lifetime), m_time(0), m_cleanupTimer(0)
+{
+}
+
+void PathCache::Update(uint32 diff)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    m_time += diff;
+
+    m_cleanupTimer += diff;
+    if (m_cleanupTimer < IN_MILLISECONDS)
+        return;
+
+    m_cleanupTimer = 0;
+    RemoveExpired();
+}
+
+uint32 PathCache::Find(dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, uint16 excludeFlags,
+                       dtPolyRef* path, uint32 maxPathLength)
+{
+    if (!m_lifetime)
+        return 0;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    ++m_stats.lookups;
+
+    CorridorMap::iterator found = m_corridors.find(endPoly);
+    if (found == m_corridors.end())
+        return 0;
+
+    CorridorList& corridors = found->second;
+    for (CorridorList::iterator itr = corridors.begin(); itr != corridors.end(); ++itr)
+    {
+        if (itr->includeFlags != includeFlags || itr->excludeFlags != excludeFlags || IsExpired(*itr))
+            continue;
+
+        std::vector<dtPolyRef> const& polys = itr->polys;
+        std::vector<dtPolyRef>::const_iterator start = std::find(polys.begin(), polys.end(), startPoly);
+        if (start == polys.end())
+            continue;
+
+        uint32 length = uint32(polys.end() - start);
+        if (length > maxPathLength)
+            continue;
+
+        // a reloaded tile invalidates the references of its polygons
+        bool valid = true;
+        for (std::vector<dtPolyRef>::const_iterator poly = start; poly != polys.end() && valid; ++poly)
+            valid = navMesh->isValidPolyRef(*poly);
+
+        if (!valid)
+        {
+            corridors.erase(itr);
+            --m_corridorCount;
+            break;
+        }
+
+        std::copy(start, polys.end(), path);
+        ++m_stats.hits;
+        return length;
+    }
+
+    return 0;
+}
+
+void PathCache::Store(dtPolyRef const* path, uint32 pathLength, uint16 includeFlags, uint16 excludeFlags)
+{
+    if (!m_lifetime || pathLength < 2)
+        return;
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    ++m_stats.stores;
+
+    CorridorList& corridors = m_corridors[path[pathLength - 1]];
+
+    CachedCorridor* corridor;
+    if (corridors.size() < MaxCorridorsPerEnd)
+    {
+        corridors.push_back(CachedCorridor());
+        corridor = &corridors.back();
+        ++m_corridorCount;
+    }
+    else
+    {
+        // replace the oldest one
+        corridor = &corridors.front();
+        for (CorridorList::iterator itr = corridors.begin(); itr != corridors.end(); ++itr)
+            if (m_time - itr->storeTime > m_time - corridor->storeTime)
+                corridor = &*itr;
+    }
+
+    corridor->polys.assign(path, path + pathLength);
+    corridor->includeFlags = includeFlags;
+    corridor->excludeFlags = excludeFlags;
+    corridor->storeTime = m_time;
+}
+
+void PathCache::RemoveExpired()
+{
+    for (CorridorMap::iterator itr = m_corridors.begin(); itr != m_corridors.end();)
+    {
+        CorridorList& corridors = itr->second;
+        for (CorridorList::iterator corridor = corridors.begin(); corridor != corridors.end();)
+        {
+            if (IsExpired(*corridor))
+            {
+                corridor = corridors.erase(corridor);
+                --m_corridorCount;
+            }
+            else
+                ++corridor;
+        }
+
+        if (corridors.empty())
+            itr = m_corridors.erase(itr);
+        else
+            ++itr;
+    }
+}
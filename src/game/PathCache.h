@@ -0,0 +1,112 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATHCACHE_H
+#define MANGOS_PATHCACHE_H
+
+#include "Common.h"
+#include "../recastnavigation/Detour/Include/DetourNavMesh.h"
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Recently found polygon corridors of one map instance, shared by the PathFinders of its units.
+ *
+ * Chasing creatures ask for a new path whenever their target moves, and a pack chasing one target
+ * asks for nearly the same path again and again. A stored corridor is reused by every request to
+ * the same end polygon whose start polygon lies on it; the rest of the corridor from there is the
+ * shortest polygon path as well, so the pack shares one path search.
+ *
+ * Corridors are kept for mmap.pathCacheTime milliseconds. Tiles can be reloaded meanwhile, so the
+ * polygons of a reused corridor are checked to be still valid. PathFinderPool threads search paths
+ * of the map while it is updated, so all access is locked.
+ */
+class PathCache
+{
+    public:
+        struct Stats
+        {
+            Stats() : lookups(0), hits(0), stores(0), corridorMoves(0) {}
+
+            uint64 lookups;                                 // full path requests
+            uint64 hits;                                    // requests answered from a stored corridor
+            uint64 stores;                                  // corridors found by a path search
+            uint64 corridorMoves;                           // corridor end moved along with the target, no search
+        };
+
+        explicit PathCache(uint32 lifetime);                // ms a corridor is kept, 0 disables the cache
+
+        // advances the cache clock, drops expired corridors about once per second
+        void Update(uint32 diff);
+        bool IsEnabled() const { return m_lifetime != 0; }
+
+        // copies the corridor part from startPoly to endPoly into path, returns its length or 0
+        uint32 Find(dtNavMesh const* navMesh, dtPolyRef startPoly, dtPolyRef endPoly, uint16 includeFlags, uint16 excludeFlags,
+                    dtPolyRef* path, uint32 maxPathLength);
+        // path must end at the requested end polygon
+        void Store(dtPolyRef const* path, uint32 pathLength, uint16 includeFlags, uint16 excludeFlags);
+
+        void AddCorridorMove()
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            ++m_stats.corridorMoves;
+        }
+
+        Stats GetStats() const
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            return m_stats;
+        }
+
+        uint32 GetCorridorCount() const
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            return m_corridorCount;
+        }
+
+    private:
+        struct CachedCorridor
+        {
+            std::vector<dtPolyRef> polys;
+            uint16 includeFlags;
+            uint16 excludeFlags;
+            uint32 storeTime;
+        };
+
+        typedef std::vector<CachedCorridor> CorridorList;
+        typedef std::unordered_map<dtPolyRef, CorridorList> CorridorMap;
+
+        // different corridors kept per end polygon (chasers from different sides), the oldest is replaced
+        static const uint32 MaxCorridorsPerEnd = 4;
+
+        bool IsExpired(CachedCorridor const& corridor) const { return m_time - corridor.storeTime >= m_lifetime; }
+        void RemoveExpired();
+
+        CorridorMap m_corridors;                            // by end polygon
+        uint32 m_corridorCount;
+        uint32 m_lifetime;                                  // mmap.pathCacheTime at creation, 0 when disabled
+        uint32 m_time;                                      // sum of update diffs
+        uint32 m_cleanupTimer;
+        Stats m_stats;
+
+        mutable std::mutex m_mutex;
+};
+
+#endif
@@ -20,6 +20,8 @@
 #include "GridMap.h"
 #include "Creature.h"
 #include "PathFinder.h"
+#include "PathCache.h"
+#include "Map.h"
 #include "Log.h"
 
 #include "../recastnavigation/Detour/Include/DetourCommon.h"
@@ -28,16 +30,20 @@
 PathFinder::PathFinder(const Unit* owner) :
     m_polyLength(0), m_type(PATHFIND_BLANK),
     m_useStraightPath(false), m_forceDestination(false), m_pointPathLimit(MAX_POINT_PATH_LENGTH),
-    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr)
+    m_sourceUnit(owner), m_navMesh(nullptr), m_navMeshQuery(nullptr), m_ownerNavMeshQuery(nullptr),
+    m_navMeshLock(nullptr), m_mapId(owner->GetMapId()), m_sourceGuidLow(owner->GetGUIDLow()),
+    m_sourceIsCreature(false), m_sourceCanFly(false), m_sourceCanSwim(false), m_startUnderWater(false), m_endUnderWater(false),
+    m_pathCache(nullptr)
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::PathInfo for %u \n", m_sourceGuidLow);
 
-    uint32 mapId = m_sourceUnit->GetMapId();
-    if (MMAP::MMapFactory::IsPathfindingEnabled(mapId, owner))
+    if (MMAP::MMapFactory::IsPathfindingEnabled(m_mapId, owner))
     {
         MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
-        m_navMesh = mmap->GetNavMesh(mapId);
-        m_navMeshQuery = mmap->GetNavMeshQuery(mapId, m_sourceUnit->GetInstanceId());
+        m_navMesh = mmap->GetNavMesh(m_mapId);
+        m_ownerNavMeshQuery = mmap->GetNavMeshQuery(m_mapId, m_sourceUnit->GetInstanceId());
+        m_navMeshQuery = m_ownerNavMeshQuery;
+        m_navMeshLock = mmap->GetNavMeshLock(m_mapId);
     }
 
     createFilter();
@@ -45,10 +51,19 @@ PathFinder::PathFinder(const Unit* owner) :
 
 PathFinder::~PathFinder()
 {
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceUnit->GetGUIDLow());
+    // may be destroyed by a PathFinderPool thread after the owner is gone
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::~PathInfo() for %u \n", m_sourceGuidLow);
 }
 
 bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest)
+{
+    if (prepareSearch(destX, destY, destZ, forceDest))
+        searchPath(m_ownerNavMeshQuery);
+
+    return true;
+}
+
+bool PathFinder::prepareSearch(float destX, float destY, float destZ, bool forceDest)
 {
     // Vector3 oldDest = getEndPosition();
     Vector3 dest(destX, destY, destZ);
@@ -61,24 +76,54 @@ bool PathFinder::calculate(float destX, float destY, float destZ, bool forceDest
 
     m_forceDestination = forceDest;
 
-    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceUnit->GetGUIDLow());
+    DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ PathFinder::calculate() for %u \n", m_sourceGuidLow);
 
     // make sure navMesh works - we can run on map w/o mmap
     // check if the start and end point have a .mmtile loaded (can we pass via not loaded tile on the way?)
-    if (!m_navMesh || !m_navMeshQuery || m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING) ||
-            !HaveTile(start) || !HaveTile(dest))
+    bool haveTiles = false;
+    if (m_navMesh && m_ownerNavMeshQuery && !m_sourceUnit->hasUnitState(UNIT_STAT_IGNORE_PATHFINDING))
+    {
+        boost::shared_lock<boost::shared_mutex> guard(*m_navMeshLock);
+        haveTiles = HaveTile(start) && HaveTile(dest);
+    }
+
+    if (!haveTiles)
     {
         BuildShortcut();
         m_type = PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH);
-        return true;
+        return false;
     }
 
     updateFilter();
 
-    BuildPolyPath(start, dest);
+    // the owner may have been moved to another instance since the last path
+    m_pathCache = m_sourceUnit->IsInWorld() ? m_sourceUnit->GetMap()->GetPathCache() : nullptr;
+    m_sourceIsCreature = m_sourceUnit->GetTypeId() == TYPEID_UNIT;
+    m_sourceCanFly = m_sourceIsCreature && ((Creature*)m_sourceUnit)->CanFly();
+    m_sourceCanSwim = m_sourceIsCreature && ((Creature*)m_sourceUnit)->CanSwim();
+
+    // terrain may load grids, so it is only read here in the map thread and never by searchPath
+    TerrainInfo const* terrain = m_sourceUnit->GetTerrain();
+    m_startUnderWater = m_sourceIsCreature && terrain->IsUnderWater(start.x, start.y, start.z);
+    m_endUnderWater = m_sourceIsCreature && terrain->IsUnderWater(dest.x, dest.y, dest.z);
     return true;
 }
 
+void PathFinder::searchPath(dtNavMeshQuery const* query)
+{
+    if (!query)
+    {
+        BuildShortcut();
+        m_type = PATHFIND_NOPATH;
+        return;
+    }
+
+    m_navMeshQuery = query;
+
+    boost::shared_lock<boost::shared_mutex> guard(*m_navMeshLock);
+    BuildPolyPath(getStartPosition(), getEndPosition());
+}
+
 dtPolyRef PathFinder::getPathPolyByPosition(const dtPolyRef* polyPath, uint32 polyPathSize, const float* point, float* distance) const
 {
     if (!polyPath || !polyPathSize)
@@ -168,14 +213,14 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: (startPoly == 0 || endPoly == 0)\n");
         BuildShortcut();
 
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_sourceIsCreature)
         {
             // Check for swimming or flying shortcut
-            if ((startPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderWater(startPos.x, startPos.y, startPos.z)) ||
-                    (endPoly == INVALID_POLYREF && m_sourceUnit->GetTerrain()->IsUnderWater(endPos.x, endPos.y, endPos.z)))
-                m_type = ((Creature*)m_sourceUnit)->CanSwim() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+            if ((startPoly == INVALID_POLYREF && m_startUnderWater) ||
+                    (endPoly == INVALID_POLYREF && m_endUnderWater))
+                m_type = m_sourceCanSwim ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
             else
-                m_type = ((Creature*)m_sourceUnit)->CanFly() ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
+                m_type = m_sourceCanFly ? PathType(PATHFIND_NORMAL | PATHFIND_NOT_USING_PATH) : PATHFIND_NOPATH;
         }
         else
             m_type = PATHFIND_NOPATH;
@@ -190,21 +235,18 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: farFromPoly distToStartPoly=%.3f distToEndPoly=%.3f\n", distToStartPoly, distToEndPoly);
 
         bool buildShotrcut = false;
-        if (m_sourceUnit->GetTypeId() == TYPEID_UNIT)
+        if (m_sourceIsCreature)
         {
-            Creature* owner = (Creature*)m_sourceUnit;
-
-            Vector3 p = (distToStartPoly > 7.0f) ? startPos : endPos;
-            if (m_sourceUnit->GetTerrain()->IsUnderWater(p.x, p.y, p.z))
+            if ((distToStartPoly > 7.0f) ? m_startUnderWater : m_endUnderWater)
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: underWater case\n");
-                if (owner->CanSwim())
+                if (m_sourceCanSwim)
                     buildShotrcut = true;
             }
             else
             {
                 DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: flying case\n");
-                if (owner->CanFly())
+                if (m_sourceCanFly)
                     buildShotrcut = true;
             }
         }
@@ -259,7 +301,7 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         for (pathStartIndex = 0; pathStartIndex < m_polyLength; ++pathStartIndex)
         {
             // here to catch few bugs
-            MANGOS_ASSERT(m_pathPolyRefs[pathStartIndex] != INVALID_POLYREF || m_sourceUnit->PrintEntryError("PathFinder::BuildPolyPath"));
+            MANGOS_ASSERT(m_pathPolyRefs[pathStartIndex] != INVALID_POLYREF);
 
             if (m_pathPolyRefs[pathStartIndex] == startPoly)
             {
@@ -295,62 +337,75 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // so we have atleast part of poly-path ready
 
         m_polyLength -= pathStartIndex;
+        memmove(m_pathPolyRefs, m_pathPolyRefs + pathStartIndex, m_polyLength * sizeof(dtPolyRef));
 
-        // try to adjust the suffix of the path instead of recalculating entire length
-        // at given interval the target cannot get too far from its last location
-        // thus we have less poly to cover
-        // sub-path of optimal path is optimal
+        // target moved only a few polygons away, walk the corridor end after it
+        if (MoveCorridorEnd(endPoly, endPoint))
+        {
+            DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  corridor end moved, m_polyLength=%u \n", m_polyLength);
 
-        // take ~80% of the original length
-        // TODO : play with the values here
-        uint32 prefixPolyLength = uint32(m_polyLength * 0.8f + 0.5f);
-        memmove(m_pathPolyRefs, m_pathPolyRefs + pathStartIndex, prefixPolyLength * sizeof(dtPolyRef));
+            if (m_pathCache)
+                m_pathCache->AddCorridorMove();
+        }
+        else
+        {
+            // try to adjust the suffix of the path instead of recalculating entire length
+            // at given interval the target cannot get too far from its last location
+            // thus we have less poly to cover
+            // sub-path of optimal path is optimal
 
-        dtPolyRef suffixStartPoly = m_pathPolyRefs[prefixPolyLength - 1];
+            // take ~80% of the original length
+            // TODO : play with the values here
+            uint32 prefixPolyLength = uint32(m_polyLength * 0.8f + 0.5f);
 
-        // we need any point on our suffix start poly to generate poly-path, so we need last poly in prefix data
-        float suffixEndPoint[VERTEX_SIZE];
-        dtResult = m_navMeshQuery->closestPointOnPoly(suffixStartPoly, endPoint, suffixEndPoint, nullptr);
-        if (dtStatusFailed(dtResult))
-        {
-            // we can hit offmesh connection as last poly - closestPointOnPoly() don't like that
-            // try to recover by using prev polyref
-            --prefixPolyLength;
-            suffixStartPoly = m_pathPolyRefs[prefixPolyLength - 1];
+            dtPolyRef suffixStartPoly = m_pathPolyRefs[prefixPolyLength - 1];
+
+            // we need any point on our suffix start poly to generate poly-path, so we need last poly in prefix data
+            float suffixEndPoint[VERTEX_SIZE];
             dtResult = m_navMeshQuery->closestPointOnPoly(suffixStartPoly, endPoint, suffixEndPoint, nullptr);
             if (dtStatusFailed(dtResult))
             {
-                // suffixStartPoly is still invalid, error state
-                BuildShortcut();
-                m_type = PATHFIND_NOPATH;
-                return;
+                // we can hit offmesh connection as last poly - closestPointOnPoly() don't like that
+                // try to recover by using prev polyref
+                --prefixPolyLength;
+                suffixStartPoly = m_pathPolyRefs[prefixPolyLength - 1];
+                dtResult = m_navMeshQuery->closestPointOnPoly(suffixStartPoly, endPoint, suffixEndPoint, nullptr);
+                if (dtStatusFailed(dtResult))
+                {
+                    // suffixStartPoly is still invalid, error state
+                    BuildShortcut();
+                    m_type = PATHFIND_NOPATH;
+                    return;
+                }
             }
-        }
 
-        // generate suffix
-        uint32 suffixPolyLength = 0;
-        dtResult = m_navMeshQuery->findPath(
-                       suffixStartPoly,    // start polygon
-                       endPoly,            // end polygon
-                       suffixEndPoint,     // start position
-                       endPoint,           // end position
-                       &m_filter,            // polygon search filter
-                       m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
-                       (int*)&suffixPolyLength,
-                       MAX_PATH_LENGTH - prefixPolyLength); // max number of polygons in output path
+            // generate suffix
+            uint32 suffixPolyLength = 0;
+            dtResult = m_navMeshQuery->findPath(
+                           suffixStartPoly,    // start polygon
+                           endPoly,            // end polygon
+                           suffixEndPoint,     // start position
+                           endPoint,           // end position
+                           &m_filter,            // polygon search filter
+                           m_pathPolyRefs + prefixPolyLength - 1,    // [out] path
+                           (int*)&suffixPolyLength,
+                           MAX_PATH_LENGTH - prefixPolyLength); // max number of polygons in output path
+
+            if (!suffixPolyLength || dtStatusFailed(dtResult))
+            {
+                // this is probably an error state, but we'll leave it
+                // and hopefully recover on the next Update
+                // we still need to copy our preffix
+                sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
+            }
 
-        if (!suffixPolyLength || dtStatusFailed(dtResult))
-        {
-            // this is probably an error state, but we'll leave it
-            // and hopefully recover on the next Update
-            // we still need to copy our preffix
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
-        }
+            DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n", m_polyLength, prefixPolyLength, suffixPolyLength);
 
-        DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++  m_polyLength=%u prefixPolyLength=%u suffixPolyLength=%u \n", m_polyLength, prefixPolyLength, suffixPolyLength);
+            // new path = prefix + suffix - overlap
+            m_polyLength = prefixPolyLength + suffixPolyLength - 1;
 
-        // new path = prefix + suffix - overlap
-        m_polyLength = prefixPolyLength + suffixPolyLength - 1;
+            StoreCorridor(endPoly);
+        }
     }
     else
     {
@@ -363,24 +418,36 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
         // free and invalidate old path data
         clear();
 
-        dtResult = m_navMeshQuery->findPath(
-                       startPoly,          // start polygon
-                       endPoly,            // end polygon
-                       startPoint,         // start position
-                       endPoint,           // end position
-                       &m_filter,           // polygon search filter
-                       m_pathPolyRefs,     // [out] path
-                       (int*)&m_polyLength,
-                       MAX_PATH_LENGTH);   // max number of polygons in output path
+        // another unit may have searched a path to the same end polygon through our start polygon
+        if (m_pathCache)
+            m_polyLength = m_pathCache->Find(m_navMesh, startPoly, endPoly, m_filter.getIncludeFlags(), m_filter.getExcludeFlags(),
+                                             m_pathPolyRefs, MAX_PATH_LENGTH);
 
-        if (!m_polyLength || dtStatusFailed(dtResult))
+        if (!m_polyLength)
         {
-            // only happens if we passed bad data to findPath(), or navmesh is messed up
-            sLog.outError("%u's Path Build failed: 0 length path", m_sourceUnit->GetGUIDLow());
-            BuildShortcut();
-            m_type = PATHFIND_NOPATH;
-            return;
+            dtResult = m_navMeshQuery->findPath(
+                           startPoly,          // start polygon
+                           endPoly,            // end polygon
+                           startPoint,         // start position
+                           endPoint,           // end position
+                           &m_filter,           // polygon search filter
+                           m_pathPolyRefs,     // [out] path
+                           (int*)&m_polyLength,
+                           MAX_PATH_LENGTH);   // max number of polygons in output path
+
+            if (!m_polyLength || dtStatusFailed(dtResult))
+            {
+                // only happens if we passed bad data to findPath(), or navmesh is messed up
+                sLog.outError("%u's Path Build failed: 0 length path", m_sourceGuidLow);
+                BuildShortcut();
+                m_type = PATHFIND_NOPATH;
+                return;
+            }
+
+            StoreCorridor(endPoly);
         }
+        else
+            DEBUG_FILTER_LOG(LOG_FILTER_PATHFINDING, "++ BuildPolyPath :: path cache hit, m_polyLength=%u\n", m_polyLength);
     }
 
     // by now we know what type of path we can get
@@ -393,6 +460,36 @@ void PathFinder::BuildPolyPath(const Vector3& startPos, const Vector3& endPos)
     BuildPointPath(startPoint, endPoint);
 }
 
+bool PathFinder::MoveCorridorEnd(dtPolyRef endPoly, const float* endPoint)
+{
+    // like dtPathCorridor::moveTargetPosition: walk from the old corridor end towards the new end position,
+    // when the walk reaches the end polygon the visited polygons extend (or shorten) the corridor
+    dtPolyRef lastPoly = m_pathPolyRefs[m_polyLength - 1];
+
+    float lastPoint[VERTEX_SIZE];
+    if (dtStatusFailed(m_navMeshQuery->closestPointOnPoly(lastPoly, endPoint, lastPoint, nullptr)))
+        return false;
+
+    static const int MAX_VISITED = 16;              // a few polygons at most, else a new search is better
+    dtPolyRef visited[MAX_VISITED];
+    int visitedCount = 0;
+    float resultPoint[VERTEX_SIZE];
+
+    dtStatus dtResult = m_navMeshQuery->moveAlongSurface(lastPoly, lastPoint, endPoint, &m_filter,
+                        resultPoint, visited, &visitedCount, MAX_VISITED);
+    if (dtStatusFailed(dtResult) || !visitedCount || visited[visitedCount - 1] != endPoly)
+        return false;
+
+    m_polyLength = mergeCorridorEndMoved(m_pathPolyRefs, m_polyLength, MAX_PATH_LENGTH, visited, visitedCount);
+    return m_pathPolyRefs[m_polyLength - 1] == endPoly;
+}
+
+void PathFinder::StoreCorridor(dtPolyRef endPoly) const
+{
+    if (m_pathCache && m_polyLength && m_pathPolyRefs[m_polyLength - 1] == endPoly)
+        m_pathCache->Store(m_pathPolyRefs, m_polyLength, m_filter.getIncludeFlags(), m_filter.getExcludeFlags());
+}
+
 void PathFinder::BuildPointPath(const float* startPoint, const float* endPoint)
 {
     float pathPoints[MAX_POINT_PATH_LENGTH * VERTEX_SIZE];
@@ -596,6 +693,41 @@ uint32 PathFinder::fixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath,
     return req + size;
 }
 
+uint32 PathFinder::mergeCorridorEndMoved(dtPolyRef* path, uint32 npath, uint32 maxPath,
+                                         const dtPolyRef* visited, uint32 nvisited) const
+{
+    int32 furthestPath = -1;
+    int32 furthestVisited = -1;
+
+    // Find the first corridor polygon visited by the move, the target may have moved back along the corridor.
+    for (uint32 i = 0; i < npath && furthestPath == -1; ++i)
+    {
+        for (int32 j = nvisited - 1; j >= 0; --j)
+        {
+            if (path[i] == visited[j])
+            {
+                furthestPath = i;
+                furthestVisited = j;
+                break;
+            }
+        }
+    }
+
+    // If no intersection found just return current path.
+    if (furthestPath == -1 || furthestVisited == -1)
+        return npath;
+
+    // Concatenate paths.
+    uint32 ppos = furthestPath + 1;
+    uint32 vpos = furthestVisited + 1;
+    uint32 count = std::min(nvisited - vpos, maxPath - ppos);
+    MANGOS_ASSERT(ppos + count <= maxPath);
+    if (count)
+        memcpy(path + ppos, visited + vpos, sizeof(dtPolyRef) * count);
+
+    return ppos + count;
+}
+
 bool PathFinder::getSteerTarget(const float* startPos, const float* endPos,
                                 float minTargetDist, const dtPolyRef* path, uint32 pathSize,
                                 float* steerPos, unsigned char& steerPosFlag, dtPolyRef& steerPosRef) const
@@ -25,10 +25,13 @@
 
 #include "movement/MoveSplineInitArgs.h"
 
+#include <boost/thread/shared_mutex.hpp>
+
 using Movement::Vector3;
 using Movement::PointsArray;
 
 class Unit;
+class PathCache;
 
 // 74*4.0f=296y  number_of_points*interval = max_path_len
 // this is way more than actual evade range
@@ -62,6 +65,14 @@ class PathFinder
         // return: true if new path was calculated, false otherwise (no change needed)
         bool calculate(float destX, float destY, float destZ, bool forceDest = false);
 
+        // calculate() split for PathFinderPool: prepareSearch reads the owner and must run in the thread
+        // updating its map, it returns true when the navmesh still has to be searched (else the path is done).
+        // searchPath does not touch the owner and may run in any thread owning the given query
+        bool prepareSearch(float destX, float destY, float destZ, bool forceDest = false);
+        void searchPath(dtNavMeshQuery const* query);
+
+        uint32 getMapId() const { return m_mapId; }
+
         // option setters - use optional
         void setUseStrightPath(bool useStraightPath) { m_useStraightPath = useStraightPath; };
         void setPathLengthLimit(float distance) { m_pointPathLimit = std::min<uint32>(uint32(distance / SMOOTH_PATH_STEP_SIZE), MAX_POINT_PATH_LENGTH); };
@@ -90,12 +101,25 @@ class PathFinder
         Vector3        m_endPosition;      // {x, y, z} of the destination
         Vector3        m_actualEndPosition;// {x, y, z} of the closest possible point to given destination
 
-        const Unit* const       m_sourceUnit;       // the unit that is moving
+        const Unit* const       m_sourceUnit;       // the unit that is moving, not used by searchPath
         const dtNavMesh*        m_navMesh;          // the nav mesh
         const dtNavMeshQuery*   m_navMeshQuery;     // the nav mesh query used to find the path
+        const dtNavMeshQuery*   m_ownerNavMeshQuery;// query of the owner's map instance, used by calculate()
+        boost::shared_mutex*    m_navMeshLock;      // held shared while searching, loading grids adds tiles
+
+        // owner data needed by searchPath, copied by prepareSearch
+        uint32                  m_mapId;
+        uint32                  m_sourceGuidLow;
+        bool                    m_sourceIsCreature;
+        bool                    m_sourceCanFly;
+        bool                    m_sourceCanSwim;
+        bool                    m_startUnderWater;  // only set for creatures
+        bool                    m_endUnderWater;
 
         dtQueryFilter m_filter;                     // use single filter for all movements, update it when needed
 
+        PathCache*              m_pathCache;        // corridors found recently on the map, nullptr without mmaps
+
         void setStartPosition(const Vector3& point) { m_startPosition = point; }
         void setEndPosition(const Vector3& point) { m_actualEndPosition = point; m_endPosition = point; }
         void setActualEndPosition(const Vector3& point) { m_actualEndPosition = point; }
@@ -115,6 +139,8 @@ class PathFinder
         bool HaveTile(const Vector3& p) const;
 
         void BuildPolyPath(const Vector3& startPos, const Vector3& endPos);
+        bool MoveCorridorEnd(dtPolyRef endPoly, const float* endPoint);
+        void StoreCorridor(dtPolyRef endPoly) const;
         void BuildPointPath(const float* startPoint, const float* endPoint);
         void BuildShortcut();
 
@@ -125,6 +151,8 @@ class PathFinder
         // smooth path aux functions
         uint32 fixupCorridor(dtPolyRef* path, uint32 npath, uint32 maxPath,
                              const dtPolyRef* visited, uint32 nvisited);
+        uint32 mergeCorridorEndMoved(dtPolyRef* path, uint32 npath, uint32 maxPath,
+                                     const dtPolyRef* visited, uint32 nvisited) const;
         bool getSteerTarget(const float* startPos, const float* endPos, float minTargetDist,
                             const dtPolyRef* path, uint32 pathSize, float* steerPos,
                             unsigned char& steerPosFlag, dtPolyRef& steerPosRef) const;
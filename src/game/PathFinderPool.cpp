@@ -0,0 +1,137 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "PathFinderPool.h"
+#include "PathFinder.h"
+#include "MoveMap.h"
+#include "Log.h"
+
+#include <algorithm>
+
+void PathFinderPool::Activate(uint32 numThreads)
+{
+    Deactivate();
+
+    m_cancel = false;
+    m_searching.assign(numThreads, nullptr);
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workers.push_back(std::thread(&PathFinderPool::WorkerThread, this, i));
+
+    sLog.outString("PathFinderPool: started %u path finder threads", numThreads);
+}
+
+void PathFinderPool::Deactivate()
+{
+    if (m_workers.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_cancel = true;
+    }
+    m_queueCondition.notify_all();
+
+    for (std::vector<std::thread>::iterator itr = m_workers.begin(); itr != m_workers.end(); ++itr)
+        itr->join();
+
+    m_workers.clear();
+
+    // waiting generators search these paths themselves
+    std::lock_guard<std::mutex> guard(m_mutex);
+    for (std::deque<PathRequestPtr>::iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+        DropRequest(*itr);
+
+    m_queue.clear();
+}
+
+PathRequestPtr PathFinderPool::Search(Map const* map, std::shared_ptr<PathFinder> const& path)
+{
+    PathRequestPtr request(new PathRequest(map, path));
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_queue.push_back(request);
+    }
+    m_queueCondition.notify_one();
+
+    return request;
+}
+
+void PathFinderPool::CancelRequests(Map const* map)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (std::deque<PathRequestPtr>::iterator itr = m_queue.begin(); itr != m_queue.end();)
+    {
+        if ((*itr)->m_map == map)
+        {
+            DropRequest(*itr);
+            itr = m_queue.erase(itr);
+        }
+        else
+            ++itr;
+    }
+
+    m_doneCondition.wait(lock, [this, map] { return std::find(m_searching.begin(), m_searching.end(), map) == m_searching.end(); });
+}
+
+uint32 PathFinderPool::GetQueueSize() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_queue.size();
+}
+
+void PathFinderPool::DropRequest(PathRequestPtr const& request)
+{
+    request->m_path.reset();
+    request->m_done.store(true, std::memory_order_release);
+}
+
+void PathFinderPool::WorkerThread(uint32 workerId)
+{
+    MMAP::MMapManager* mmap = MMAP::MMapFactory::createOrGetMMapManager();
+
+    for (;;)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queueCondition.wait(lock, [this] { return m_cancel || !m_queue.empty(); });
+
+        if (m_cancel)
+            break;
+
+        PathRequestPtr request = m_queue.front();
+        m_queue.pop_front();
+        m_searching[workerId] = request->m_map;
+        lock.unlock();
+
+        // nobody waits for the path anymore if the generator dropped the request
+        if (request.use_count() > 1)
+        {
+            PathFinder& path = *request->m_path;
+            path.searchPath(mmap->GetWorkerNavMeshQuery(path.getMapId(), workerId));
+            request->m_searched = true;
+        }
+
+        request->m_path.reset();
+        request->m_done.store(true, std::memory_order_release);
+
+        lock.lock();
+        m_searching[workerId] = nullptr;
+        lock.unlock();
+        m_doneCondition.notify_all();
+    }
+}
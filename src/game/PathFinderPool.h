@@ -0,0 +1,105 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_PATHFINDERPOOL_H
+#define MANGOS_PATHFINDERPOOL_H
+
+#include "Common.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Map;
+class PathFinder;
+
+class PathRequest
+{
+    public:
+        PathRequest(Map const* map, std::shared_ptr<PathFinder> const& path) : m_map(map), m_path(path), m_done(false), m_searched(false) {}
+
+        // the PathFinder may be used again once the request is done
+        bool IsDone() const { return m_done.load(std::memory_order_acquire); }
+        // false while not done and for requests dropped by PathFinderPool::Deactivate or CancelRequests, search in place then
+        bool IsSearched() const { return IsDone() && m_searched; }
+
+    private:
+        friend class PathFinderPool;
+
+        Map const* m_map;
+        std::shared_ptr<PathFinder> m_path;                 // released once done
+        std::atomic<bool> m_done;
+        bool m_searched;                                    // set before m_done, only read after m_done was seen
+};
+
+typedef std::shared_ptr<PathRequest> PathRequestPtr;
+
+/**
+ * Worker pool searching mmap paths outside of the map update.
+ *
+ * A movement generator prepares its PathFinder in the map update (PathFinder::prepareSearch reads
+ * the owner and the terrain at both path ends), hands it over with Search and checks the returned
+ * request on its next updates. The PathFinder must not be used until the request is done; a
+ * generator no longer interested in the result just drops the request, the worker frees the
+ * PathFinder with it.
+ *
+ * Every worker searches with its own dtNavMeshQuery per map id (MMapManager::GetWorkerNavMeshQuery)
+ * and holds the navmesh lock of the map shared meanwhile, so grids can still be loaded and unloaded.
+ * Workers never touch TerrainInfo, its grids are only referenced and loaded by map threads.
+ * Map::~Map cancels the requests of the map before its path cache is freed.
+ */
+class PathFinderPool
+{
+    public:
+        PathFinderPool() : m_cancel(false) {}
+        ~PathFinderPool() { Deactivate(); }
+
+        void Activate(uint32 numThreads);
+        void Deactivate();
+        bool IsActive() const { return !m_workers.empty(); }
+
+        // path must be prepared by PathFinder::prepareSearch in the update of map
+        PathRequestPtr Search(Map const* map, std::shared_ptr<PathFinder> const& path);
+        // drops the queued requests of map and waits for the ones being searched
+        void CancelRequests(Map const* map);
+
+        uint32 GetThreadCount() const { return m_workers.size(); }
+        uint32 GetQueueSize() const;
+
+    private:
+        PathFinderPool(PathFinderPool const&);
+        PathFinderPool& operator=(PathFinderPool const&);
+
+        void WorkerThread(uint32 workerId);
+        void DropRequest(PathRequestPtr const& request);    // must be called with m_mutex locked
+
+        std::vector<std::thread> m_workers;
+        std::deque<PathRequestPtr> m_queue;
+        std::vector<Map const*> m_searching;                // map of the request each worker is searching
+        bool m_cancel;
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_queueCondition;
+        std::condition_variable m_doneCondition;
+};
+
+#endif
@@ -43,6 +43,9 @@
 #include "Util.h"
 #include "Chat.h"
 #include "SQLStorages.h"
+#include "LineOfSightCache.h"
+
+#include <memory>
 
 extern pEffect SpellEffects[TOTAL_SPELL_EFFECTS];
 
@@ -2553,7 +2556,7 @@ void Spell::SpellStart(SpellCastTargets const* targets, Aura* triggeredByAura)
         m_triggeredByAuraSpell = triggeredByAura->GetSpellProto();
 
     // create and add update event for this spell
-    SpellEvent* Event = new SpellEvent(this);
+    SpellEvent* Event = m_caster->m_Events.MakeEvent<SpellEvent>(this);
     m_caster->m_Events.AddEvent(Event, m_caster->m_Events.CalculateTime(1));
 
     // Fill cost data
@@ -6435,6 +6438,49 @@ void Spell::FillAreaTargets(UnitList& targetUnitMap, float radius, SpellNotifyPu
 {
     MaNGOS::SpellNotifierCreatureAndPlayer notifier(*this, targetUnitMap, radius, pushType, spellTargets, originalCaster);
     Cell::VisitAllObjects(notifier.GetCenterX(), notifier.GetCenterY(), m_caster->GetMap(), notifier, radius);
+
+    // CheckTarget tests line of sight from the casting object to every target, trace all of them at once
+    // so those checks are answered by the map line of sight cache
+    Map* map = m_caster->GetMap();
+    WorldObject* caster = GetCastingObject();
+    if (targetUnitMap.size() < 2 || !caster || !caster->IsInMap(m_caster) || !map->GetLineOfSightCache()->IsEnabled())
+        return;
+
+    // not for spells cast without line of sight checks
+    if (m_IsTriggeredSpell || !VMAP::VMapFactory::checkSpellForLoS(m_spellInfo->Id))
+        return;
+
+    // only effects using the normal line of sight case of CheckTarget
+    bool checksLineOfSight = false;
+    for (int i = 0; i < MAX_EFFECT_INDEX && !checksLineOfSight; ++i)
+    {
+        switch (m_spellInfo->Effect[i])
+        {
+            case SPELL_EFFECT_NONE:
+            case SPELL_EFFECT_SUMMON_PLAYER:
+            case SPELL_EFFECT_DUMMY:
+            case SPELL_EFFECT_RESURRECT_NEW:
+                break;
+            default:
+                checksLineOfSight = true;
+                break;
+        }
+    }
+
+    if (!checksLineOfSight)
+        return;
+
+    std::vector<float> dests;
+    dests.reserve(targetUnitMap.size() * 3);
+    for (UnitList::const_iterator itr = targetUnitMap.begin(); itr != targetUnitMap.end(); ++itr)
+    {
+        dests.push_back((*itr)->GetPositionX());
+        dests.push_back((*itr)->GetPositionY());
+        dests.push_back((*itr)->GetPositionZ() + 2.0f);
+    }
+
+    std::unique_ptr<bool[]> results(new bool[targetUnitMap.size()]);
+    map->IsInLineOfSight(caster->GetPositionX(), caster->GetPositionY(), caster->GetPositionZ() + 2.0f, &dests[0], targetUnitMap.size(), results.get());
 }
 
 void Spell::FillRaidOrPartyTargets(UnitList& targetUnitMap, Unit* member, float radius, bool raid, bool withPets, bool withcaster) const
@@ -615,7 +615,12 @@ void Aura::ApplyModifier(bool apply, bool Real)
     GetHolder()->SetInUse(true);
     SetInUse(true);
     if (aura < TOTAL_AURAS)
+    {
+        // handlers may change the modifier amount, also after reading the totals themselves
+        GetTarget()->InvalidateAuraModifierCache(aura);
         (*this.*AuraHandler [aura])(apply, Real);
+        GetTarget()->InvalidateAuraModifierCache(aura);
+    }
 
     SetInUse(false);
     GetHolder()->SetInUse(false);
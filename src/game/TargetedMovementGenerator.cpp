@@ -18,6 +18,8 @@
 
 #include "TargetedMovementGenerator.h"
 #include "PathFinder.h"
+#include "PathFinderPool.h"
+#include "MapManager.h"
 #include "Unit.h"
 #include "Creature.h"
 #include "Player.h"
@@ -25,6 +27,9 @@
 #include "movement/MoveSplineInit.h"
 #include "movement/MoveSpline.h"
 
+// a path search waiting longer in the PathFinderPool queue is done in the map update instead
+#define PATH_REQUEST_MAX_DELAY                            300
+
 //-----------------------------------------------//
 template<class T, typename D>
 void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool updateDestination)
@@ -35,6 +40,10 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool up
     if (owner.hasUnitState(UNIT_STAT_NOT_MOVE))
         return;
 
+    // keep moving on the old path, the destination is checked again when the searched one is used
+    if (i_pathRequest)
+        return;
+
     float x, y, z;
 
     // i_path can be nullptr in case this is the first call for this MMGen (via Update)
@@ -69,13 +78,68 @@ void TargetedMovementGeneratorMedium<T, D>::_setTargetLocation(T& owner, bool up
         z = end.z;
     }
 
+    if (_calculatePath(owner, x, y, z, false))
+        _moveByPath(owner);
+}
+
+template<class T, typename D>
+bool TargetedMovementGeneratorMedium<T, D>::_calculatePath(T& owner, float x, float y, float z, bool inPlace)
+{
     if (!i_path)
-        i_path = new PathFinder(&owner);
+        i_path.reset(new PathFinder(&owner));
 
     // allow pets following their master to cheat while generating paths
     bool forceDest = (owner.GetTypeId() == TYPEID_UNIT && ((Creature*)&owner)->IsPet()
                       && owner.hasUnitState(UNIT_STAT_FOLLOW));
-    i_path->calculate(x, y, z, forceDest);
+
+    PathFinderPool& pool = sMapMgr.GetPathFinderPool();
+    if (inPlace || !pool.IsActive())
+    {
+        i_path->calculate(x, y, z, forceDest);
+        return true;
+    }
+
+    if (!i_path->prepareSearch(x, y, z, forceDest))
+        return true;                                        // no navmesh search needed, path is ready
+
+    i_pathRequest = pool.Search(owner.GetMap(), i_path);
+    i_pathRequestDelay = 0;
+    return false;
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_updatePathRequest(T& owner, uint32 diff)
+{
+    bool done = i_pathRequest->IsDone();
+    if (!done || !i_pathRequest->IsSearched())
+    {
+        if (!done)
+        {
+            i_pathRequestDelay += diff;
+            if (i_pathRequestDelay < PATH_REQUEST_MAX_DELAY)
+                return;
+        }
+
+        // the destination is set by prepareSearch and not changed by the search
+        G3D::Vector3 dest = i_path->getEndPosition();
+
+        // the worker may still use the PathFinder, leave it to the dropped request
+        if (!done)
+            i_path.reset();
+
+        i_pathRequest.reset();
+        _calculatePath(owner, dest.x, dest.y, dest.z, true);
+    }
+    else
+        i_pathRequest.reset();
+
+    _moveByPath(owner);
+}
+
+template<class T, typename D>
+void TargetedMovementGeneratorMedium<T, D>::_moveByPath(T& owner)
+{
+    i_reachable = (i_path->getPathType() & PATHFIND_NORMAL) != 0;
     if (i_path->getPathType() & PATHFIND_NOPATH)
         return;
 
@@ -152,6 +216,9 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
         }
     }
 
+    if (i_pathRequest)
+        _updatePathRequest(owner, time_diff);
+
     if (m_speedChanged || targetMoved)
         _setTargetLocation(owner, targetMoved);
 
@@ -169,7 +236,7 @@ bool TargetedMovementGeneratorMedium<T, D>::Update(T& owner, const uint32& time_
 template<class T, typename D>
 bool TargetedMovementGeneratorMedium<T, D>::IsReachable() const
 {
-    return (i_path) ? (i_path->getPathType() & PATHFIND_NORMAL) : true;
+    return i_reachable;
 }
 
 template<class T, typename D>
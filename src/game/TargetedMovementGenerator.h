@@ -23,7 +23,10 @@
 #include "FollowerReference.h"
 #include <G3D/Vector3.h>
 
+#include <memory>
+
 class PathFinder;
+class PathRequest;
 
 class MANGOS_DLL_SPEC TargetedMovementGeneratorBase
 {
@@ -43,11 +46,11 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
             TargetedMovementGeneratorBase(target),
             i_recheckDistance(0),
             i_offset(offset), i_angle(angle),
-            m_speedChanged(false), i_targetReached(false),
-            i_path(nullptr)
+            m_speedChanged(false), i_targetReached(false), i_reachable(true),
+            i_pathRequestDelay(0)
         {
         }
-        ~TargetedMovementGeneratorMedium() { delete i_path; }
+        ~TargetedMovementGeneratorMedium() {}
 
     public:
         bool Update(T&, const uint32&);
@@ -60,6 +63,10 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
 
     protected:
         void _setTargetLocation(T&, bool updateDestination);
+        // returns false while the path is searched by the PathFinderPool
+        bool _calculatePath(T&, float x, float y, float z, bool inPlace);
+        void _updatePathRequest(T&, uint32 diff);
+        void _moveByPath(T&);
         bool RequiresNewPosition(T& owner, float x, float y, float z) const;
         virtual float GetDynamicTargetDistance(T& /*owner*/, bool /*forRangeCheck*/) const { return i_offset; }
 
@@ -69,8 +76,11 @@ class MANGOS_DLL_SPEC TargetedMovementGeneratorMedium
         G3D::Vector3 m_prevTargetPos;
         bool m_speedChanged : 1;
         bool i_targetReached : 1;
+        bool i_reachable : 1;                               // result of the last used path
 
-        PathFinder* i_path;
+        std::shared_ptr<PathFinder> i_path;                 // shared with the PathFinderPool while searched
+        std::shared_ptr<PathRequest> i_pathRequest;
+        uint32 i_pathRequestDelay;
 };
 
 template<class T>
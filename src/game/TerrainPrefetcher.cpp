@@ -0,0 +1,97 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "TerrainPrefetcher.h"
+#include "GridMap.h"
+#include "Log.h"
+
+#include <algorithm>
+
+void TerrainPrefetcher::Activate(uint32 numThreads)
+{
+    Deactivate();
+
+    m_cancel = false;
+    for (uint32 i = 0; i < numThreads; ++i)
+        m_workers.push_back(std::thread(&TerrainPrefetcher::WorkerThread, this));
+
+    sLog.outString("TerrainPrefetcher: started %u grid prefetch threads", numThreads);
+}
+
+void TerrainPrefetcher::Deactivate()
+{
+    if (m_workers.empty())
+        return;
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_cancel = true;
+    }
+    m_queueCondition.notify_all();
+
+    for (std::vector<std::thread>::iterator itr = m_workers.begin(); itr != m_workers.end(); ++itr)
+        itr->join();
+
+    m_workers.clear();
+
+    // drop not started requests, the map will load these grids itself
+    for (std::deque<PrefetchRequest>::iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+        itr->terrain->Release();
+
+    m_queue.clear();
+}
+
+void TerrainPrefetcher::Prefetch(TerrainInfo* terrain, uint32 x, uint32 y)
+{
+    if (m_workers.empty() || terrain->IsGridLoaded(x, y))
+        return;
+
+    PrefetchRequest request(terrain, x, y);
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (std::find(m_queue.begin(), m_queue.end(), request) != m_queue.end())
+            return;
+
+        terrain->AddRef();                                  // keep terrain alive while queued
+        m_queue.push_back(request);
+    }
+    m_queueCondition.notify_one();
+}
+
+void TerrainPrefetcher::WorkerThread()
+{
+    for (;;)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_queueCondition.wait(lock, [this] { return m_cancel || !m_queue.empty(); });
+
+        if (m_cancel)
+            break;
+
+        PrefetchRequest request = m_queue.front();
+        m_queue.pop_front();
+        lock.unlock();
+
+        DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "TerrainPrefetcher: loading grid [%u,%u] of map %u", request.x, request.y, request.terrain->GetMapId());
+        request.terrain->PrefetchGrid(request.x, request.y);
+
+        // if the last map of this terrain is gone meanwhile the terrain stays cached in TerrainManager
+        // until the map is created again, its unreferenced grids are freed by CleanUpGrids
+        request.terrain->Release();
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_TERRAINPREFETCHER_H
+#define MANGOS_TERRAINPREFETCHER_H
+
+#include "Common.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TerrainInfo;
+
+/**
+ * I/O worker pool reading terrain (.map) files of grids ahead of time.
+ *
+ * Maps queue grids they expect to need soon (see Map::PrefetchGridsAhead). A worker reads the
+ * GridMap and parks it in the shared TerrainInfo. When the map later creates the grid,
+ * TerrainInfo::LoadMapAndVMap takes it over and loads the vmap and mmap tiles in the map update,
+ * since those trees are queried by map threads without locks.
+ *
+ * A queued request holds a reference to its TerrainInfo, so the terrain is not freed while
+ * the request waits. Prefetched GridMaps not taken over survive at least one
+ * TerrainInfo::CleanUpGrids pass.
+ */
+class TerrainPrefetcher
+{
+    public:
+        TerrainPrefetcher() : m_cancel(false) {}
+        ~TerrainPrefetcher() { Deactivate(); }
+
+        void Activate(uint32 numThreads);
+        void Deactivate();
+        bool IsActive() const { return !m_workers.empty(); }
+
+        // x, y are TerrainInfo grid indexes
+        void Prefetch(TerrainInfo* terrain, uint32 x, uint32 y);
+
+    private:
+        struct PrefetchRequest
+        {
+            PrefetchRequest(TerrainInfo* _terrain, uint32 _x, uint32 _y) : terrain(_terrain), x(_x), y(_y) {}
+
+            bool operator==(PrefetchRequest const& other) const { return terrain == other.terrain && x == other.x && y == other.y; }
+
+            TerrainInfo* terrain;
+            uint32 x;
+            uint32 y;
+        };
+
+        void WorkerThread();
+
+        std::vector<std::thread> m_workers;
+        std::deque<PrefetchRequest> m_queue;                // also used for duplicate check, it stays short
+        bool m_cancel;
+
+        std::mutex m_mutex;
+        std::condition_variable m_queueCondition;
+};
+
+#endif
@@ -2102,6 +2102,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* pCaster, SpellSchoolMask schoolM
         mod->m_amount -= currentAbsorb;
         if ((*i)->GetHolder()->DropAuraCharge())
             mod->m_amount = 0;
+        InvalidateAuraModifierCache(mod->m_auraname);
         // Need remove it later
         if (mod->m_amount <= 0)
             existExpired = true;
@@ -2152,6 +2153,7 @@ void Unit::CalculateDamageAbsorbAndResist(Unit* pCaster, SpellSchoolMask schoolM
         }
 
         (*i)->GetModifier()->m_amount -= currentAbsorb;
+        InvalidateAuraModifierCache(SPELL_AURA_MANA_SHIELD);
         if ((*i)->GetModifier()->m_amount <= 0)
         {
             RemoveAurasDueToSpell((*i)->GetId());
@@ -3647,48 +3649,22 @@ void Unit::DeMorph()
 
 int32 Unit::GetTotalAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        modifier += (*i)->GetModifier()->m_amount;
-
-    return modifier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_NONE, 0).total;
 }
 
 float Unit::GetTotalAuraMultiplier(AuraType auratype) const
 {
-    float multiplier = 1.0f;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        multiplier *= (100.0f + (*i)->GetModifier()->m_amount) / 100.0f;
-
-    return multiplier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_NONE, 0).multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        if ((*i)->GetModifier()->m_amount > modifier)
-            modifier = (*i)->GetModifier()->m_amount;
-
-    return modifier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_NONE, 0).maxPositive;
 }
 
 int32 Unit::GetMaxNegativeAuraModifier(AuraType auratype) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-        if ((*i)->GetModifier()->m_amount < modifier)
-            modifier = (*i)->GetModifier()->m_amount;
-
-    return modifier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_NONE, 0).maxNegative;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -3696,16 +3672,7 @@ int32 Unit::GetTotalAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask)
     if (!misc_mask)
         return 0;
 
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue & misc_mask)
-            modifier += mod->m_amount;
-    }
-    return modifier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_MISC_MASK, int32(misc_mask)).total;
 }
 
 float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -3713,16 +3680,7 @@ float Unit::GetTotalAuraMultiplierByMiscMask(AuraType auratype, uint32 misc_mask
     if (!misc_mask)
         return 1.0f;
 
-    float multiplier = 1.0f;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue & misc_mask)
-            multiplier *= (100.0f + mod->m_amount) / 100.0f;
-    }
-    return multiplier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_MISC_MASK, int32(misc_mask)).multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -3730,17 +3688,7 @@ int32 Unit::GetMaxPositiveAuraModifierByMiscMask(AuraType auratype, uint32 misc_
     if (!misc_mask)
         return 0;
 
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue & misc_mask && mod->m_amount > modifier)
-            modifier = mod->m_amount;
-    }
-
-    return modifier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_MISC_MASK, int32(misc_mask)).maxPositive;
 }
 
 int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_mask) const
@@ -3748,75 +3696,96 @@ int32 Unit::GetMaxNegativeAuraModifierByMiscMask(AuraType auratype, uint32 misc_
     if (!misc_mask)
         return 0;
 
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue & misc_mask && mod->m_amount < modifier)
-            modifier = mod->m_amount;
-    }
-
-    return modifier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_MISC_MASK, int32(misc_mask)).maxNegative;
 }
 
 int32 Unit::GetTotalAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue == misc_value)
-            modifier += mod->m_amount;
-    }
-    return modifier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_MISC_VALUE, misc_value).total;
 }
 
 float Unit::GetTotalAuraMultiplierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    float multiplier = 1.0f;
-
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
-    {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue == misc_value)
-            multiplier *= (100.0f + mod->m_amount) / 100.0f;
-    }
-    return multiplier;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_MISC_VALUE, misc_value).multiplier;
 }
 
 int32 Unit::GetMaxPositiveAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
 {
-    int32 modifier = 0;
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_MISC_VALUE, misc_value).maxPositive;
+}
 
-    AuraList const& mTotalAuraList = GetAurasByType(auratype);
-    for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
+int32 Unit::GetMaxNegativeAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
+{
+    return GetAuraModifierTotals(auratype, AURA_MODIFIER_FILTER_MISC_VALUE, misc_value).maxNegative;
+}
+
+Unit::AuraModifierTotals Unit::GetAuraModifierTotals(AuraType auratype, AuraModifierFilter filter, int32 misc) const
+{
+    uint32 cacheMode = sWorld.getConfig(CONFIG_UINT32_AURA_MODIFIER_CACHE);
+
+    // nothing to cache for the usual empty list
+    if (!cacheMode || m_modAuras[auratype].empty())
+        return CalculateAuraModifierTotals(auratype, filter, misc);
+
+    uint64 key = (uint64(filter) << 32) | uint32(misc);
+    AuraModifierTotalsList& cached = m_auraModifierCache[auratype];
+    for (AuraModifierTotalsList::iterator itr = cached.begin(); itr != cached.end(); ++itr)
     {
-        Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue == misc_value && mod->m_amount > modifier)
-            modifier = mod->m_amount;
+        if (itr->first != key)
+            continue;
+
+        if (cacheMode > 1)                                  // debug mode, compare with the list
+        {
+            AuraModifierTotals totals = CalculateAuraModifierTotals(auratype, filter, misc);
+            if (!(totals == itr->second))
+            {
+                sLog.outError("Unit::GetAuraModifierTotals: cached totals of aura type %u (filter %u, misc %i) on %s do not match its auras (total %i/%i, multiplier %f/%f, max positive %i/%i, max negative %i/%i)",
+                              auratype, filter, misc, GetGuidStr().c_str(), itr->second.total, totals.total, itr->second.multiplier, totals.multiplier,
+                              itr->second.maxPositive, totals.maxPositive, itr->second.maxNegative, totals.maxNegative);
+                itr->second = totals;
+            }
+        }
+
+        return itr->second;
     }
 
-    return modifier;
+    AuraModifierTotals totals = CalculateAuraModifierTotals(auratype, filter, misc);
+    cached.push_back(AuraModifierTotalsList::value_type(key, totals));
+    return totals;
 }
 
-int32 Unit::GetMaxNegativeAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const
+Unit::AuraModifierTotals Unit::CalculateAuraModifierTotals(AuraType auratype, AuraModifierFilter filter, int32 misc) const
 {
-    int32 modifier = 0;
+    AuraModifierTotals totals;
 
     AuraList const& mTotalAuraList = GetAurasByType(auratype);
     for (AuraList::const_iterator i = mTotalAuraList.begin(); i != mTotalAuraList.end(); ++i)
     {
         Modifier* mod = (*i)->GetModifier();
-        if (mod->m_miscvalue == misc_value && mod->m_amount < modifier)
-            modifier = mod->m_amount;
+
+        switch (filter)
+        {
+            case AURA_MODIFIER_FILTER_MISC_MASK:
+                if (!(mod->m_miscvalue & misc))
+                    continue;
+                break;
+            case AURA_MODIFIER_FILTER_MISC_VALUE:
+                if (mod->m_miscvalue != misc)
+                    continue;
+                break;
+            default:
+                break;
+        }
+
+        totals.total += mod->m_amount;
+        totals.multiplier *= (100.0f + mod->m_amount) / 100.0f;
+        if (mod->m_amount > totals.maxPositive)
+            totals.maxPositive = mod->m_amount;
+        if (mod->m_amount < totals.maxNegative)
+            totals.maxNegative = mod->m_amount;
     }
 
-    return modifier;
+    return totals;
 }
 
 bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
@@ -3983,7 +3952,10 @@ bool Unit::AddSpellAuraHolder(SpellAuraHolder* holder)
 void Unit::AddAuraToModList(Aura* aura)
 {
     if (aura->GetModifier()->m_auraname < TOTAL_AURAS)
+    {
         m_modAuras[aura->GetModifier()->m_auraname].push_back(aura);
+        InvalidateAuraModifierCache(aura->GetModifier()->m_auraname);
+    }
 }
 
 void Unit::RemoveRankAurasDueToSpell(uint32 spellId)
@@ -4501,6 +4473,7 @@ void Unit::RemoveAura(Aura* Aur, AuraRemoveMode mode)
     if (Aur->GetModifier()->m_auraname < TOTAL_AURAS)
     {
         m_modAuras[Aur->GetModifier()->m_auraname].remove(Aur);
+        InvalidateAuraModifierCache(Aur->GetModifier()->m_auraname);
     }
 
     // Set remove mode
@@ -9685,7 +9658,7 @@ class RelocationNotifyEvent : public BasicEvent
 void Unit::ScheduleAINotify(uint32 delay)
 {
     if (!IsAINotifyScheduled())
-        m_Events.AddEvent(new RelocationNotifyEvent(*this), m_Events.CalculateTime(delay));
+        m_Events.AddEvent(m_Events.MakeEvent<RelocationNotifyEvent>(*this), m_Events.CalculateTime(delay));
 }
 
 void Unit::OnRelocated()
@@ -1885,6 +1885,9 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         int32 GetMaxPositiveAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const;
         int32 GetMaxNegativeAuraModifierByMiscValue(AuraType auratype, int32 misc_value) const;
 
+        // must be called whenever an aura of this type is added, removed or its modifier changes
+        void InvalidateAuraModifierCache(AuraType auratype) { m_auraModifierCache.erase(auratype); }
+
         Aura* GetDummyAura(uint32 spell_id) const;
 
         uint32 m_AuraFlags;
@@ -2149,6 +2152,36 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         CombatData* m_combatData;
 
     private:
+        enum AuraModifierFilter
+        {
+            AURA_MODIFIER_FILTER_NONE,
+            AURA_MODIFIER_FILTER_MISC_MASK,
+            AURA_MODIFIER_FILTER_MISC_VALUE,
+        };
+
+        // results of all GetTotalAuraModifier kinds, calculated in one walk over the aura list
+        struct AuraModifierTotals
+        {
+            AuraModifierTotals() : total(0), multiplier(1.0f), maxPositive(0), maxNegative(0) {}
+
+            bool operator==(AuraModifierTotals const& other) const
+            {
+                return total == other.total && multiplier == other.multiplier && maxPositive == other.maxPositive && maxNegative == other.maxNegative;
+            }
+
+            int32 total;
+            float multiplier;
+            int32 maxPositive;
+            int32 maxNegative;
+        };
+
+        // per aura type: totals by filter and misc value (filter in the high, misc in the low 32 bits of the key)
+        typedef std::vector<std::pair<uint64, AuraModifierTotals> > AuraModifierTotalsList;
+        typedef std::unordered_map<uint32, AuraModifierTotalsList> AuraModifierCache;
+
+        AuraModifierTotals GetAuraModifierTotals(AuraType auratype, AuraModifierFilter filter, int32 misc) const;
+        AuraModifierTotals CalculateAuraModifierTotals(AuraType auratype, AuraModifierFilter filter, int32 misc) const;
+
         void CleanupDeletedAuras();
         void UpdateSplineMovement(uint32 t_diff);
 
@@ -2158,6 +2191,8 @@ class MANGOS_DLL_SPEC Unit : public WorldObject
         // Wrapper called by DealDamage when a creature is killed
         void JustKilledCreature(Creature* victim, Player* responsiblePlayer);
 
+        mutable AuraModifierCache m_auraModifierCache;      // filled on demand by GetAuraModifierTotals, see Aura.ModifierCache config
+
         uint32 m_state;                                     // Even derived shouldn't modify
         uint32 m_CombatTimer;
         bool   m_dummyCombatState;                          // Used to keep combat state during some aura
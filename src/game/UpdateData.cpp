@@ -24,8 +24,13 @@
 #include "Opcodes.h"
 #include "World.h"
 #include "ObjectGuid.h"
+#include "TSS.h"
 #include <zlib/zlib.h>
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
 UpdateData::UpdateData() : m_blockCount(0)
 {
 }
@@ -46,60 +51,198 @@ void UpdateData::AddUpdateBlock(const ByteBuffer& block)
     ++m_blockCount;
 }
 
-void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+void UpdateData::AddUpdateBlock(const ByteBuffer& block, UpdateBlockPatches const& patches)
 {
-    z_stream c_stream;
+    size_t pos = m_data.wpos();
+    m_data.append(block);
 
-    c_stream.zalloc = (alloc_func)nullptr;
-    c_stream.zfree = (free_func)nullptr;
-    c_stream.opaque = (voidpf)nullptr;
+    for (UpdateBlockPatches::const_iterator itr = patches.begin(); itr != patches.end(); ++itr)
+        m_data.put<uint32>(pos + itr->first, itr->second);
 
-    // default Z_BEST_SPEED (1)
-    int z_res = deflateInit(&c_stream, sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
-    if (z_res != Z_OK)
-    {
-        sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
+    ++m_blockCount;
+}
+
+// deflate stream kept alive per thread, avoids allocating the zlib state for every update packet
+class UpdateCompressor
+{
+    public:
+        UpdateCompressor() : m_level(-1)
+        {
+            m_stream.zalloc = (alloc_func)nullptr;
+            m_stream.zfree = (free_func)nullptr;
+            m_stream.opaque = (voidpf)nullptr;
+        }
+
+        ~UpdateCompressor()
+        {
+            if (m_level >= 0)
+                deflateEnd(&m_stream);
+        }
+
+        z_stream* GetStream(int level)
+        {
+            if (m_level == level)
+            {
+                int z_res = deflateReset(&m_stream);
+                if (z_res == Z_OK)
+                    return &m_stream;
+
+                sLog.outError("Can't compress update packet (zlib: deflateReset) Error code: %i (%s)", z_res, zError(z_res));
+            }
+
+            // first use at this thread or compression level changed at config reload
+            if (m_level >= 0)
+            {
+                deflateEnd(&m_stream);
+                m_level = -1;
+            }
+
+            int z_res = deflateInit(&m_stream, level);
+            if (z_res != Z_OK)
+            {
+                sLog.outError("Can't compress update packet (zlib: deflateInit) Error code: %i (%s)", z_res, zError(z_res));
+                return nullptr;
+            }
+
+            m_level = level;
+            return &m_stream;
+        }
+
+    private:
+        z_stream m_stream;
+        int m_level;
+};
+
+static MaNGOS::thread_local_ptr<UpdateCompressor> updateCompressor;
+
+// packets recorded for BenchmarkCompression
+static std::vector<std::vector<uint8> > recordedPackets;
+static std::atomic<uint32> packetsToRecord(0);
+static std::mutex recordedPacketsLock;
+
+static void RecordPacket(uint8 const* data, size_t size)
+{
+    std::lock_guard<std::mutex> guard(recordedPacketsLock);
+    if (!packetsToRecord.load(std::memory_order_relaxed))
         return;
-    }
 
-    c_stream.next_out = (Bytef*)dst;
-    c_stream.avail_out = *dst_size;
-    c_stream.next_in = (Bytef*)src;
-    c_stream.avail_in = (uInt)src_size;
+    recordedPackets.push_back(std::vector<uint8>(data, data + size));
+    packetsToRecord.store(packetsToRecord.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+}
+
+static void Deflate(z_stream* c_stream, void* dst, uint32* dst_size, void* src, int src_size)
+{
+    c_stream->next_out = (Bytef*)dst;
+    c_stream->avail_out = *dst_size;
+    c_stream->next_in = (Bytef*)src;
+    c_stream->avail_in = (uInt)src_size;
 
-    z_res = deflate(&c_stream, Z_NO_FLUSH);
-    if (z_res != Z_OK)
+    // whole input and enough output space (compressBound) are provided, so single call finishes the stream
+    int z_res = deflate(c_stream, Z_FINISH);
+    if (z_res != Z_STREAM_END)
     {
-        sLog.outError("Can't compress update packet (zlib: deflate) Error code: %i (%s)", z_res, zError(z_res));
+        sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
         *dst_size = 0;
         return;
     }
 
-    if (c_stream.avail_in != 0)
+    *dst_size = c_stream->total_out;
+}
+
+void UpdateData::Compress(void* dst, uint32* dst_size, void* src, int src_size)
+{
+    // default Z_BEST_SPEED (1)
+    z_stream* c_stream = updateCompressor->GetStream(sWorld.getConfig(CONFIG_UINT32_COMPRESSION));
+    if (!c_stream)
     {
-        sLog.outError("Can't compress update packet (zlib: deflate not greedy)");
         *dst_size = 0;
         return;
     }
 
-    z_res = deflate(&c_stream, Z_FINISH);
-    if (z_res != Z_STREAM_END)
+    Deflate(c_stream, dst, dst_size, src, src_size);
+}
+
+void UpdateData::RecordCompression(uint32 count)
+{
+    std::lock_guard<std::mutex> guard(recordedPacketsLock);
+    recordedPackets.clear();
+    recordedPackets.reserve(count);
+    packetsToRecord.store(count, std::memory_order_relaxed);
+}
+
+uint32 UpdateData::GetRecordedCompressionCount()
+{
+    std::lock_guard<std::mutex> guard(recordedPacketsLock);
+    return recordedPackets.size();
+}
+
+bool UpdateData::BenchmarkCompression(uint32 iterations, UpdateCompressionBenchmark& result)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    std::vector<std::vector<uint8> > packets;
     {
-        sLog.outError("Can't compress update packet (zlib: deflate should report Z_STREAM_END instead %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        std::lock_guard<std::mutex> guard(recordedPacketsLock);
+        packets = recordedPackets;
     }
 
-    z_res = deflateEnd(&c_stream);
-    if (z_res != Z_OK)
+    if (packets.empty() || !iterations)
+        return false;
+
+    int level = sWorld.getConfig(CONFIG_UINT32_COMPRESSION);
+    result = UpdateCompressionBenchmark();
+    result.packets = packets.size();
+
+    std::vector<uint8> initOut;
+    std::vector<uint8> reuseOut;
+    UpdateCompressor compressor;                            // own stream, the thread's one stays untouched
+
+    for (uint32 i = 0; i < iterations; ++i)
     {
-        sLog.outError("Can't compress update packet (zlib: deflateEnd) Error code: %i (%s)", z_res, zError(z_res));
-        *dst_size = 0;
-        return;
+        for (std::vector<std::vector<uint8> >::iterator itr = packets.begin(); itr != packets.end(); ++itr)
+        {
+            uint32 initSize = compressBound(itr->size());
+            initOut.resize(initSize);
+
+            // previous code: complete deflate state allocated and freed for the packet
+            Clock::time_point start = Clock::now();
+            z_stream c_stream;
+            c_stream.zalloc = (alloc_func)nullptr;
+            c_stream.zfree = (free_func)nullptr;
+            c_stream.opaque = (voidpf)nullptr;
+            if (deflateInit(&c_stream, level) != Z_OK)
+                return false;
+            Deflate(&c_stream, &initOut[0], &initSize, &(*itr)[0], itr->size());
+            deflateEnd(&c_stream);
+            Clock::time_point initEnd = Clock::now();
+
+            uint32 reuseSize = compressBound(itr->size());
+            reuseOut.resize(reuseSize);
+
+            z_stream* stream = compressor.GetStream(level);
+            if (!stream)
+                return false;
+            Deflate(stream, &reuseOut[0], &reuseSize, &(*itr)[0], itr->size());
+            Clock::time_point reuseEnd = Clock::now();
+
+            uint64 initTime = std::chrono::duration_cast<std::chrono::nanoseconds>(initEnd - start).count();
+            uint64 reuseTime = std::chrono::duration_cast<std::chrono::nanoseconds>(reuseEnd - initEnd).count();
+            result.initTime += initTime;
+            result.reuseTime += reuseTime;
+            result.initMaxTime = std::max(result.initMaxTime, initTime);
+            result.reuseMaxTime = std::max(result.reuseMaxTime, reuseTime);
+
+            if (i == 0)
+            {
+                result.bytesIn += itr->size();
+                result.bytesOut += reuseSize;
+                if (initSize != reuseSize || memcmp(&initOut[0], &reuseOut[0], reuseSize) != 0)
+                    ++result.mismatches;
+            }
+        }
     }
 
-    *dst_size = c_stream.total_out;
+    return true;
 }
 
 bool UpdateData::BuildPacket(WorldPacket& packet, bool hasTransport)
@@ -124,8 +267,11 @@ bool UpdateData::BuildPacket(WorldPacket& packet, bool hasTransport)
 
     size_t pSize = buf.wpos();                              // use real used data size
 
-    if (pSize > 100)                                        // compress large packets
+    if (pSize > sWorld.getConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD)) // compress large packets
     {
+        if (packetsToRecord.load(std::memory_order_relaxed))
+            RecordPacket(buf.contents(), pSize);
+
         uint32 destsize = compressBound(pSize);
         packet.resize(destsize + sizeof(uint32));
 
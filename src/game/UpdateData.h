@@ -47,6 +47,23 @@ enum ObjectUpdateFlags
     UPDATEFLAG_HAS_POSITION = 0x0040
 };
 
+// block position and value to overwrite in a shared update block
+typedef std::vector<std::pair<size_t, uint32> > UpdateBlockPatches;
+
+struct UpdateCompressionBenchmark
+{
+    UpdateCompressionBenchmark() : packets(0), bytesIn(0), bytesOut(0), mismatches(0), initTime(0), reuseTime(0), initMaxTime(0), reuseMaxTime(0) {}
+
+    uint32 packets;
+    uint64 bytesIn;                                         // per iteration
+    uint64 bytesOut;
+    uint32 mismatches;                                      // packets compressed differently by the two ways
+    uint64 initTime;                                        // ns, deflateInit and deflateEnd for every packet
+    uint64 reuseTime;                                       // ns, per thread stream rewound with deflateReset
+    uint64 initMaxTime;                                     // ns, slowest single packet
+    uint64 reuseMaxTime;
+};
+
 class UpdateData
 {
     public:
@@ -55,12 +72,19 @@ class UpdateData
         void AddOutOfRangeGUID(GuidSet& guids);
         void AddOutOfRangeGUID(ObjectGuid const& guid);
         void AddUpdateBlock(const ByteBuffer& block);
+        void AddUpdateBlock(const ByteBuffer& block, UpdateBlockPatches const& patches);
         bool BuildPacket(WorldPacket& packet, bool hasTransport = false);
         bool HasData() const { return m_blockCount > 0 || !m_outOfRangeGUIDs.empty(); }
         void Clear();
 
         GuidSet const& GetOutOfRangeGUIDs() const { return m_outOfRangeGUIDs; }
 
+        // compression benchmark: record the next count packets above Compression.Threshold, then
+        // compress them iterations times with a new deflate state per packet and with a reused stream
+        static void RecordCompression(uint32 count);
+        static uint32 GetRecordedCompressionCount();
+        static bool BenchmarkCompression(uint32 iterations, UpdateCompressionBenchmark& result);
+
     protected:
         uint32 m_blockCount;
         GuidSet m_outOfRangeGUIDs;
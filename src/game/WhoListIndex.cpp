@@ -0,0 +1,107 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "WhoListIndex.h"
+#include "ObjectAccessor.h"
+#include "GuildMgr.h"
+#include "Player.h"
+#include "World.h"
+#include "Util.h"
+#include "Timer.h"
+
+#include <algorithm>
+
+INSTANTIATE_SINGLETON_1(WhoListIndex);
+
+void WhoListIndex::Update()
+{
+    uint32 now = WorldTimer::getMSTime();
+    if (m_built && WorldTimer::getMSTimeDiff(m_buildTime, now) < sWorld.getConfig(CONFIG_UINT32_WHO_LIST_UPDATE_INTERVAL))
+        return;
+
+    Rebuild();
+
+    m_buildTime = now;
+    m_built = true;
+}
+
+void WhoListIndex::Clear()
+{
+    for (uint32 i = 0; i < PVP_TEAM_COUNT; ++i)
+    {
+        m_players[i].clear();
+        m_zonePlayers[i].clear();
+    }
+}
+
+bool WhoListIndex::AddPlayer(Team team, PlayerInfo& info)
+{
+    // same as a failed conversion in the query, such players never match
+    if (!Utf8toWStr(info.name, info.wideName) || !Utf8toWStr(info.guildName, info.wideGuildName))
+        return false;
+
+    wstrToLower(info.wideName);
+    wstrToLower(info.wideGuildName);
+
+    m_players[GetIndex(team)].push_back(info);
+    return true;
+}
+
+void WhoListIndex::Finish()
+{
+    for (uint32 i = 0; i < PVP_TEAM_COUNT; ++i)
+    {
+        std::sort(m_players[i].begin(), m_players[i].end(), [](PlayerInfo const& a, PlayerInfo const& b) { return a.level < b.level; });
+
+        for (uint32 j = 0; j < m_players[i].size(); ++j)
+            m_zonePlayers[i][m_players[i][j].zoneId].push_back(j);
+    }
+}
+
+void WhoListIndex::Rebuild()
+{
+    Clear();
+
+    {
+        HashMapHolder<Player>::ReadGuard guard(HashMapHolder<Player>::GetLock());
+        HashMapHolder<Player>::MapType const& players = sObjectAccessor.GetPlayers();
+        for (HashMapHolder<Player>::MapType::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+        {
+            Player* pl = itr->second;
+
+            // do not process players which are not in world
+            if (!pl->IsInWorld())
+                continue;
+
+            PlayerInfo info;
+            info.guid = pl->GetObjectGuid();
+            info.security = pl->GetSession()->GetSecurity();
+            info.visibility = pl->GetVisibility();
+            info.level = pl->getLevel();
+            info.class_ = pl->getClass();
+            info.race = pl->getRace();
+            info.zoneId = pl->GetZoneId();
+            info.name = pl->GetName();
+            info.guildName = sGuildMgr.GetGuildNameById(pl->GetGuildId());
+
+            AddPlayer(pl->GetTeam(), info);
+        }
+    }
+
+    Finish();
+}
@@ -0,0 +1,134 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WHOLISTINDEX_H
+#define MANGOS_WHOLISTINDEX_H
+
+#include "Common.h"
+#include "SharedDefines.h"
+#include "ObjectGuid.h"
+#include "Policies/Singleton.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Snapshot of the online players for /who queries.
+ *
+ * The players of each team are kept sorted by level with an additional zone index, names and
+ * guild names are already converted to lowered wide strings. A query only visits the players
+ * of the requested team(s) in its level range or zones instead of converting the names of all
+ * online players for every CMSG_WHO.
+ *
+ * The snapshot is rebuilt by the first query after WhoList.UpdateInterval ran out (0: for every
+ * query), in the world thread like all CMSG_WHO handling.
+ */
+class WhoListIndex
+{
+    public:
+        struct PlayerInfo
+        {
+            ObjectGuid guid;
+            uint32 security;
+            uint32 visibility;                              // UnitVisibility
+            uint32 level;
+            uint32 class_;
+            uint32 race;
+            uint32 zoneId;
+            std::string name;
+            std::string guildName;
+            std::wstring wideName;                          // lowered
+            std::wstring wideGuildName;                     // lowered
+        };
+
+        typedef std::vector<PlayerInfo> PlayerInfoList;
+
+        WhoListIndex() : m_buildTime(0), m_built(false) {}
+
+        void Update();
+
+        // filling by hand, for snapshots of other sources than the online players like in .debug whobench
+        void Clear();
+        bool AddPlayer(Team team, PlayerInfo& info);        // fills the wide names, false if name or guild name are not valid UTF-8
+        void Finish();                                      // sorts by level and builds the zone index
+
+        // calls func(PlayerInfo const&) for the players of the team in the level range, only these in zoneIds if not empty
+        template<typename Func>
+        void VisitCandidates(Team team, uint32 levelMin, uint32 levelMax, std::vector<uint32> const& zoneIds, Func const& func) const;
+
+    private:
+        typedef std::unordered_map<uint32, std::vector<uint32> > ZonePlayersMap; // zone id -> indexes in PlayerInfoList
+
+        void Rebuild();
+
+        static uint32 GetIndex(Team team) { return team == ALLIANCE ? TEAM_INDEX_ALLIANCE : TEAM_INDEX_HORDE; }
+
+        PlayerInfoList m_players[PVP_TEAM_COUNT];           // sorted by level
+        ZonePlayersMap m_zonePlayers[PVP_TEAM_COUNT];
+        uint32 m_buildTime;
+        bool m_built;
+};
+
+template<typename Func>
+void WhoListIndex::VisitCandidates(Team team, uint32 levelMin, uint32 levelMax, std::vector<uint32> const& zoneIds, Func const& func) const
+{
+    PlayerInfoList const& players = m_players[GetIndex(team)];
+
+    if (zoneIds.empty())
+    {
+        PlayerInfoList::const_iterator itr = players.begin();
+        // binary search for the first player of the level range
+        size_t count = players.size();
+        while (count > 0)
+        {
+            size_t step = count / 2;
+            if ((itr + step)->level < levelMin)
+            {
+                itr += step + 1;
+                count -= step + 1;
+            }
+            else
+                count = step;
+        }
+
+        for (; itr != players.end() && itr->level <= levelMax; ++itr)
+            func(*itr);
+
+        return;
+    }
+
+    ZonePlayersMap const& zonePlayers = m_zonePlayers[GetIndex(team)];
+    for (std::vector<uint32>::const_iterator zoneItr = zoneIds.begin(); zoneItr != zoneIds.end(); ++zoneItr)
+    {
+        ZonePlayersMap::const_iterator found = zonePlayers.find(*zoneItr);
+        if (found == zonePlayers.end())
+            continue;
+
+        for (std::vector<uint32>::const_iterator itr = found->second.begin(); itr != found->second.end(); ++itr)
+        {
+            PlayerInfo const& info = players[*itr];
+            if (info.level >= levelMin && info.level <= levelMax)
+                func(info);
+        }
+    }
+}
+
+#define sWhoListIndex MaNGOS::Singleton<WhoListIndex>::Instance()
+
+#endif
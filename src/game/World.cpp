@@ -62,6 +62,8 @@
 #include "CharacterDatabaseCleaner.h"
 #include "CreatureLinkingMgr.h"
 #include "Weather.h"
+#include "WorldLoader.h"
+#include "OpcodeProfiler.h"
 
 #include <algorithm>
 #include <mutex>
@@ -452,10 +454,14 @@ void World::LoadConfigSettings(bool reload)
 
     ///- Read other configuration items from the config file
     setConfigMinMax(CONFIG_UINT32_COMPRESSION, "Compression", 1, 1, 9);
+    setConfig(CONFIG_UINT32_COMPRESSION_THRESHOLD, "Compression.Threshold", 100);
     setConfig(CONFIG_BOOL_ADDON_CHANNEL, "AddonChannel", true);
     setConfig(CONFIG_BOOL_CLEAN_CHARACTER_DB, "CleanCharacterDB", true);
     setConfig(CONFIG_BOOL_GRID_UNLOAD, "GridUnload", true);
+    setConfig(CONFIG_BOOL_GRIDMAP_MEMORY_MAPPED, "GridMap.MemoryMapped", false);
     setConfig(CONFIG_UINT32_MAX_WHOLIST_RETURNS, "MaxWhoListReturns", 49);
+    setConfig(CONFIG_UINT32_WHO_LIST_UPDATE_INTERVAL, "WhoList.UpdateInterval", 1000);
+    setConfig(CONFIG_UINT32_WHO_LIST_MIN_QUERY_DELAY, "WhoList.MinQueryDelay", 0);
 
     std::string forceLoadGridOnMaps = sConfig.GetStringDefault("LoadAllGridsOnMaps");
     if (!forceLoadGridOnMaps.empty())
@@ -479,6 +485,19 @@ void World::LoadConfigSettings(bool reload)
     if (reload)
         sMapMgr.SetMapUpdateInterval(getConfig(CONFIG_UINT32_INTERVAL_MAPUPDATE));
 
+    setConfig(CONFIG_UINT32_MAPUPDATE_THREADS, "MapUpdate.Threads", 0);
+    if (reload)
+        sMapMgr.SetMapUpdateThreads(getConfig(CONFIG_UINT32_MAPUPDATE_THREADS));
+
+    setConfig(CONFIG_UINT32_WORLD_LOAD_THREADS, "WorldLoad.Threads", 0);
+
+    setConfig(CONFIG_UINT32_GRID_PREFETCH_THREADS, "GridPrefetch.Threads", 0);
+    if (reload)
+        sTerrainMgr.SetPrefetchThreads(getConfig(CONFIG_UINT32_GRID_PREFETCH_THREADS));
+    setConfigPos(CONFIG_FLOAT_GRID_PREFETCH_DISTANCE, "GridPrefetch.Distance", 250.0f);
+
+    setConfigMinMax(CONFIG_UINT32_AURA_MODIFIER_CACHE, "Aura.ModifierCache", 0, 0, 2);
+
     setConfig(CONFIG_UINT32_INTERVAL_CHANGEWEATHER, "ChangeWeatherInterval", 10 * MINUTE * IN_MILLISECONDS);
 
     if (configNoReload(reload, CONFIG_UINT32_PORT_WORLD, "WorldServerPort", DEFAULT_WORLDSERVER_PORT))
@@ -665,6 +684,15 @@ void World::LoadConfigSettings(bool reload)
     setConfig(CONFIG_BOOL_OUTDOORPVP_EP_ENABLED,                       "OutdoorPvp.EPEnabled", true);
 
     setConfig(CONFIG_BOOL_KICK_PLAYER_ON_BAD_PACKET, "Network.KickOnBadPacket", false);
+    setConfigMinMax(CONFIG_UINT32_NETWORK_FLUSH_MODE, "Network.FlushMode", 0, 0, 1);
+    setConfig(CONFIG_UINT32_NETWORK_FLUSH_DELAY, "Network.FlushDelay", 50000);
+    setConfig(CONFIG_UINT32_NETWORK_FLUSH_BYTES, "Network.FlushBytes", 0);
+
+    MaNGOS::Socket::SetFlushPolicy(getConfig(CONFIG_UINT32_NETWORK_FLUSH_MODE) ? MaNGOS::FlushMode::WorldTick : MaNGOS::FlushMode::Timer,
+                                   getConfig(CONFIG_UINT32_NETWORK_FLUSH_DELAY), getConfig(CONFIG_UINT32_NETWORK_FLUSH_BYTES));
+
+    setConfig(CONFIG_BOOL_NETWORK_OPCODE_PROFILER, "Network.OpcodeProfiler", false);
+    sOpcodeProfiler.SetEnabled(getConfig(CONFIG_BOOL_NETWORK_OPCODE_PROFILER));
 
     setConfig(CONFIG_BOOL_PLAYER_COMMANDS, "PlayerCommands", true);
 
@@ -777,8 +805,10 @@ void World::LoadConfigSettings(bool reload)
     }
 
     setConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK, "vmap.enableIndoorCheck", true);
+    setConfig(CONFIG_BOOL_VMAP_LOS_CACHE, "vmap.losCache", true);
     bool enableLOS = sConfig.GetBoolDefault("vmap.enableLOS", false);
     bool enableHeight = sConfig.GetBoolDefault("vmap.enableHeight", false);
+    bool enablePackedTriangles = sConfig.GetBoolDefault("vmap.packedTriangles", true);
     std::string ignoreSpellIds = sConfig.GetStringDefault("vmap.ignoreSpellIds");
 
     if (!enableHeight)
@@ -786,15 +816,20 @@ void World::LoadConfigSettings(bool reload)
 
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableLineOfSightCalc(enableLOS);
     VMAP::VMapFactory::createOrGetVMapManager()->setEnableHeightCalc(enableHeight);
+    VMAP::VMapFactory::createOrGetVMapManager()->setEnablePackedTriangles(enablePackedTriangles);
     VMAP::VMapFactory::preventSpellsFromBeingTestedForLoS(ignoreSpellIds.c_str());
-    sLog.outString("WORLD: VMap support included. LineOfSight:%i, getHeight:%i, indoorCheck:%i",
-                   enableLOS, enableHeight, getConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK) ? 1 : 0);
+    sLog.outString("WORLD: VMap support included. LineOfSight:%i, getHeight:%i, indoorCheck:%i, packedTriangles:%i",
+                   enableLOS, enableHeight, getConfig(CONFIG_BOOL_VMAP_INDOOR_CHECK) ? 1 : 0, enablePackedTriangles);
     sLog.outString("WORLD: VMap data directory is: %svmaps", m_dataPath.c_str());
 
     setConfig(CONFIG_BOOL_MMAP_ENABLED, "mmap.enabled", true);
     std::string ignoreMapIds = sConfig.GetStringDefault("mmap.ignoreMapIds");
     MMAP::MMapFactory::preventPathfindingOnMaps(ignoreMapIds.c_str());
     sLog.outString("WORLD: MMap pathfinding %sabled", getConfig(CONFIG_BOOL_MMAP_ENABLED) ? "en" : "dis");
+    setConfig(CONFIG_UINT32_MMAP_PATH_CACHE_TIME, "mmap.pathCacheTime", 2000);
+    setConfig(CONFIG_UINT32_MMAP_PATH_THREADS, "mmap.pathThreads", 0);
+    if (reload)
+        sMapMgr.SetPathFinderThreads(getConfig(CONFIG_UINT32_MMAP_PATH_THREADS));
 
     sLog.outString();
 }
@@ -1114,62 +1149,102 @@ void World::SetInitialWorldSettings()
     sLog.outString("Loading GameTeleports...");
     sObjectMgr.LoadGameTele();
 
+    ///- Load localization, dynamic data and script tables, independent stages optionally in parallel
+    WorldLoader loader(getConfig(CONFIG_UINT32_WORLD_LOAD_THREADS));
+
     ///- Loading localization data
-    sLog.outString("Loading Localization strings...");
-    sObjectMgr.LoadCreatureLocales();                       // must be after CreatureInfo loading
-    sObjectMgr.LoadGameObjectLocales();                     // must be after GameobjectInfo loading
-    sObjectMgr.LoadItemLocales();                           // must be after ItemPrototypes loading
-    sObjectMgr.LoadQuestLocales();                          // must be after QuestTemplates loading
-    sObjectMgr.LoadGossipTextLocales();                     // must be after LoadGossipText
-    sObjectMgr.LoadPageTextLocales();                       // must be after PageText loading
-    sObjectMgr.LoadGossipMenuItemsLocales();                // must be after gossip menu items loading
-    sObjectMgr.LoadPointOfInterestLocales();                // must be after POI loading
-    sLog.outString(">>> Localization strings loaded");
-    sLog.outString();
+    uint32 localesStage = loader.AddStage("Localization strings", []()
+    {
+        sLog.outString("Loading Localization strings...");
+        sObjectMgr.LoadCreatureLocales();                   // must be after CreatureInfo loading
+        sObjectMgr.LoadGameObjectLocales();                 // must be after GameobjectInfo loading
+        sObjectMgr.LoadItemLocales();                       // must be after ItemPrototypes loading
+        sObjectMgr.LoadQuestLocales();                      // must be after QuestTemplates loading
+        sObjectMgr.LoadGossipTextLocales();                 // must be after LoadGossipText
+        sObjectMgr.LoadPageTextLocales();                   // must be after PageText loading
+        sObjectMgr.LoadGossipMenuItemsLocales();            // must be after gossip menu items loading
+        sObjectMgr.LoadPointOfInterestLocales();            // must be after POI loading
+        sLog.outString(">>> Localization strings loaded");
+        sLog.outString();
+    });
 
     ///- Load dynamic data tables from the database
-    sLog.outString("Loading Auctions...");
-    sAuctionMgr.LoadAuctionItems();
-    sAuctionMgr.LoadAuctions();
-    sLog.outString(">>> Auctions loaded");
-    sLog.outString();
+    loader.AddStage("Auctions", []()
+    {
+        sLog.outString("Loading Auctions...");
+        sAuctionMgr.LoadAuctionItems();
+        sAuctionMgr.LoadAuctions();
+        sLog.outString(">>> Auctions loaded");
+        sLog.outString();
+    });
 
-    sLog.outString("Loading Guilds...");
-    sGuildMgr.LoadGuilds();
+    loader.AddStage("Guilds", []()
+    {
+        sLog.outString("Loading Guilds...");
+        sGuildMgr.LoadGuilds();
+    });
 
-    sLog.outString("Loading Groups...");
-    sObjectMgr.LoadGroups();
+    loader.AddStage("Groups", []()
+    {
+        sLog.outString("Loading Groups...");
+        sObjectMgr.LoadGroups();
+    });
 
-    sLog.outString("Returning old mails...");
-    sObjectMgr.ReturnOrDeleteOldMails(false);
+    loader.AddStage("Returning old mails", []()
+    {
+        sLog.outString("Returning old mails...");
+        sObjectMgr.ReturnOrDeleteOldMails(false);
+    });
 
-    sLog.outString("Loading GM tickets...");
-    sTicketMgr.LoadGMTickets();
+    loader.AddStage("GM tickets", []()
+    {
+        sLog.outString("Loading GM tickets...");
+        sTicketMgr.LoadGMTickets();
+    });
 
     ///- Load and initialize DBScripts Engine
-    sLog.outString("Loading DB-Scripts Engine...");
-    sScriptMgr.LoadQuestStartScripts();                     // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadQuestEndScripts();                       // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
-    sScriptMgr.LoadSpellScripts();                          // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadGameObjectScripts();                     // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadGameObjectTemplateScripts();             // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadEventScripts();                          // must be after load Creature/Gameobject(Template/Data)
-    sScriptMgr.LoadCreatureDeathScripts();                  // must be after load Creature/Gameobject(Template/Data)
-    sLog.outString(">>> Scripts loaded");
-    sLog.outString();
-
-    sLog.outString("Loading Scripts text locales...");      // must be after Load*Scripts calls
-    sScriptMgr.LoadDbScriptStrings();
+    uint32 scriptsStage = loader.AddStage("DB-Scripts Engine", []()
+    {
+        sLog.outString("Loading DB-Scripts Engine...");
+        sScriptMgr.LoadQuestStartScripts();                 // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+        sScriptMgr.LoadQuestEndScripts();                   // must be after load Creature/Gameobject(Template/Data) and QuestTemplate
+        sScriptMgr.LoadSpellScripts();                      // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadGameObjectScripts();                 // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadGameObjectTemplateScripts();         // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadEventScripts();                      // must be after load Creature/Gameobject(Template/Data)
+        sScriptMgr.LoadCreatureDeathScripts();              // must be after load Creature/Gameobject(Template/Data)
+        sLog.outString(">>> Scripts loaded");
+        sLog.outString();
+    });
+
+    // mangos string tables share the locale index with the localization strings
+    uint32 scriptStringsStage = loader.AddStage("Scripts text locales", []()
+    {
+        sLog.outString("Loading Scripts text locales...");  // must be after Load*Scripts calls
+        sScriptMgr.LoadDbScriptStrings();
+    }, { localesStage, scriptsStage });
 
     ///- Load and initialize EventAI Scripts
-    sLog.outString("Loading CreatureEventAI Texts...");
-    sEventAIMgr.LoadCreatureEventAI_Texts(false);           // false, will checked in LoadCreatureEventAI_Scripts
+    uint32 eventAITextsStage = loader.AddStage("CreatureEventAI Texts", []()
+    {
+        sLog.outString("Loading CreatureEventAI Texts...");
+        sEventAIMgr.LoadCreatureEventAI_Texts(false);       // false, will checked in LoadCreatureEventAI_Scripts
+    }, { scriptStringsStage });
+
+    uint32 eventAISummonsStage = loader.AddStage("CreatureEventAI Summons", []()
+    {
+        sLog.outString("Loading CreatureEventAI Summons...");
+        sEventAIMgr.LoadCreatureEventAI_Summons(false);     // false, will checked in LoadCreatureEventAI_Scripts
+    }, { eventAITextsStage });
 
-    sLog.outString("Loading CreatureEventAI Summons...");
-    sEventAIMgr.LoadCreatureEventAI_Summons(false);         // false, will checked in LoadCreatureEventAI_Scripts
+    loader.AddStage("CreatureEventAI Scripts", []()
+    {
+        sLog.outString("Loading CreatureEventAI Scripts...");
+        sEventAIMgr.LoadCreatureEventAI_Scripts();
+    }, { eventAITextsStage, eventAISummonsStage });
 
-    sLog.outString("Loading CreatureEventAI Scripts...");
-    sEventAIMgr.LoadCreatureEventAI_Scripts();
+    loader.Load();
+    loader.LogLoadTimes();
 
     ///- Load and initialize scripting library
     sLog.outString("Initializing Scripting Library...");
@@ -1230,6 +1305,7 @@ void World::SetInitialWorldSettings()
     ///- Initialize MapManager
     sLog.outString("Starting Map System");
     sMapMgr.Initialize();
+    sTerrainMgr.SetPrefetchThreads(getConfig(CONFIG_UINT32_GRID_PREFETCH_THREADS));
     sLog.outString();
 
     ///- Initialize Battlegrounds
@@ -1451,6 +1527,9 @@ void World::Update(uint32 diff)
 
     // cleanup unused GridMap objects as well as VMaps
     sTerrainMgr.Update(diff);
+
+    // send the output of this tick if sockets wait for the tick end (Network.FlushMode)
+    MaNGOS::Socket::FlushPendingWrites();
 }
 
 namespace MaNGOS
@@ -1522,13 +1601,15 @@ void World::SendWorldText(int32 string_id, ...)
 /// Sends a packet to all players with optional team and instance restrictions
 void World::SendGlobalMessage(WorldPacket const& packet) const
 {
+    PacketBroadcaster broadcaster(packet);
+
     for (SessionMap::const_iterator itr = m_sessions.cbegin(); itr != m_sessions.cend(); ++itr)
     {
         if (WorldSession* session = itr->second)
         {
             Player* player = session->GetPlayer();
             if (player && player->IsInWorld())
-                session->SendPacket(packet);
+                broadcaster.SendTo(session);
         }
     }
 }
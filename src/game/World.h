@@ -82,9 +82,17 @@ enum WorldTimers
 enum eConfigUInt32Values
 {
     CONFIG_UINT32_COMPRESSION = 0,
+    CONFIG_UINT32_COMPRESSION_THRESHOLD,
     CONFIG_UINT32_INTERVAL_SAVE,
     CONFIG_UINT32_INTERVAL_GRIDCLEAN,
     CONFIG_UINT32_INTERVAL_MAPUPDATE,
+    CONFIG_UINT32_MAPUPDATE_THREADS,
+    CONFIG_UINT32_WORLD_LOAD_THREADS,
+    CONFIG_UINT32_GRID_PREFETCH_THREADS,
+    CONFIG_UINT32_NETWORK_FLUSH_MODE,
+    CONFIG_UINT32_NETWORK_FLUSH_DELAY,
+    CONFIG_UINT32_NETWORK_FLUSH_BYTES,
+    CONFIG_UINT32_AURA_MODIFIER_CACHE,
     CONFIG_UINT32_INTERVAL_CHANGEWEATHER,
     CONFIG_UINT32_PORT_WORLD,
     CONFIG_UINT32_GAME_TYPE,
@@ -174,6 +182,10 @@ enum eConfigUInt32Values
     CONFIG_UINT32_GUID_RESERVE_SIZE_GAMEOBJECT,
     CONFIG_UINT32_CREATURE_RESPAWN_AGGRO_DELAY,
     CONFIG_UINT32_MAX_WHOLIST_RETURNS,
+    CONFIG_UINT32_WHO_LIST_UPDATE_INTERVAL,
+    CONFIG_UINT32_WHO_LIST_MIN_QUERY_DELAY,
+    CONFIG_UINT32_MMAP_PATH_CACHE_TIME,
+    CONFIG_UINT32_MMAP_PATH_THREADS,
     CONFIG_UINT32_VALUE_COUNT
 };
 
@@ -259,6 +271,7 @@ enum eConfigFloatValues
     CONFIG_FLOAT_THREAT_RADIUS,
     CONFIG_FLOAT_GHOST_RUN_SPEED_WORLD,
     CONFIG_FLOAT_GHOST_RUN_SPEED_BG,
+    CONFIG_FLOAT_GRID_PREFETCH_DISTANCE,
     CONFIG_FLOAT_VALUE_COUNT
 };
 
@@ -266,6 +279,7 @@ enum eConfigFloatValues
 enum eConfigBoolValues
 {
     CONFIG_BOOL_GRID_UNLOAD = 0,
+    CONFIG_BOOL_GRIDMAP_MEMORY_MAPPED,
     CONFIG_BOOL_SAVE_RESPAWN_TIME_IMMEDIATELY,
     CONFIG_BOOL_ALLOW_TWO_SIDE_ACCOUNTS,
     CONFIG_BOOL_ALLOW_TWO_SIDE_INTERACTION_CHAT,
@@ -311,9 +325,11 @@ enum eConfigBoolValues
     CONFIG_BOOL_STATS_SAVE_ONLY_ON_LOGOUT,
     CONFIG_BOOL_CLEAN_CHARACTER_DB,
     CONFIG_BOOL_VMAP_INDOOR_CHECK,
+    CONFIG_BOOL_VMAP_LOS_CACHE,
     CONFIG_BOOL_PET_UNSUMMON_AT_MOUNT,
     CONFIG_BOOL_MMAP_ENABLED,
     CONFIG_BOOL_PLAYER_COMMANDS,
+    CONFIG_BOOL_NETWORK_OPCODE_PROFILER,
     CONFIG_BOOL_VALUE_COUNT
 };
 
@@ -0,0 +1,162 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "WorldLoader.h"
+#include "Timer.h"
+#include "ProgressBar.h"
+#include "Database/DatabaseEnv.h"
+
+#include <thread>
+
+uint32 WorldLoader::AddStage(char const* name, LoadFunction const& func, StageList const& dependsOn)
+{
+    uint32 id = m_stages.size();
+
+    for (StageList::const_iterator itr = dependsOn.begin(); itr != dependsOn.end(); ++itr)
+        MANGOS_ASSERT(*itr < id);                           // only earlier stages, keeps declaration order a valid load order
+
+    m_stages.push_back(Stage(name, func, dependsOn));
+    return id;
+}
+
+void WorldLoader::Load()
+{
+    uint32 startTime = WorldTimer::getMSTime();
+
+    if (!m_numThreads)
+    {
+        for (std::vector<Stage>::iterator itr = m_stages.begin(); itr != m_stages.end(); ++itr)
+            LoadStage(*itr);
+
+        m_loadTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+        return;
+    }
+
+    // progress bars of concurrent stages would overwrite each other
+    bool showProgress = BarGoLink::GetOutputState();
+    BarGoLink::SetOutputState(false);
+
+    std::vector<std::thread> workers;
+    for (uint32 i = 0; i < m_numThreads; ++i)
+        workers.push_back(std::thread(&WorldLoader::WorkerThread, this));
+
+    // print held back output strictly in declaration order
+    while (m_nextOutput < m_stages.size())
+    {
+        Stage* stage = &m_stages[m_nextOutput];
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [stage] { return stage->loaded; });
+        }
+
+        sLog.Replay(stage->output);
+        stage->output.clear();
+        ++m_nextOutput;
+    }
+
+    for (std::vector<std::thread>::iterator itr = workers.begin(); itr != workers.end(); ++itr)
+        itr->join();
+
+    BarGoLink::SetOutputState(showProgress);
+
+    m_loadTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+}
+
+void WorldLoader::LogLoadTimes() const
+{
+    sLog.outString("World load stage times (%u load threads):", m_numThreads);
+
+    uint32 sum = 0;
+    for (std::vector<Stage>::const_iterator itr = m_stages.begin(); itr != m_stages.end(); ++itr)
+    {
+        sLog.outString("  %-36s %6u ms", itr->name.c_str(), itr->loadTime);
+        sum += itr->loadTime;
+    }
+
+    sLog.outString(">> %u stages loaded in %u ms (%u ms if loaded serially)", uint32(m_stages.size()), m_loadTime, sum);
+    sLog.outString();
+}
+
+void WorldLoader::LoadStage(Stage& stage)
+{
+    uint32 startTime = WorldTimer::getMSTime();
+    stage.func();
+    stage.loadTime = WorldTimer::getMSTimeDiff(startTime, WorldTimer::getMSTime());
+}
+
+void WorldLoader::WorkerThread()
+{
+    WorldDatabase.ThreadStart();                            // let thread do safe mySQL requests (one connection call enough)
+
+    for (;;)
+    {
+        Stage* stage = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this, &stage] { return (stage = SelectStage()) || AllStarted(); });
+        }
+
+        if (!stage)                                         // nothing left to start
+            break;
+
+        sLog.BeginCapture();
+        LoadStage(*stage);
+        sLog.EndCapture(stage->output);
+
+        {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            stage->loaded = true;
+        }
+        m_condition.notify_all();
+    }
+
+    WorldDatabase.ThreadEnd();                              // free mySQL thread resources
+}
+
+bool WorldLoader::IsReady(Stage const& stage) const
+{
+    for (StageList::const_iterator itr = stage.dependsOn.begin(); itr != stage.dependsOn.end(); ++itr)
+        if (!m_stages[*itr].loaded)
+            return false;
+
+    return true;
+}
+
+WorldLoader::Stage* WorldLoader::SelectStage()
+{
+    // lowest declared ready stage first, keeps the output queue moving
+    for (std::vector<Stage>::iterator itr = m_stages.begin(); itr != m_stages.end(); ++itr)
+    {
+        if (itr->started || !IsReady(*itr))
+            continue;
+
+        itr->started = true;
+        return &*itr;
+    }
+
+    return nullptr;
+}
+
+bool WorldLoader::AllStarted() const
+{
+    for (std::vector<Stage>::const_iterator itr = m_stages.begin(); itr != m_stages.end(); ++itr)
+        if (!itr->started)
+            return false;
+
+    return true;
+}
@@ -0,0 +1,91 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WORLDLOADER_H
+#define MANGOS_WORLDLOADER_H
+
+#include "Common.h"
+#include "Log.h"
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+/**
+ * Runs a list of startup load stages, optionally on worker threads.
+ *
+ * Stages are added in the order they would be loaded serially and may only depend on stages
+ * added before them, so the declaration order is always a valid load order. With no worker
+ * threads every stage runs in the calling thread exactly as the plain load sequence did.
+ *
+ * With worker threads every stage whose dependencies are loaded can run at the same time.
+ * Each worker has its own mySQL thread context and takes a query connection from the pool
+ * per query, so raising WorldDatabaseConnections/CharacterDatabaseConnections lets loads
+ * really overlap. Log output of a stage is held back and printed in declaration order once
+ * all earlier stages are printed, so console output and DB error reports do not depend on
+ * thread timing.
+ *
+ * Stages without a dependency on each other must not write shared containers (ObjectMgr
+ * locale index, mangos string maps, ...); declare a dependency instead.
+ */
+class WorldLoader
+{
+    public:
+        typedef std::function<void()> LoadFunction;
+        typedef std::vector<uint32> StageList;
+
+        explicit WorldLoader(uint32 numThreads) : m_numThreads(numThreads), m_nextOutput(0), m_loadTime(0) {}
+
+        // returns stage id for use in dependency lists of later stages
+        uint32 AddStage(char const* name, LoadFunction const& func, StageList const& dependsOn = StageList());
+
+        void Load();
+        void LogLoadTimes() const;
+
+    private:
+        struct Stage
+        {
+            Stage(char const* _name, LoadFunction const& _func, StageList const& _dependsOn)
+                : name(_name), func(_func), dependsOn(_dependsOn), loadTime(0), started(false), loaded(false) {}
+
+            std::string name;
+            LoadFunction func;
+            StageList dependsOn;
+            LogCaptureBuffer output;                        // held back log output of the stage
+            uint32 loadTime;                                // in milliseconds
+            bool started;
+            bool loaded;
+        };
+
+        void LoadStage(Stage& stage);
+        void WorkerThread();
+        bool IsReady(Stage const& stage) const;
+        Stage* SelectStage();                               // must be called with m_mutex locked
+        bool AllStarted() const;                            // must be called with m_mutex locked
+
+        std::vector<Stage> m_stages;
+        uint32 m_numThreads;
+        uint32 m_nextOutput;                                // first stage whose output is not printed yet
+        uint32 m_loadTime;
+
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+};
+
+#endif
@@ -0,0 +1,139 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "WorldPacketPool.h"
+#include "WorldPacket.h"
+#include "TSS.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+    // storage reserved for new packets of each size class, client packets are at most 0x2800 bytes
+    size_t const SizeClasses[] = { 64, 256, 1024, 0x2800 };
+    uint32 const NumSizeClasses = sizeof(SizeClasses) / sizeof(SizeClasses[0]);
+
+    size_t const ThreadListSize = 128;                      // free packets kept per size class and thread
+    size_t const TransferSize = ThreadListSize / 2;         // packets moved between a thread list and the shared list at once
+    size_t const SharedListSize = 1024;                     // free packets kept per size class for all threads
+
+    typedef std::vector<WorldPacket*> PacketList;
+
+    struct FreeLists
+    {
+        FreeLists()
+        {
+            for (uint32 i = 0; i < NumSizeClasses; ++i)
+                lists[i].reserve(ThreadListSize + 1);
+        }
+
+        ~FreeLists()
+        {
+            for (uint32 i = 0; i < NumSizeClasses; ++i)
+                for (PacketList::const_iterator itr = lists[i].begin(); itr != lists[i].end(); ++itr)
+                    delete *itr;
+        }
+
+        PacketList lists[NumSizeClasses];
+    };
+
+    MaNGOS::thread_local_ptr<FreeLists> threadLists;
+
+    FreeLists sharedLists;
+    std::mutex sharedListsLock;
+
+    // smallest size class with room for size bytes, NumSizeClasses if there is none
+    uint32 GetSizeClassForSize(size_t size)
+    {
+        for (uint32 i = 0; i < NumSizeClasses; ++i)
+            if (size <= SizeClasses[i])
+                return i;
+
+        return NumSizeClasses;
+    }
+
+    // largest size class a packet with this capacity can serve, NumSizeClasses if there is none
+    uint32 GetSizeClassForCapacity(size_t capacity)
+    {
+        if (capacity < SizeClasses[0] || capacity > SizeClasses[NumSizeClasses - 1])
+            return NumSizeClasses;
+
+        uint32 sizeClass = 0;
+        while (sizeClass + 1 < NumSizeClasses && SizeClasses[sizeClass + 1] <= capacity)
+            ++sizeClass;
+
+        return sizeClass;
+    }
+}
+
+WorldPacketPool::PacketPtr WorldPacketPool::Acquire(uint16 opcode, size_t size)
+{
+    uint32 sizeClass = GetSizeClassForSize(size);
+    if (sizeClass == NumSizeClasses)
+        return PacketPtr(new WorldPacket(opcode, size));
+
+    PacketList& list = threadLists->lists[sizeClass];
+    if (list.empty())
+    {
+        // take a batch of packets released by other threads
+        std::lock_guard<std::mutex> guard(sharedListsLock);
+        PacketList& shared = sharedLists.lists[sizeClass];
+        size_t count = std::min(shared.size(), TransferSize);
+        list.insert(list.end(), shared.end() - count, shared.end());
+        shared.resize(shared.size() - count);
+    }
+
+    if (list.empty())
+        return PacketPtr(new WorldPacket(opcode, SizeClasses[sizeClass]));
+
+    WorldPacket* packet = list.back();
+    list.pop_back();
+
+    packet->Initialize(opcode, size);                       // keeps the storage, only resets positions
+    return PacketPtr(packet);
+}
+
+void WorldPacketPool::Release(WorldPacket* packet)
+{
+    uint32 sizeClass = GetSizeClassForCapacity(packet->capacity());
+    if (sizeClass == NumSizeClasses)
+    {
+        delete packet;
+        return;
+    }
+
+    PacketList& list = threadLists->lists[sizeClass];
+    list.push_back(packet);
+
+    if (list.size() <= ThreadListSize)
+        return;
+
+    // hand a batch over to the other threads, mostly from the session update to the network threads
+    std::lock_guard<std::mutex> guard(sharedListsLock);
+    PacketList& shared = sharedLists.lists[sizeClass];
+    shared.insert(shared.end(), list.end() - TransferSize, list.end());
+    list.resize(list.size() - TransferSize);
+
+    while (shared.size() > SharedListSize)
+    {
+        delete shared.back();
+        shared.pop_back();
+    }
+}
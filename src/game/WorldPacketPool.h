@@ -0,0 +1,61 @@
+/*
+ * This file is part of the Everwar Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MANGOS_WORLDPACKETPOOL_H
+#define MANGOS_WORLDPACKETPOOL_H
+
+#include "Common.h"
+
+#include <memory>
+
+class WorldPacket;
+
+/**
+ * Recycles the client packets built by WorldSocket::ProcessIncomingData.
+ *
+ * Before, every client packet cost a WorldPacket and a storage allocation sized to its payload,
+ * freed again by the session update right after the handler ran. Released packets keep their
+ * storage and are sorted into size classes by capacity, so the next packet of that size reuses
+ * both allocations.
+ *
+ * Every thread has its own free lists, so network threads take packets and map/world threads
+ * return them without locking. Only when a thread list runs empty or over its limit a batch of
+ * packets is moved from/to a shared list under a mutex, which is how packets released by the
+ * session update travel back to the network threads.
+ *
+ * Any packet created with new may be released here, packets larger than the biggest size class
+ * are just deleted.
+ */
+class WorldPacketPool
+{
+    public:
+        struct Recycler
+        {
+            void operator()(WorldPacket* packet) const { WorldPacketPool::Release(packet); }
+        };
+
+        typedef std::unique_ptr<WorldPacket, Recycler> PacketPtr;
+
+        // empty packet with at least size bytes reserved
+        static PacketPtr Acquire(uint16 opcode, size_t size);
+        static void Release(WorldPacket* packet);
+};
+
+typedef WorldPacketPool::PacketPtr PooledWorldPacket;
+
+#endif
@@ -37,6 +37,7 @@
 #include "BattleGround/BattleGroundMgr.h"
 #include "SocialMgr.h"
 #include "LootMgr.h"
+#include "OpcodeProfiler.h"
 
 #include <mutex>
 #include <deque>
@@ -93,7 +94,7 @@ WorldSession::WorldSession(uint32 id, WorldSocket* sock, AccountTypes sec, time_
     _player(nullptr), m_Socket(sock ? sock->shared<WorldSocket>() : nullptr), _security(sec), _accountId(id), _logoutTime(0),
     m_inQueue(false), m_playerLoading(false), m_playerLogout(false), m_playerRecentlyLogout(false), m_playerSave(false),
     m_sessionDbcLocale(sWorld.GetAvailableDbcLocale(locale)), m_sessionDbLocaleIndex(sObjectMgr.GetIndexForLocale(locale)),
-    m_latency(0), m_clientTimeDelay(0), m_tutorialState(TUTORIALDATA_UNCHANGED) {}
+    m_latency(0), m_clientTimeDelay(0), m_whoQueryTime(0), m_tutorialState(TUTORIALDATA_UNCHANGED) {}
 
 /// WorldSession destructor
 WorldSession::~WorldSession()
@@ -122,6 +123,23 @@ char const* WorldSession::GetPlayerName() const
 
 /// Send a packet to the client
 void WorldSession::SendPacket(WorldPacket const& packet) const
+{
+    if (!PrepareSendPacket(packet))
+        return;
+
+    m_Socket->SendPacket(packet);
+}
+
+/// Send a packet shared with other sessions to the client
+void WorldSession::SendPacket(SharedWorldPacket const& packet) const
+{
+    if (!PrepareSendPacket(*packet))
+        return;
+
+    m_Socket->SendPacket(packet);
+}
+
+bool WorldSession::PrepareSendPacket(WorldPacket const& packet) const
 {
     // Playerbot mod: send packet to bot AI
     if (GetPlayer()) {
@@ -132,10 +150,13 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
     }
 
     if (!m_Socket)
-        return;
+        return false;
 
     if (m_Socket->IsClosed())
-        return;
+        return false;
+
+    if (sOpcodeProfiler.IsEnabled())
+        sOpcodeProfiler.AddThreadBytesSent(packet.size());
 
 #ifdef MANGOS_DEBUG
 
@@ -173,14 +194,33 @@ void WorldSession::SendPacket(WorldPacket const& packet) const
 
 #endif                                                  // !MANGOS_DEBUG
 
-    m_Socket->SendPacket(packet);
+    return true;
+}
+
+void PacketBroadcaster::SendTo(WorldSession* session)
+{
+    if (!m_recipients++ || m_packet.size() < MaNGOS::Socket::SharedPayloadMinSize)
+    {
+        session->SendPacket(m_packet);
+        return;
+    }
+
+    if (!m_shared)
+        m_shared = std::make_shared<WorldPacket>(m_packet);
+
+    session->SendPacket(m_shared);
 }
 
 /// Add an incoming packet to the queue
+void WorldSession::QueuePacket(PooledWorldPacket new_packet)
+{
+    m_recvQueue.Enqueue(std::move(new_packet));
+}
+
+/// Add an incoming packet built outside of the socket (playerbots), the pool accepts any packet
 void WorldSession::QueuePacket(std::unique_ptr<WorldPacket> new_packet)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
-    m_recvQueue.push_back(std::move(new_packet));
+    QueuePacket(PooledWorldPacket(new_packet.release()));
 }
 
 /// Logging helper for unexpected opcodes
@@ -204,14 +244,13 @@ void WorldSession::LogUnprocessedTail(WorldPacket const& packet) const
 /// Update the WorldSession (triggered by World update)
 bool WorldSession::Update(PacketFilter& updater)
 {
-    std::lock_guard<std::mutex> guard(m_recvQueueLock);
-
     ///- Retrieve packets from the receive queue and call the appropriate handlers
     /// not process packets if socket already closed
-    while (m_Socket && !m_Socket->IsClosed() && !m_recvQueue.empty())
+    /// stop at the first packet the updater does not allow here, it is processed later in its own context
+    PooledWorldPacket packet;
+    while (m_Socket && !m_Socket->IsClosed() &&
+            m_recvQueue.DequeueIf(packet, [&updater](PooledWorldPacket const& front) { return updater.Process(*front); }))
     {
-        auto const packet = std::move(m_recvQueue.front());
-        m_recvQueue.pop_front();
 
         /*#if 1
         sLog.outError( "MOEP: %s (0x%.4X)",
@@ -323,12 +362,17 @@ bool WorldSession::Update(PacketFilter& updater)
                 botPlayer->GetPlayerbotAI()->HandleTeleportAck();
             else if (botPlayer->IsInWorld())
             {
-                std::for_each(pBotWorldSession->m_recvQueue.begin(), pBotWorldSession->m_recvQueue.end(), [&pBotWorldSession](std::unique_ptr<WorldPacket>& packet)
+                // only packets queued before, handlers may queue new ones for the next update
+                std::vector<PooledWorldPacket> botPackets;
+                PooledWorldPacket botPacket;
+                while (pBotWorldSession->m_recvQueue.Dequeue(botPacket))
+                    botPackets.push_back(std::move(botPacket));
+
+                for (std::vector<PooledWorldPacket>::const_iterator packetItr = botPackets.begin(); packetItr != botPackets.end(); ++packetItr)
                 {
-                    OpcodeHandler const& opHandle = opcodeTable[packet->GetOpcode()];
-                    (pBotWorldSession->*opHandle.handler)(*packet);
-                });
-                pBotWorldSession->m_recvQueue.clear();
+                    OpcodeHandler const& opHandle = opcodeTable[(*packetItr)->GetOpcode()];
+                    (pBotWorldSession->*opHandle.handler)(**packetItr);
+                }
             }
         }
     }
@@ -748,7 +792,19 @@ void WorldSession::ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket &pac
     if (_player)
         _player->SetCanDelayTeleport(true);
 
-    (this->*opHandle.handler)(packet);
+    if (sOpcodeProfiler.IsEnabled())
+    {
+        uint16 opcode = packet.GetOpcode();
+        size_t bytesIn = packet.size();
+        uint64 bytesSent = sOpcodeProfiler.GetThreadBytesSent();
+        OpcodeProfiler::Clock::time_point start = OpcodeProfiler::Clock::now();
+
+        (this->*opHandle.handler)(packet);
+
+        sOpcodeProfiler.Record(opcode, OpcodeProfiler::Clock::now() - start, bytesIn, sOpcodeProfiler.GetThreadBytesSent() - bytesSent);
+    }
+    else
+        (this->*opHandle.handler)(packet);
 
     if (_player)
     {
@@ -29,8 +29,9 @@
 #include "AuctionHouseMgr.h"
 #include "Item.h"
 #include "WorldSocket.h"
+#include "WorldPacketPool.h"
+#include "Utilities/MPSCQueue.h"
 
-#include <deque>
 #include <mutex>
 #include <memory>
 
@@ -134,6 +135,7 @@ class MANGOS_DLL_SPEC WorldSession
         void SizeError(WorldPacket const& packet, uint32 size) const;
 
         void SendPacket(WorldPacket const& packet) const;
+        void SendPacket(SharedWorldPacket const& packet) const;
         void SendNotification(const char* format, ...) const ATTR_PRINTF(2, 3);
         void SendNotification(int32 string_id, ...) const;
         void SendPetNameInvalid(uint32 error, const std::string& name) const;
@@ -149,6 +151,7 @@ class MANGOS_DLL_SPEC WorldSession
         void SetSecurity(AccountTypes security) { _security = security; }
         //PlayerBot mod: player connected without socket are bot
         const std::string GetRemoteAddress() const { return m_Socket ? m_Socket->GetRemoteAddress() : "bot"; }
+        MaNGOS::FlushLatencyHistogram const* GetFlushLatency() const { return m_Socket ? &m_Socket->GetFlushLatency() : nullptr; }
         void SetPlayer(Player* plr) { _player = plr; }
 
         /// Session in auth.queue currently
@@ -172,6 +175,7 @@ class MANGOS_DLL_SPEC WorldSession
         void LogoutPlayer(bool save);
         void KickPlayer();
 
+        void QueuePacket(PooledWorldPacket new_packet);
         void QueuePacket(std::unique_ptr<WorldPacket> new_packet);
 
         bool Update(PacketFilter& updater);
@@ -652,6 +656,8 @@ class MANGOS_DLL_SPEC WorldSession
         void HandleMoverRelocation(MovementInfo& movementInfo);
 
         void ExecuteOpcode(OpcodeHandler const& opHandle, WorldPacket& packet);
+        // playerbot hooks and statistics of an outgoing packet, false if there is no socket to send to
+        bool PrepareSendPacket(WorldPacket const& packet) const;
 
         // logging helper
         void LogUnexpectedOpcode(WorldPacket const& packet, const char* reason) const;
@@ -676,11 +682,33 @@ class MANGOS_DLL_SPEC WorldSession
         int m_sessionDbLocaleIndex;
         uint32 m_latency;
         uint32 m_clientTimeDelay;
+        uint32 m_whoQueryTime;                              // time of the last answered CMSG_WHO, for WhoList.MinQueryDelay
         uint32 m_Tutorials[8];
         TutorialDataState m_tutorialState;
 
-        std::mutex m_recvQueueLock;
-        std::deque<std::unique_ptr<WorldPacket>> m_recvQueue;
+        // filled by the network thread (and PlayerbotAI for bot sessions), drained by WorldSession::Update
+        MPSCQueue<PooledWorldPacket> m_recvQueue;
+};
+
+/**
+ * Sends one packet to many sessions (channels, groups, guilds, battlegrounds, visibility broadcasts).
+ *
+ * The first recipient gets the packet as it is. For the others the packet is copied once into an
+ * immutable SharedWorldPacket and their sockets only queue a reference to it behind their own
+ * encrypted header, so a broadcast no longer copies the payload into every output buffer.
+ * Packets smaller than MaNGOS::Socket::SharedPayloadMinSize are always sent by value.
+ */
+class PacketBroadcaster
+{
+    public:
+        explicit PacketBroadcaster(WorldPacket const& packet) : m_packet(packet), m_recipients(0) {}
+
+        void SendTo(WorldSession* session);
+
+    private:
+        WorldPacket const& m_packet;
+        SharedWorldPacket m_shared;                         // created for the second recipient
+        uint32 m_recipients;
 };
 #endif
 /// @}
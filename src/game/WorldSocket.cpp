@@ -22,6 +22,7 @@
 #include "Util.h"
 #include "World.h"
 #include "WorldPacket.h"
+#include "WorldPacketPool.h"
 #include "SharedDefines.h"
 #include "ByteBuffer.h"
 #include "AddonHandler.h"
@@ -59,14 +60,8 @@ WorldSocket::WorldSocket(boost::asio::io_service &service, std::function<void (S
       m_useExistingHeader(false), m_session(nullptr),m_seed(urand())
 {}
 
-void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
+static ServerPktHeader BuildServerPktHeader(const WorldPacket& pct)
 {
-    if (IsClosed())
-        return;
-
-    // Dump outgoing packet.
-    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
-
     ServerPktHeader header;
 
     header.cmd = pct.GetOpcode();
@@ -75,17 +70,52 @@ void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
     header.size = static_cast<uint16>(pct.size() + 2);
     EndianConvertReverse(header.size);
 
-    m_crypt.EncryptSend(reinterpret_cast<uint8 *>(&header), sizeof(header));
+    return header;
+}
+
+void WorldSocket::SendPacket(const WorldPacket& pct, bool immediate)
+{
+    if (IsClosed())
+        return;
+
+    // Dump outgoing packet.
+    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct.GetOpcode(), pct.GetOpcodeName(), pct, false);
 
-    Write(reinterpret_cast<const char *>(&header), sizeof(header));
+    ServerPktHeader header = BuildServerPktHeader(pct);
 
-    if (!!pct.size())
-        Write(reinterpret_cast<const char *>(pct.contents()), pct.size());
+    {
+        std::lock_guard<std::mutex> guard(m_sendMutex);
+
+        m_crypt.EncryptSend(reinterpret_cast<uint8 *>(&header), sizeof(header));
+
+        Write(reinterpret_cast<const char *>(&header), sizeof(header),
+              pct.size() ? reinterpret_cast<const char *>(pct.contents()) : nullptr, static_cast<int>(pct.size()));
+    }
 
     if (immediate)
         ForceFlushOut();
 }
 
+void WorldSocket::SendPacket(SharedWorldPacket const& pct)
+{
+    if (IsClosed())
+        return;
+
+    // Dump outgoing packet.
+    sLog.outWorldPacketDump(GetRemoteEndpoint().c_str(), pct->GetOpcode(), pct->GetOpcodeName(), *pct, false);
+
+    ServerPktHeader header = BuildServerPktHeader(*pct);
+
+    // aliasing pointer, the queued payload keeps the whole packet alive
+    SharedPayload payload = pct->size() ? SharedPayload(pct, pct->contents()) : SharedPayload();
+
+    std::lock_guard<std::mutex> guard(m_sendMutex);
+
+    m_crypt.EncryptSend(reinterpret_cast<uint8 *>(&header), sizeof(header));
+
+    Write(reinterpret_cast<const char *>(&header), sizeof(header), payload, pct->size());
+}
+
 bool WorldSocket::Open()
 {
     if (!Socket::Open())
@@ -167,7 +197,7 @@ bool WorldSocket::ProcessIncomingData()
     if (IsClosed())
         return false;
 
-    std::unique_ptr<WorldPacket> pct(new WorldPacket(opcode, validBytesRemaining));
+    PooledWorldPacket pct = WorldPacketPool::Acquire(opcode, validBytesRemaining);
 
     if (validBytesRemaining)
     {
@@ -32,10 +32,15 @@
 
 #include <chrono>
 #include <functional>
+#include <memory>
+#include <mutex>
 
 class WorldPacket;
 class WorldSession;
 
+/// Immutable packet sent to many sessions at once, see PacketBroadcaster
+typedef std::shared_ptr<const WorldPacket> SharedWorldPacket;
+
 /**
  * WorldSocket.
  *
@@ -104,6 +109,9 @@ class WorldSocket : public MaNGOS::Socket
         /// Class used for managing encryption of the headers
         AuthCrypt m_crypt;
 
+        /// Keeps the encrypted headers in the order their packets are queued
+        std::mutex m_sendMutex;
+
         /// Session to which received packets are routed
         WorldSession *m_session;
         bool m_sessionFinalized;
@@ -126,6 +134,8 @@ class WorldSocket : public MaNGOS::Socket
 
         // send a packet \o/
         void SendPacket(const WorldPacket& pct, bool immediate = false);
+        // send a packet shared with other sockets, only the encrypted header is stored per socket
+        void SendPacket(SharedWorldPacket const& pct);
 
         void FinalizeSession() { m_session = nullptr; }
 
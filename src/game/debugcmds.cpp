@@ -28,9 +28,23 @@
 #include "Language.h"
 #include "BattleGround/BattleGroundMgr.h"
 #include <fstream>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include "ObjectMgr.h"
 #include "ObjectGuid.h"
 #include "SpellMgr.h"
+#include "World.h"
+#include "Database/DatabaseEnv.h"
+#include "OpcodeProfiler.h"
+#include "VMapFactory.h"
+#include "UpdateData.h"
+#include "WorldPacketPool.h"
+#include "WhoListIndex.h"
+#include "Util.h"
+#include "Utilities/MPSCQueue.h"
 
 bool ChatHandler::HandleDebugSendSpellFailCommand(char* args)
 {
@@ -199,6 +213,763 @@ bool ChatHandler::HandleDebugSendOpcodeCommand(char* /*args*/)
     return true;
 }
 
+// .debug updatecache, hit rate since start or the last .debug updatecache reset
+bool ChatHandler::HandleDebugUpdateCacheCommand(char* /*args*/)
+{
+    uint64 hits = ValuesUpdateBlockCache::GetHits();
+    uint64 misses = ValuesUpdateBlockCache::GetMisses();
+    uint64 total = hits + misses;
+
+    PSendSysMessage("Values update block cache: " UI64FMTD " hits, " UI64FMTD " misses, hit rate %.1f%%",
+                    hits, misses, total ? hits * 100.0f / total : 0.0f);
+    return true;
+}
+
+// .debug updatecache reset, starts a new measurement, e.g. right before a raid encounter
+bool ChatHandler::HandleDebugUpdateCacheResetCommand(char* /*args*/)
+{
+    ValuesUpdateBlockCache::ResetCounters();
+    SendSysMessage("Values update block cache counters cleared");
+    return true;
+}
+
+static void ShowSqlQueueStats(ChatHandler* handler, char const* name, Database& db)
+{
+    std::vector<SqlDelayThreadStats> stats;
+    db.GetAsyncStats(stats);
+
+    handler->PSendSysMessage("%s database: %u queued async requests", name, db.GetAsyncQueueSize());
+    for (size_t i = 0; i < stats.size(); ++i)
+        handler->PSendSysMessage("  connection " SIZEFMTD ": " UI64FMTD " executed, latency avg " UI64FMTD " us, max " UI64FMTD " us",
+                                 i, stats[i].processed, stats[i].avgLatencyUs, stats[i].maxLatencyUs);
+}
+
+bool ChatHandler::HandleDebugSqlQueueCommand(char* /*args*/)
+{
+    ShowSqlQueueStats(this, "World", WorldDatabase);
+    ShowSqlQueueStats(this, "Character", CharacterDatabase);
+    ShowSqlQueueStats(this, "Login", LoginDatabase);
+    return true;
+}
+
+typedef std::chrono::steady_clock BenchClock;
+
+// time of the rounds of one variant in a .debug xxxbench command
+struct BenchTiming
+{
+    BenchTiming() : rounds(0), totalTime(0), maxTime(0) {}
+
+    void AddRound(BenchClock::time_point start)
+    {
+        uint64 time = std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - start).count();
+        ++rounds;
+        totalTime += time;
+        maxTime = std::max(maxTime, time);
+    }
+
+    std::string Format(char const* name) const
+    {
+        char text[160];
+        snprintf(text, sizeof(text), "  %-24s %10.3f us avg, %10.3f us max, " UI64FMTD " ms total", name,
+                 rounds ? double(totalTime) / rounds / 1000 : 0.0, double(maxTime) / 1000, totalTime / 1000000);
+        return text;
+    }
+
+    uint32 rounds;
+    uint64 totalTime;                                       // ns
+    uint64 maxTime;                                         // ns, slowest round
+};
+
+// times body(round) of both variants round by round, so both see the same caches; stops at the first round returning false
+template<class BodyA, class BodyB>
+static bool TimeBenchRounds(uint32 rounds, BodyA bodyA, BenchTiming& timingA, BodyB bodyB, BenchTiming& timingB)
+{
+    for (uint32 round = 0; round < rounds; ++round)
+    {
+        BenchClock::time_point start = BenchClock::now();
+        if (!bodyA(round))
+            return false;
+        timingA.AddRound(start);
+
+        start = BenchClock::now();
+        if (!bodyB(round))
+            return false;
+        timingB.AddRound(start);
+    }
+
+    return true;
+}
+
+static void ShowBenchTimings(ChatHandler* handler, char const* nameA, BenchTiming const& timingA, char const* nameB, BenchTiming const& timingB)
+{
+    handler->PSendSysMessage("%s", timingA.Format(nameA).c_str());
+    handler->PSendSysMessage("%s", timingB.Format(nameB).c_str());
+}
+
+// limits keep a run within seconds, most bench commands run in the world thread
+static bool CheckBenchLimit(ChatHandler* handler, char const* name, uint32 value, uint32 limit)
+{
+    if (value && value <= limit)
+        return true;
+
+    handler->PSendSysMessage("#%s must be between 1 and %u", name, limit);
+    return false;
+}
+
+// stands in for RelocationNotifyEvent, without the grid visit
+class BenchRelocationEvent : public BasicEvent
+{
+    public:
+        explicit BenchRelocationEvent(bool& scheduled) : m_scheduled(scheduled) { m_scheduled = true; }
+
+        bool Execute(uint64 /*e_time*/, uint32 /*p_time*/) override
+        {
+            m_scheduled = false;
+            return true;
+        }
+
+        void Abort(uint64 /*e_time*/) override { m_scheduled = false; }
+
+    private:
+        bool& m_scheduled;
+};
+
+struct BenchCreature
+{
+    BenchCreature() : aiNotifyScheduled(false) {}
+    ~BenchCreature() { events.KillAllEvents(true); }        // aborting writes aiNotifyScheduled
+
+    EventProcessor events;
+    bool aiNotifyScheduled;
+};
+
+// one tick: each creature moves like Unit::OnRelocated and every tenth one also gets a one shot event like a spell
+static void TickBenchCreatures(std::vector<BenchCreature>& creatures, uint32 tick, bool recycled)
+{
+    uint32 const tickTime = 100;
+
+    for (uint32 i = 0; i < creatures.size(); ++i)
+    {
+        BenchCreature& creature = creatures[i];
+        EventProcessor& events = creature.events;
+
+        if (!creature.aiNotifyScheduled)
+        {
+            BasicEvent* event = recycled ? events.MakeEvent<BenchRelocationEvent>(creature.aiNotifyScheduled) : new BenchRelocationEvent(creature.aiNotifyScheduled);
+            events.AddEvent(event, events.CalculateTime(World::GetRelocationAINotifyDelay()));
+        }
+
+        if ((i + tick) % 10 == 0)
+            events.AddEvent(recycled ? events.MakeEvent<BasicEvent>() : new BasicEvent(), events.CalculateTime(tickTime / 2));
+
+        events.Update(tickTime);
+    }
+}
+
+// .debug eventbench [#creatures [#ticks]], tick the event processors of moving creatures with new and with recycled events
+bool ChatHandler::HandleDebugEventBenchCommand(char* args)
+{
+    uint32 creatureCount, ticks;
+    if (!ExtractOptUInt32(&args, creatureCount, 20000) || !ExtractOptUInt32(&args, ticks, 600))
+        return false;
+
+    if (!CheckBenchLimit(this, "creatures", creatureCount, 100000) || !CheckBenchLimit(this, "ticks", ticks, 1000))
+    {
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::vector<BenchCreature> allocated(creatureCount), recycled(creatureCount);
+    BenchTiming allocatedTiming, recycledTiming;
+    TimeBenchRounds(ticks,
+                    [&allocated](uint32 tick) { TickBenchCreatures(allocated, tick, false); return true; }, allocatedTiming,
+                    [&recycled](uint32 tick) { TickBenchCreatures(recycled, tick, true); return true; }, recycledTiming);
+
+    PSendSysMessage("%u creatures, %u ticks of 100 ms:", creatureCount, ticks);
+    ShowBenchTimings(this, "new events:", allocatedTiming, "recycled events:", recycledTiming);
+    return true;
+}
+
+// inbound session queue as before the lock-free queue: the consumer holds the mutex while handling packets
+class LockedRecvQueue
+{
+    public:
+        void Enqueue(PooledWorldPacket&& packet)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_queue.push_back(std::move(packet));
+        }
+
+        template<class Handler>
+        void Drain(Handler handler)
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            while (!m_queue.empty())
+            {
+                handler(*m_queue.front());
+                m_queue.pop_front();
+            }
+        }
+
+    private:
+        std::mutex m_lock;
+        std::deque<PooledWorldPacket> m_queue;
+};
+
+class LockFreeRecvQueue
+{
+    public:
+        void Enqueue(PooledWorldPacket&& packet) { m_queue.Enqueue(std::move(packet)); }
+
+        template<class Handler>
+        void Drain(Handler handler)
+        {
+            PooledWorldPacket packet;
+            while (m_queue.Dequeue(packet))
+            {
+                handler(*packet);
+                packet.reset();
+            }
+        }
+
+    private:
+        MPSCQueue<PooledWorldPacket> m_queue;
+};
+
+struct RecvQueueStats
+{
+    RecvQueueStats() : enqueueTime(0), maxEnqueueTime(0), checksum(0) {}
+
+    void Add(RecvQueueStats const& other)
+    {
+        enqueueTime += other.enqueueTime;
+        maxEnqueueTime = std::max(maxEnqueueTime, other.maxEnqueueTime);
+        checksum += other.checksum;
+    }
+
+    uint64 enqueueTime;                                     // ns, summed over all producers
+    uint64 maxEnqueueTime;                                  // ns, slowest single enqueue
+    uint64 checksum;
+};
+
+// one round: producer threads stand in for network threads and send one packet to every session,
+// the calling thread updates all sessions like the world thread until it handled all of them
+template<class Queue>
+static bool ReceiveBenchRound(std::vector<Queue>& queues, uint32 round, uint32 producers, RecvQueueStats& stats)
+{
+    uint32 sessions = queues.size();
+    std::vector<RecvQueueStats> producerStats(producers);
+
+    std::vector<std::thread> threads;
+    for (uint32 p = 0; p < producers; ++p)
+    {
+        threads.push_back(std::thread([&queues, &producerStats, sessions, producers, round, p]
+        {
+            RecvQueueStats& producerStat = producerStats[p];
+            for (uint32 s = p; s < sessions; s += producers)
+            {
+                // movement packet sized payload
+                PooledWorldPacket packet = WorldPacketPool::Acquire(MSG_MOVE_HEARTBEAT, 32);
+                *packet << uint32(s) << uint32(round) << uint32(0) << float(0.0f) << float(0.0f) << float(0.0f) << float(0.0f) << uint32(0);
+
+                BenchClock::time_point start = BenchClock::now();
+                queues[s].Enqueue(std::move(packet));
+                uint64 enqueueTime = std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - start).count();
+
+                producerStat.enqueueTime += enqueueTime;
+                producerStat.maxEnqueueTime = std::max(producerStat.maxEnqueueTime, enqueueTime);
+            }
+        }));
+    }
+
+    uint32 handled = 0;
+    while (handled < sessions)
+    {
+        for (typename std::vector<Queue>::iterator itr = queues.begin(); itr != queues.end(); ++itr)
+        {
+            itr->Drain([&stats, &handled](WorldPacket& packet)
+            {
+                // read the payload like a movement handler
+                uint32 session, index;
+                packet >> session >> index;
+                stats.checksum += session + index;
+                ++handled;
+            });
+        }
+    }
+
+    for (std::vector<std::thread>::iterator itr = threads.begin(); itr != threads.end(); ++itr)
+        itr->join();
+
+    for (std::vector<RecvQueueStats>::const_iterator itr = producerStats.begin(); itr != producerStats.end(); ++itr)
+        stats.Add(*itr);
+
+    return true;
+}
+
+// .debug recvqueuebench [#sessions [#packets [#threads]]], stress test of the mutex and the lock-free session packet queue
+bool ChatHandler::HandleDebugRecvQueueBenchCommand(char* args)
+{
+    uint32 sessions, packets, producers;
+    if (!ExtractOptUInt32(&args, sessions, 5000) || !ExtractOptUInt32(&args, packets, 100) || !ExtractOptUInt32(&args, producers, 4))
+        return false;
+
+    if (!CheckBenchLimit(this, "sessions", sessions, 10000) || !CheckBenchLimit(this, "packets", packets, 200) ||
+            !CheckBenchLimit(this, "threads", producers, 16))
+    {
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::vector<LockedRecvQueue> lockedQueues(sessions);
+    std::vector<LockFreeRecvQueue> lockFreeQueues(sessions);
+    RecvQueueStats locked, lockFree;
+    BenchTiming lockedTiming, lockFreeTiming;
+    TimeBenchRounds(packets,
+                    [&](uint32 round) { return ReceiveBenchRound(lockedQueues, round, producers, locked); }, lockedTiming,
+                    [&](uint32 round) { return ReceiveBenchRound(lockFreeQueues, round, producers, lockFree); }, lockFreeTiming);
+
+    uint64 total = uint64(sessions) * packets;
+    PSendSysMessage("%u rounds of one packet to each of %u sessions from %u producer threads:", packets, sessions, producers);
+    ShowBenchTimings(this, "mutex and deque:", lockedTiming, "lock-free:", lockFreeTiming);
+    PSendSysMessage("  enqueue with mutex:  %.3f us avg, %.3f us max", double(locked.enqueueTime) / total / 1000, double(locked.maxEnqueueTime) / 1000);
+    PSendSysMessage("  enqueue lock-free:   %.3f us avg, %.3f us max", double(lockFree.enqueueTime) / total / 1000, double(lockFree.maxEnqueueTime) / 1000);
+    if (locked.checksum != lockFree.checksum)
+        PSendSysMessage("  the two queues delivered different packets!");
+    return true;
+}
+
+struct SqlLoadStats
+{
+    SqlLoadStats() : rows(0), readTime(0), intSum(0), textLength(0) {}
+
+    uint64 rows;
+    uint64 readTime;                                        // ns, reading all fields with the getter of their type
+    uint64 intSum;                                          // both ways must read the same values
+    uint64 textLength;
+};
+
+static bool LoadBenchTable(SqlConnection* conn, std::string const& sql, bool binary, SqlLoadStats& stats)
+{
+    // a shutdown stops the run between rounds
+    if (World::IsStopped())
+        return false;
+
+    QueryResult* result = binary ? conn->QueryOnce(sql) : conn->Query(sql.c_str());
+    if (!result)
+        return false;
+
+    BenchClock::time_point start = BenchClock::now();
+    uint32 fieldCount = result->GetFieldCount();
+    do
+    {
+        Field* fields = result->Fetch();
+        for (uint32 i = 0; i < fieldCount; ++i)
+        {
+            switch (fields[i].GetType())
+            {
+                case Field::DB_TYPE_INTEGER:
+                    stats.intSum += fields[i].GetUInt32();
+                    break;
+                case Field::DB_TYPE_FLOAT:
+                    fields[i].GetFloat();
+                    break;
+                default:
+                    if (char const* text = fields[i].GetString())
+                        stats.textLength += strlen(text);
+                    break;
+            }
+        }
+        ++stats.rows;
+    }
+    while (result->NextRow());
+
+    delete result;
+
+    stats.readTime += std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - start).count();
+    return true;
+}
+
+static std::atomic<bool> s_sqlBenchRunning(false);
+
+// loads with an own connection, the world update and the world database connections are not blocked
+static void SqlBenchThread(uint32 iterations)
+{
+    WorldDatabase.ThreadStart();                            // let thread do safe mySQL requests (one connection call enough)
+
+    if (SqlConnection* conn = WorldDatabase.OpenSeparateConnection())
+    {
+        char const* tables[] = { "creature", "item_template" };
+        for (size_t t = 0; t < countof(tables); ++t)
+        {
+            std::string sql = std::string("SELECT * FROM ") + tables[t];
+
+            SqlLoadStats text, binary;
+            BenchTiming textTiming, binaryTiming;
+            if (!TimeBenchRounds(iterations,
+                                 [&](uint32) { return LoadBenchTable(conn, sql, false, text); }, textTiming,
+                                 [&](uint32) { return LoadBenchTable(conn, sql, true, binary); }, binaryTiming))
+            {
+                sLog.outError(".debug sqlbench: can't load %s", tables[t]);
+                break;
+            }
+
+            sLog.outString(".debug sqlbench: %s, " UI64FMTD " rows x %u iterations, load and read:", tables[t], text.rows / iterations, iterations);
+            sLog.outString("%s", textTiming.Format("text:").c_str());
+            sLog.outString("%s", binaryTiming.Format("binary:").c_str());
+            sLog.outString("  reading fields: text " UI64FMTD " ms, binary " UI64FMTD " ms", text.readTime / 1000000, binary.readTime / 1000000);
+            if (text.intSum != binary.intSum || text.textLength != binary.textLength)
+                sLog.outString("  the two ways read different values!");
+        }
+
+        delete conn;
+    }
+    else
+        sLog.outError(".debug sqlbench: can't connect to the world database");
+
+    WorldDatabase.ThreadEnd();                              // free mySQL thread resources
+    s_sqlBenchRunning = false;
+}
+
+// .debug sqlbench [#iterations], loads creature and item_template as text and as binary result sets
+bool ChatHandler::HandleDebugSqlBenchCommand(char* args)
+{
+    uint32 iterations;
+    if (!ExtractOptUInt32(&args, iterations, 1))
+        return false;
+
+    if (!CheckBenchLimit(this, "iterations", iterations, 10))
+    {
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    if (s_sqlBenchRunning.exchange(true))
+    {
+        SendSysMessage("A .debug sqlbench run is still in progress");
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::thread(&SqlBenchThread, iterations).detach();
+    SendSysMessage("Loading creature and item_template in a separate thread, the results are written to the server log");
+    return true;
+}
+
+struct WhoBenchQuery
+{
+    uint32 levelMin;
+    uint32 levelMax;
+    std::wstring guildName;                                 // lowered, empty for no guild filter
+};
+
+static bool WhoGuildMatches(std::wstring const& wideGuildName, std::wstring const& filter)
+{
+    return filter.empty() || wideGuildName.find(filter) != std::wstring::npos;
+}
+
+// .debug whobench [#queries [#players]], /who level range queries against simulated players with and without WhoListIndex
+bool ChatHandler::HandleDebugWhoBenchCommand(char* args)
+{
+    uint32 queryCount, playerCount;
+    if (!ExtractOptUInt32(&args, queryCount, 1000) || !ExtractOptUInt32(&args, playerCount, 5000))
+        return false;
+
+    if (!CheckBenchLimit(this, "queries", queryCount, 10000) || !CheckBenchLimit(this, "players", playerCount, 50000))
+    {
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    // like the online player map, the former CMSG_WHO handler read name and guild name from here
+    WhoListIndex::PlayerInfoList players(playerCount);
+    WhoListIndex index;
+    for (uint32 i = 0; i < playerCount; ++i)
+    {
+        WhoListIndex::PlayerInfo& info = players[i];
+        info.security = SEC_PLAYER;
+        info.visibility = VISIBILITY_ON;
+        info.level = urand(1, DEFAULT_MAX_LEVEL);
+        info.class_ = CLASS_WARRIOR;
+        info.race = RACE_HUMAN;
+        info.zoneId = urand(1, 100);
+        info.name = "Player" + std::to_string(i);
+        info.guildName = i % 3 ? "Guild Of Player " + std::to_string(i % 200) : "";
+
+        WhoListIndex::PlayerInfo indexed = info;
+        index.AddPlayer(i % 2 ? ALLIANCE : HORDE, indexed);
+    }
+    index.Finish();
+
+    // both teams like two side /who, every fourth query also filters by guild name
+    std::vector<WhoBenchQuery> queries(queryCount);
+    for (uint32 i = 0; i < queryCount; ++i)
+    {
+        queries[i].levelMin = urand(1, DEFAULT_MAX_LEVEL);
+        queries[i].levelMax = queries[i].levelMin + 5;
+        if (i % 4 == 0)
+            Utf8toWStr("guild of player " + std::to_string(urand(0, 199)), queries[i].guildName);
+    }
+
+    uint64 perPlayerMatches = 0;
+    auto perPlayer = [&players, &queries, &perPlayerMatches](uint32 round)
+    {
+        WhoBenchQuery const& query = queries[round];
+        for (WhoListIndex::PlayerInfoList::const_iterator itr = players.begin(); itr != players.end(); ++itr)
+        {
+            if (itr->level < query.levelMin || itr->level > query.levelMax)
+                continue;
+
+            std::wstring wideName;
+            if (!Utf8toWStr(itr->name, wideName))
+                continue;
+            wstrToLower(wideName);
+
+            std::wstring wideGuildName;
+            if (!Utf8toWStr(itr->guildName, wideGuildName))
+                continue;
+            wstrToLower(wideGuildName);
+
+            if (WhoGuildMatches(wideGuildName, query.guildName))
+                ++perPlayerMatches;
+        }
+        return true;
+    };
+
+    uint64 indexedMatches = 0;
+    std::vector<uint32> noZones;
+    auto indexed = [&index, &queries, &indexedMatches, &noZones](uint32 round)
+    {
+        WhoBenchQuery const& query = queries[round];
+        auto checkPlayer = [&indexedMatches, &query](WhoListIndex::PlayerInfo const& info)
+        {
+            if (WhoGuildMatches(info.wideGuildName, query.guildName))
+                ++indexedMatches;
+        };
+
+        index.VisitCandidates(ALLIANCE, query.levelMin, query.levelMax, noZones, checkPlayer);
+        index.VisitCandidates(HORDE, query.levelMin, query.levelMax, noZones, checkPlayer);
+        return true;
+    };
+
+    BenchTiming perPlayerTiming, indexedTiming;
+    TimeBenchRounds(queryCount, perPlayer, perPlayerTiming, indexed, indexedTiming);
+
+    PSendSysMessage("%u /who queries of 6 levels against %u players:", queryCount, playerCount);
+    ShowBenchTimings(this, "per player conversion:", perPlayerTiming, "WhoListIndex:", indexedTiming);
+    if (perPlayerMatches != indexedMatches)
+        PSendSysMessage("  the two ways found different players (" UI64FMTD " and " UI64FMTD ")!", perPlayerMatches, indexedMatches);
+    return true;
+}
+
+static void ShowFlushLatency(ChatHandler* handler, char const* name, MaNGOS::FlushLatencyHistogram const& histogram)
+{
+    uint32 total = histogram.GetTotal();
+    handler->PSendSysMessage("%s: %u output flushes", name, total);
+
+    for (int i = 0; i < MaNGOS::FlushLatencyHistogram::NumBuckets; ++i)
+    {
+        uint32 count = histogram.GetCount(i);
+        float percent = total ? count * 100.0f / total : 0.0f;
+
+        if (uint32 limit = MaNGOS::FlushLatencyHistogram::GetBucketLimit(i))
+            handler->PSendSysMessage("  below %5u us: %u (%.1f%%)", limit, count, percent);
+        else
+            handler->PSendSysMessage("  %u us or more: %u (%.1f%%)", MaNGOS::FlushLatencyHistogram::GetBucketLimit(i - 1), count, percent);
+    }
+}
+
+bool ChatHandler::HandleDebugFlushLatencyCommand(char* /*args*/)
+{
+    ShowFlushLatency(this, "All connections", MaNGOS::Socket::GetTotalFlushLatency());
+
+    if (m_session)
+    {
+        Player* player = getSelectedPlayer();
+        if (MaNGOS::FlushLatencyHistogram const* histogram = player ? player->GetSession()->GetFlushLatency() : nullptr)
+            ShowFlushLatency(this, player->GetName(), *histogram);
+    }
+
+    return true;
+}
+
+// .debug compressbench record [#count], records the next update packets big enough to be compressed
+bool ChatHandler::HandleDebugCompressBenchRecordCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 1000))
+        return false;
+
+    UpdateData::RecordCompression(count);
+    PSendSysMessage("Recording the next %u compressed update packets", count);
+    return true;
+}
+
+// .debug compressbench [#iterations], compresses the recorded packets with a new deflate state per packet and with a reused stream
+bool ChatHandler::HandleDebugCompressBenchCommand(char* args)
+{
+    uint32 iterations;
+    if (!ExtractOptUInt32(&args, iterations, 10))
+        return false;
+
+    if (!CheckBenchLimit(this, "iterations", iterations, 100))
+    {
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    UpdateCompressionBenchmark result;
+    if (!UpdateData::BenchmarkCompression(iterations, result))
+    {
+        PSendSysMessage("No update packets recorded (%u recorded), use .debug compressbench record first", UpdateData::GetRecordedCompressionCount());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    uint64 packets = uint64(result.packets) * iterations;
+    double megabytes = double(result.bytesIn) * iterations / (1024 * 1024);
+    PSendSysMessage("%u recorded packets, " UI64FMTD " bytes compressed to " UI64FMTD " x %u iterations:", result.packets, result.bytesIn, result.bytesOut, iterations);
+    PSendSysMessage("  new state per packet: %.3f us avg, %.3f us max, %.1f MB/s",
+                    double(result.initTime) / packets / 1000, double(result.initMaxTime) / 1000, megabytes * 1e9 / std::max<uint64>(result.initTime, 1));
+    PSendSysMessage("  reused stream:        %.3f us avg, %.3f us max, %.1f MB/s",
+                    double(result.reuseTime) / packets / 1000, double(result.reuseMaxTime) / 1000, megabytes * 1e9 / std::max<uint64>(result.reuseTime, 1));
+    if (result.mismatches)
+        PSendSysMessage("  %u packets differ between the two!", result.mismatches);
+    return true;
+}
+
+// .debug losbench record [#count], records the next static line of sight queries of all maps
+bool ChatHandler::HandleDebugLosBenchRecordCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 10000))
+        return false;
+
+    VMAP::VMapFactory::createOrGetVMapManager()->recordLineOfSight(count);
+    PSendSysMessage("Recording the next %u line of sight queries", count);
+    return true;
+}
+
+// .debug losbench [#iterations], replays the recorded queries with the per triangle and the packed triangle code
+bool ChatHandler::HandleDebugLosBenchCommand(char* args)
+{
+    uint32 iterations;
+    if (!ExtractOptUInt32(&args, iterations, 10))
+        return false;
+
+    if (!CheckBenchLimit(this, "iterations", iterations, 100))
+    {
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    VMAP::IVMapManager* vmgr = VMAP::VMapFactory::createOrGetVMapManager();
+    VMAP::LineOfSightBenchmark result;
+    if (!vmgr->benchmarkLineOfSight(iterations, result))
+    {
+        if (!vmgr->isPackedTrianglesEnabled())
+            SendSysMessage("Packed triangles are disabled (vmap.packedTriangles)");
+        else
+            PSendSysMessage("No line of sight queries of loaded maps recorded (%u recorded), use .debug losbench record first", vmgr->getRecordedLineOfSightCount());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    uint64 rays = uint64(result.queries) * iterations;
+    PSendSysMessage("%u recorded queries (%u blocked) x %u iterations:", result.queries, result.blocked, iterations);
+    PSendSysMessage("  per triangle: " UI64FMTD " us, %.3f us per query", result.scalarTime, double(result.scalarTime) / rays);
+    PSendSysMessage("  packed:       " UI64FMTD " us, %.3f us per query", result.packedTime, double(result.packedTime) / rays);
+    if (result.mismatches)
+        PSendSysMessage("  %u queries differ between the two!", result.mismatches);
+    return true;
+}
+
+// .debug opcodeprofile [#count [time|max|calls|out]]
+bool ChatHandler::HandleDebugOpcodeProfileCommand(char* args)
+{
+    uint32 count;
+    if (!ExtractOptUInt32(&args, count, 20))
+        return false;
+
+    OpcodeProfiler::SortOrder order = OpcodeProfiler::SORT_BY_TOTAL_TIME;
+    if (char* orderStr = ExtractLiteralArg(&args))
+    {
+        if (strncmp(orderStr, "time", 5) == 0)
+            order = OpcodeProfiler::SORT_BY_TOTAL_TIME;
+        else if (strncmp(orderStr, "max", 4) == 0)
+            order = OpcodeProfiler::SORT_BY_MAX_TIME;
+        else if (strncmp(orderStr, "calls", 6) == 0)
+            order = OpcodeProfiler::SORT_BY_CALLS;
+        else if (strncmp(orderStr, "out", 4) == 0)
+            order = OpcodeProfiler::SORT_BY_BYTES_OUT;
+        else
+            return false;
+    }
+
+    std::vector<OpcodeProfiler::OpcodeReport> report;
+    sOpcodeProfiler.BuildReport(report, order);
+
+    PSendSysMessage("Opcode profiler %s, %u opcodes called in the last " UI64FMTD " seconds",
+                    sOpcodeProfiler.IsEnabled() ? "enabled" : "disabled", uint32(report.size()), uint64(time(nullptr) - sOpcodeProfiler.GetStartTime()));
+
+    if (report.size() > count)
+        report.resize(count);
+
+    for (std::vector<OpcodeProfiler::OpcodeReport>::const_iterator itr = report.begin(); itr != report.end(); ++itr)
+        PSendSysMessage("  %-36s " UI64FMTD " calls, total " UI64FMTD " us, avg " UI64FMTD " us, max " UI64FMTD " us, in " UI64FMTD " B, out " UI64FMTD " B",
+                        LookupOpcodeName(itr->opcode), itr->calls, itr->totalTimeUs, itr->totalTimeUs / itr->calls, itr->maxTimeUs, itr->bytesIn, itr->bytesOut);
+
+    return true;
+}
+
+bool ChatHandler::HandleDebugOpcodeProfileEnableCommand(char* args)
+{
+    bool value;
+    if (!ExtractOnOff(&args, value))
+    {
+        SendSysMessage(LANG_USE_BOL);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    sOpcodeProfiler.SetEnabled(value);
+    PSendSysMessage("Opcode profiler %s", value ? "enabled" : "disabled");
+    return true;
+}
+
+bool ChatHandler::HandleDebugOpcodeProfileResetCommand(char* /*args*/)
+{
+    sOpcodeProfiler.Reset();
+    SendSysMessage("Opcode profiler data cleared");
+    return true;
+}
+
+// .debug opcodeprofile write [$filename], CSV for comparing builds, written to the logs directory
+bool ChatHandler::HandleDebugOpcodeProfileWriteCommand(char* args)
+{
+    char* fileName = ExtractQuotedOrLiteralArg(&args);
+    if (!fileName)
+        fileName = const_cast<char*>("opcode_profile.csv");
+
+    if (!OpcodeProfiler::IsValidReportFileName(fileName))
+    {
+        PSendSysMessage("Invalid file name %s, only a file name without path is allowed", fileName);
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    std::string path = sLog.GetLogsDir() + fileName;
+    if (!sOpcodeProfiler.WriteReport(fileName))
+    {
+        PSendSysMessage("Can't write opcode profile to %s", path.c_str());
+        SetSentErrorMessage(true);
+        return false;
+    }
+
+    PSendSysMessage("Opcode profile written to %s", path.c_str());
+    return true;
+}
+
 bool ChatHandler::HandleDebugUpdateWorldStateCommand(char* args)
 {
     uint32 world;
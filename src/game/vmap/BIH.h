@@ -117,9 +117,20 @@ class BIH
             delete[] dat.indices;
         }
         size_t primCount() const { return objects.size(); }
+        // primitive stored at position pos of the leaf order, leaves reference consecutive positions
+        uint32 primIndex(uint32 pos) const { return objects[pos]; }
 
         template<typename RayCallback>
         void intersectRay(const Ray& r, RayCallback& intersectCallback, float& maxDist, bool stopAtFirst = false) const
+        {
+            LeafObjectsCallback<RayCallback> leafCallback(objects, intersectCallback);
+            intersectRayLeaves(r, leafCallback, maxDist, stopAtFirst);
+        }
+
+        // like intersectRay, but calls intersectCallback(ray, firstPos, count, maxDist, stopAtFirst) once per leaf
+        // with the leaf order positions of its objects (see primIndex), returns true on a hit
+        template<typename LeafCallback>
+        void intersectRayLeaves(const Ray& r, LeafCallback& intersectCallback, float& maxDist, bool stopAtFirst = false) const
         {
             float intervalMin = -1.f;
             float intervalMax = -1.f;
@@ -220,12 +231,10 @@ class BIH
                         {
                             // leaf - test some objects
                             int n = tree[node + 1];
-                            while (n > 0)
+                            if (n > 0)
                             {
-                                bool hit = intersectCallback(r, objects[offset], maxDist, stopAtFirst);
+                                bool hit = intersectCallback(r, uint32(offset), uint32(n), maxDist, stopAtFirst);
                                 if (stopAtFirst && hit) return;
-                                --n;
-                                ++offset;
                             }
                             break;
                         }
@@ -344,6 +353,89 @@ class BIH
             }
         }
 
+        // calls intersectCallback(entry) for every object in a leaf whose node bounds overlap the box,
+        // the callback has to test the object bounds itself
+        template<typename IsectCallback>
+        void intersectBox(const AABox& box, IsectCallback& intersectCallback) const
+        {
+            if (!bounds.intersects(box))
+                return;
+
+            StackNode stack[MAX_STACK_SIZE];
+            int stackPos = 0;
+            int node = 0;
+
+            while (true)
+            {
+                while (true)
+                {
+                    uint32 tn = tree[node];
+                    uint32 axis = (tn & (3 << 30)) >> 30;
+                    const bool BVH2 = !!(tn & (1 << 29));
+                    int offset = tn & ~(7 << 29);
+                    if (!BVH2)
+                    {
+                        if (axis < 3)
+                        {
+                            // "normal" interior node
+                            float tl = intBitsToFloat(tree[node + 1]);
+                            float tr = intBitsToFloat(tree[node + 2]);
+                            bool left = box.low()[axis] <= tl;
+                            bool right = box.high()[axis] >= tr;
+                            // box is between clip zones
+                            if (!left && !right)
+                                break;
+                            int rightNode = offset + 3;
+                            // box is in right node only
+                            if (!left)
+                            {
+                                node = rightNode;
+                                continue;
+                            }
+                            node = offset; // left
+                            // box is in both nodes, push back right node
+                            if (right)
+                            {
+                                stack[stackPos].node = rightNode;
+                                ++stackPos;
+                            }
+                            continue;
+                        }
+                        else
+                        {
+                            // leaf - report its objects
+                            int n = tree[node + 1];
+                            while (n > 0)
+                            {
+                                intersectCallback(objects[offset]);
+                                --n;
+                                ++offset;
+                            }
+                            break;
+                        }
+                    }
+                    else // BVH2 node (empty space cut off left and right)
+                    {
+                        if (axis > 2)
+                            return; // should not happen
+                        float tl = intBitsToFloat(tree[node + 1]);
+                        float tr = intBitsToFloat(tree[node + 2]);
+                        node = offset;
+                        if (tl > box.high()[axis] || tr < box.low()[axis])
+                            break;
+                        continue;
+                    }
+                } // traversal loop
+
+                // stack is empty?
+                if (stackPos == 0)
+                    return;
+                // move back up the stack
+                --stackPos;
+                node = stack[stackPos].node;
+            }
+        }
+
         bool writeToFile(FILE* wf) const;
         bool readFromFile(FILE* rf);
 
@@ -366,6 +458,26 @@ class BIH
             float tfar;
         };
 
+        // per object ray callback of intersectRay on top of intersectRayLeaves
+        template<typename RayCallback>
+        struct LeafObjectsCallback
+        {
+            LeafObjectsCallback(const std::vector<uint32>& objs, RayCallback& callback) : objects(objs), objectCallback(callback) {}
+            bool operator()(const Ray& r, uint32 first, uint32 count, float& maxDist, bool stopAtFirst)
+            {
+                for (uint32 i = first; i < first + count; ++i)
+                {
+                    bool hit = objectCallback(r, objects[i], maxDist, stopAtFirst);
+                    if (stopAtFirst && hit)
+                        return true;
+                }
+                return false;
+            }
+
+            const std::vector<uint32>& objects;
+            RayCallback& objectCallback;
+        };
+
         class BuildStats
         {
             private:
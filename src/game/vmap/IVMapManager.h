@@ -41,15 +41,27 @@ namespace VMAP
 #define VMAP_INVALID_HEIGHT       -100000.0f            // for check
 #define VMAP_INVALID_HEIGHT_VALUE -200000.0f            // real assigned value in unknown height case
 
+    struct LineOfSightBenchmark
+    {
+        LineOfSightBenchmark() : queries(0), blocked(0), mismatches(0), scalarTime(0), packedTime(0) {}
+
+        uint32 queries;
+        uint32 blocked;                                 // queries without line of sight
+        uint32 mismatches;                              // queries the two intersection codes disagree on
+        uint64 scalarTime;                              // microseconds for all iterations
+        uint64 packedTime;
+    };
+
     //===========================================================
     class IVMapManager
     {
         private:
             bool iEnableLineOfSightCalc;
             bool iEnableHeightCalc;
+            bool iEnablePackedTriangles;
 
         public:
-            IVMapManager() : iEnableLineOfSightCalc(true), iEnableHeightCalc(true) {}
+            IVMapManager() : iEnableLineOfSightCalc(true), iEnableHeightCalc(true), iEnablePackedTriangles(true) {}
 
             virtual ~IVMapManager(void) {}
 
@@ -61,6 +73,10 @@ namespace VMAP
             virtual void unloadMap(unsigned int pMapId) = 0;
 
             virtual bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) = 0;
+            /**
+            line of sight from one position to pCount positions (x,y,z triples in pDests), results are written to pResults
+            */
+            virtual void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* pDests, uint32 pCount, bool* pResults) = 0;
             virtual float getHeight(unsigned int pMapId, float x, float y, float z, float maxSearchDist) = 0;
             /**
             test if we hit an object. return true if we hit one. rx,ry,rz will hold the hit position or the dest position, if no intersection was found
@@ -72,6 +88,16 @@ namespace VMAP
             */
             virtual bool processCommand(char* pCommand) = 0;
 
+            /**
+            line of sight benchmark: record the next pCount static line of sight queries of all maps,
+            then replay them pIterations times with the per triangle and with the packed triangle code.
+            The replay reads the map trees without locks: call it only while no map is updated and tiles can't
+            be loaded or unloaded, i.e. from the world thread (chat or console command)
+            */
+            virtual void recordLineOfSight(uint32 pCount) = 0;
+            virtual uint32 getRecordedLineOfSightCount() const = 0;
+            virtual bool benchmarkLineOfSight(uint32 pIterations, LineOfSightBenchmark& pResult) = 0;
+
             /**
             Enable/disable LOS calculation
             It is enabled by default. If it is enabled in mid game the maps have to loaded manualy
@@ -82,9 +108,15 @@ namespace VMAP
             It is enabled by default. If it is enabled in mid game the maps have to loaded manualy
             */
             void setEnableHeightCalc(bool pVal) { iEnableHeightCalc = pVal; }
+            /**
+            Enable/disable the packed triangle copy (four triangles per ray test) of models loaded from now on
+            It is enabled by default and costs 36 bytes per model triangle
+            */
+            void setEnablePackedTriangles(bool pVal) { iEnablePackedTriangles = pVal; }
 
             bool isLineOfSightCalcEnabled() const { return iEnableLineOfSightCalc; }
             bool isHeightCalcEnabled() const { return iEnableHeightCalc; }
+            bool isPackedTrianglesEnabled() const { return iEnablePackedTriangles; }
             bool isMapLoadingEnabled() const { return iEnableLineOfSightCalc || iEnableHeightCalc; }
 
             virtual std::string getDirFileName(unsigned int pMapId, int x, int y) const = 0;
@@ -25,6 +25,7 @@
 #include <sstream>
 #include <iomanip>
 #include <limits>
+#include <vector>
 
 using G3D::Vector3;
 
@@ -34,10 +35,10 @@ namespace VMAP
     class MapRayCallback
     {
         public:
-            MapRayCallback(ModelInstance* val): prims(val), hit(false) {}
+            MapRayCallback(ModelInstance* val, bool usePacked = true): prims(val), hit(false), packed(usePacked) {}
             bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit = true)
             {
-                bool result = prims[entry].intersectRay(ray, distance, pStopAtFirstHit);
+                bool result = prims[entry].intersectRay(ray, distance, pStopAtFirstHit, packed);
                 if (result)
                     hit = true;
                 return result;
@@ -46,6 +47,22 @@ namespace VMAP
         protected:
             ModelInstance* prims;
             bool hit;
+            bool packed;
+    };
+
+    class MapBoxCallback
+    {
+        public:
+            MapBoxCallback(ModelInstance* val, const G3D::AABox& box, std::vector<const ModelInstance*>& models): prims(val), bound(box), candidates(models) {}
+            void operator()(uint32 entry)
+            {
+                if (prims[entry].getBounds().intersects(bound))
+                    candidates.push_back(&prims[entry]);
+            }
+        protected:
+            ModelInstance* prims;
+            const G3D::AABox& bound;
+            std::vector<const ModelInstance*>& candidates;
     };
 
     class AreaInfoCallback
@@ -140,10 +157,10 @@ namespace VMAP
     Else, pMaxDist is not modified and returns false;
     */
 
-    bool StaticMapTree::getIntersectionTime(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit) const
+    bool StaticMapTree::getIntersectionTime(const G3D::Ray& pRay, float& pMaxDist, bool pStopAtFirstHit, bool pUsePacked) const
     {
         float distance = pMaxDist;
-        MapRayCallback intersectionCallBack(iTreeValues);
+        MapRayCallback intersectionCallBack(iTreeValues, pUsePacked);
         iTree.intersectRay(pRay, intersectionCallBack, distance, pStopAtFirstHit);
         if (intersectionCallBack.didHit())
             pMaxDist = distance;
@@ -151,7 +168,7 @@ namespace VMAP
     }
     //=========================================================
 
-    bool StaticMapTree::isInLineOfSight(const Vector3& pos1, const Vector3& pos2) const
+    bool StaticMapTree::isInLineOfSight(const Vector3& pos1, const Vector3& pos2, bool pUsePacked) const
     {
         float maxDist = (pos2 - pos1).magnitude();
         // valid map coords should *never ever* produce float overflow, but this would produce NaNs too:
@@ -161,13 +178,57 @@ namespace VMAP
             return true;
         // direction with length of 1
         G3D::Ray ray = G3D::Ray::fromOriginAndDirection(pos1, (pos2 - pos1) / maxDist);
-        if (getIntersectionTime(ray, maxDist, true))
+        if (getIntersectionTime(ray, maxDist, true, pUsePacked))
             return false;
 
         return true;
     }
     //=========================================================
     /**
+    Line of sight from pos1 to several targets at once. The tree is traversed only once for the
+    bounding box of all rays, each ray is then tested against the models found there.
+    */
+
+    void StaticMapTree::isInLineOfSight(const Vector3& pos1, const Vector3* targets, uint32 count, bool* results) const
+    {
+        G3D::AABox box(pos1);
+        for (uint32 i = 0; i < count; ++i)
+            box.merge(targets[i]);
+
+        std::vector<const ModelInstance*> candidates;
+        MapBoxCallback boxCallback(iTreeValues, box, candidates);
+        iTree.intersectBox(box, boxCallback);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            results[i] = true;
+            if (candidates.empty())
+                continue;
+
+            float maxDist = (targets[i] - pos1).magnitude();
+            MANGOS_ASSERT(maxDist < std::numeric_limits<float>::max());
+            if (maxDist < 1e-10f)
+                continue;
+
+            G3D::Ray ray = G3D::Ray::fromOriginAndDirection(pos1, (targets[i] - pos1) / maxDist);
+            G3D::AABox rayBox(pos1);
+            rayBox.merge(targets[i]);
+            for (std::vector<const ModelInstance*>::const_iterator itr = candidates.begin(); itr != candidates.end(); ++itr)
+            {
+                if (!(*itr)->getBounds().intersects(rayBox))
+                    continue;
+
+                float distance = maxDist;
+                if ((*itr)->intersectRay(ray, distance, true))
+                {
+                    results[i] = false;
+                    break;
+                }
+            }
+        }
+    }
+    //=========================================================
+    /**
     When moving from pos1 to pos2 check if we hit an object. Return true and the position if we hit one
     Return the hit pos or the original dest pos
     */
@@ -16,6 +16,8 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <string>
 #include <sstream>
@@ -32,7 +34,7 @@ namespace VMAP
 
     //=========================================================
 
-    VMapManager2::VMapManager2()
+    VMapManager2::VMapManager2() : iRaysToRecord(0)
     {
     }
 
@@ -92,31 +94,51 @@ namespace VMAP
 
     bool VMapManager2::_loadMap(unsigned int pMapId, const std::string& basePath, uint32 tileX, uint32 tileY)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree == iInstanceMapTrees.end())
+        StaticMapTree* tree = getMapTree(pMapId);
+        if (!tree)
         {
             std::string mapFileName = getMapFileName(pMapId);
             StaticMapTree* newTree = new StaticMapTree(pMapId, basePath);
             if (!newTree->InitMap(mapFileName, this))
+            {
+                delete newTree;
                 return false;
-            instanceTree = iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, newTree)).first;
+            }
+
+            std::lock_guard<std::mutex> guard(iInstanceMapTreesLock);
+            tree = iInstanceMapTrees.insert(InstanceTreeMap::value_type(pMapId, newTree)).first->second;
         }
-        return instanceTree->second->LoadMapTile(tileX, tileY, this);
+        return tree->LoadMapTile(tileX, tileY, this);
     }
 
     //=========================================================
 
-    void VMapManager2::unloadMap(unsigned int pMapId)
+    StaticMapTree* VMapManager2::getMapTree(uint32 pMapId) const
+    {
+        std::lock_guard<std::mutex> guard(iInstanceMapTreesLock);
+        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
+        return instanceTree != iInstanceMapTrees.end() ? instanceTree->second : nullptr;
+    }
+
+    void VMapManager2::releaseMapTreeIfEmpty(uint32 pMapId)
     {
+        std::lock_guard<std::mutex> guard(iInstanceMapTreesLock);
         InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        if (instanceTree != iInstanceMapTrees.end() && instanceTree->second->numLoadedTiles() == 0)
         {
-            instanceTree->second->UnloadMap(this);
-            if (instanceTree->second->numLoadedTiles() == 0)
-            {
-                delete instanceTree->second;
-                iInstanceMapTrees.erase(pMapId);
-            }
+            delete instanceTree->second;
+            iInstanceMapTrees.erase(instanceTree);
+        }
+    }
+
+    //=========================================================
+
+    void VMapManager2::unloadMap(unsigned int pMapId)
+    {
+        if (StaticMapTree* tree = getMapTree(pMapId))
+        {
+            tree->UnloadMap(this);
+            releaseMapTreeIfEmpty(pMapId);
         }
     }
 
@@ -124,15 +146,10 @@ namespace VMAP
 
     void VMapManager2::unloadMap(unsigned int  pMapId, int x, int y)
     {
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        if (StaticMapTree* tree = getMapTree(pMapId))
         {
-            instanceTree->second->UnloadMapTile(x, y, this);
-            if (instanceTree->second->numLoadedTiles() == 0)
-            {
-                delete instanceTree->second;
-                iInstanceMapTrees.erase(pMapId);
-            }
+            tree->UnloadMapTile(x, y, this);
+            releaseMapTreeIfEmpty(pMapId);
         }
     }
 
@@ -142,18 +159,40 @@ namespace VMAP
     {
         if (!isLineOfSightCalcEnabled()) return true;
         bool result = true;
-        InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        if (StaticMapTree* tree = getMapTree(pMapId))
         {
             Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
             Vector3 pos2 = convertPositionToInternalRep(x2, y2, z2);
             if (pos1 != pos2)
             {
-                result = instanceTree->second->isInLineOfSight(pos1, pos2);
+                if (iRaysToRecord.load(std::memory_order_relaxed))
+                    recordRay(pMapId, pos1, pos2);
+                result = tree->isInLineOfSight(pos1, pos2);
             }
         }
         return result;
     }
+
+    void VMapManager2::isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* pDests, uint32 pCount, bool* pResults)
+    {
+        std::fill(pResults, pResults + pCount, true);
+        if (!isLineOfSightCalcEnabled())
+            return;
+
+        if (StaticMapTree* tree = getMapTree(pMapId))
+        {
+            Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
+            std::vector<Vector3> targets(pCount);
+            for (uint32 i = 0; i < pCount; ++i)
+            {
+                targets[i] = convertPositionToInternalRep(pDests[i * 3], pDests[i * 3 + 1], pDests[i * 3 + 2]);
+                if (iRaysToRecord.load(std::memory_order_relaxed))
+                    recordRay(pMapId, pos1, targets[i]);
+            }
+
+            tree->isInLineOfSight(pos1, targets.data(), pCount, pResults);
+        }
+    }
     //=========================================================
     /**
     get the hit position and return true if we hit something
@@ -167,13 +206,12 @@ namespace VMAP
         rz = z2;
         if (isLineOfSightCalcEnabled())
         {
-            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-            if (instanceTree != iInstanceMapTrees.end())
+            if (StaticMapTree* tree = getMapTree(pMapId))
             {
                 Vector3 pos1 = convertPositionToInternalRep(x1, y1, z1);
                 Vector3 pos2 = convertPositionToInternalRep(x2, y2, z2);
                 Vector3 resultPos;
-                result = instanceTree->second->getObjectHitPos(pos1, pos2, resultPos, pModifyDist);
+                result = tree->getObjectHitPos(pos1, pos2, resultPos, pModifyDist);
                 resultPos = convertPositionToInternalRep(resultPos.x, resultPos.y, resultPos.z);
                 rx = resultPos.x;
                 ry = resultPos.y;
@@ -193,11 +231,10 @@ namespace VMAP
         float height = VMAP_INVALID_HEIGHT_VALUE;           // no height
         if (isHeightCalcEnabled())
         {
-            InstanceTreeMap::iterator instanceTree = iInstanceMapTrees.find(pMapId);
-            if (instanceTree != iInstanceMapTrees.end())
+            if (StaticMapTree* tree = getMapTree(pMapId))
             {
                 Vector3 pos = convertPositionToInternalRep(x, y, z);
-                height = instanceTree->second->getHeight(pos, maxSearchDist);
+                height = tree->getHeight(pos, maxSearchDist);
                 if (!(height < G3D::inf()))
                 {
                     height = VMAP_INVALID_HEIGHT_VALUE;     // no height
@@ -212,11 +249,10 @@ namespace VMAP
     bool VMapManager2::getAreaInfo(unsigned int pMapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const
     {
         bool result = false;
-        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        if (StaticMapTree* tree = getMapTree(pMapId))
         {
             Vector3 pos = convertPositionToInternalRep(x, y, z);
-            result = instanceTree->second->getAreaInfo(pos, flags, adtId, rootId, groupId);
+            result = tree->getAreaInfo(pos, flags, adtId, rootId, groupId);
             // z is not touched by convertPositionToMangosRep(), so just copy
             z = pos.z;
         }
@@ -225,12 +261,11 @@ namespace VMAP
 
     bool VMapManager2::GetLiquidLevel(uint32 pMapId, float x, float y, float z, uint8 ReqLiquidType, float& level, float& floor, uint32& type) const
     {
-        InstanceTreeMap::const_iterator instanceTree = iInstanceMapTrees.find(pMapId);
-        if (instanceTree != iInstanceMapTrees.end())
+        if (StaticMapTree* tree = getMapTree(pMapId))
         {
             LocationInfo info;
             Vector3 pos = convertPositionToInternalRep(x, y, z);
-            if (instanceTree->second->GetLocationInfo(pos, info))
+            if (tree->GetLocationInfo(pos, info))
             {
                 floor = info.ground_Z;
                 type = info.hitModel->GetLiquidType();
@@ -247,6 +282,7 @@ namespace VMAP
 
     WorldModel* VMapManager2::acquireModelInstance(const std::string& basepath, const std::string& filename)
     {
+        std::lock_guard<std::mutex> guard(iLoadedModelFilesLock);
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
@@ -257,6 +293,8 @@ namespace VMAP
                 delete worldmodel;
                 return nullptr;
             }
+            if (isPackedTrianglesEnabled())
+                worldmodel->packTriangles();
             DEBUG_FILTER_LOG(LOG_FILTER_MAP_LOADING, "VMapManager2: loading file '%s%s'.", basepath.c_str(), filename.c_str());
             model = iLoadedModelFiles.insert(std::pair<std::string, ManagedModel>(filename, ManagedModel())).first;
             model->second.setModel(worldmodel);
@@ -267,6 +305,7 @@ namespace VMAP
 
     void VMapManager2::releaseModelInstance(const std::string& filename)
     {
+        std::lock_guard<std::mutex> guard(iLoadedModelFilesLock);
         ModelFileMap::iterator model = iLoadedModelFiles.find(filename);
         if (model == iLoadedModelFiles.end())
         {
@@ -286,4 +325,93 @@ namespace VMAP
     {
         return StaticMapTree::CanLoadMap(std::string(pBasePath), pMapId, x, y);
     }
+
+    //=========================================================
+
+    void VMapManager2::recordRay(uint32 pMapId, const Vector3& pos1, const Vector3& pos2)
+    {
+        std::lock_guard<std::mutex> guard(iRecordedRaysLock);
+        if (!iRaysToRecord.load(std::memory_order_relaxed))
+            return;
+
+        RecordedRay ray;
+        ray.mapId = pMapId;
+        ray.pos1 = pos1;
+        ray.pos2 = pos2;
+        iRecordedRays.push_back(ray);
+        iRaysToRecord.store(iRaysToRecord.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+    }
+
+    void VMapManager2::recordLineOfSight(uint32 pCount)
+    {
+        std::lock_guard<std::mutex> guard(iRecordedRaysLock);
+        iRecordedRays.clear();
+        iRecordedRays.reserve(pCount);
+        iRaysToRecord.store(pCount, std::memory_order_relaxed);
+    }
+
+    uint32 VMapManager2::getRecordedLineOfSightCount() const
+    {
+        std::lock_guard<std::mutex> guard(iRecordedRaysLock);
+        return iRecordedRays.size();
+    }
+
+    /**
+    Must not run while maps are updated, the map trees are used without their map thread.
+    Both runs see the same loaded tiles, rays of unloaded maps are skipped.
+    */
+    bool VMapManager2::benchmarkLineOfSight(uint32 pIterations, LineOfSightBenchmark& pResult)
+    {
+        if (!isPackedTrianglesEnabled())
+            return false;
+
+        std::vector<RecordedRay> rays;
+        {
+            std::lock_guard<std::mutex> guard(iRecordedRaysLock);
+            rays = iRecordedRays;
+        }
+
+        std::vector<const StaticMapTree*> trees;
+        std::vector<RecordedRay>::iterator last = rays.begin();
+        for (std::vector<RecordedRay>::const_iterator itr = rays.begin(); itr != rays.end(); ++itr)
+        {
+            if (const StaticMapTree* tree = getMapTree(itr->mapId))
+            {
+                trees.push_back(tree);
+                *last++ = *itr;
+            }
+        }
+        rays.erase(last, rays.end());
+
+        if (rays.empty() || !pIterations)
+            return false;
+
+        std::vector<bool> scalarResults(rays.size());
+        std::vector<bool> packedResults(rays.size());
+
+        // the kernel is selected per call, queries of other threads keep using packed triangles
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (uint32 i = 0; i < pIterations; ++i)
+            for (size_t j = 0; j < rays.size(); ++j)
+                scalarResults[j] = trees[j]->isInLineOfSight(rays[j].pos1, rays[j].pos2, false);
+        std::chrono::steady_clock::time_point scalarEnd = std::chrono::steady_clock::now();
+
+        for (uint32 i = 0; i < pIterations; ++i)
+            for (size_t j = 0; j < rays.size(); ++j)
+                packedResults[j] = trees[j]->isInLineOfSight(rays[j].pos1, rays[j].pos2, true);
+        std::chrono::steady_clock::time_point packedEnd = std::chrono::steady_clock::now();
+
+        pResult = LineOfSightBenchmark();
+        pResult.queries = rays.size();
+        for (size_t j = 0; j < rays.size(); ++j)
+        {
+            if (!scalarResults[j])
+                ++pResult.blocked;
+            if (scalarResults[j] != packedResults[j])
+                ++pResult.mismatches;
+        }
+        pResult.scalarTime = std::chrono::duration_cast<std::chrono::microseconds>(scalarEnd - start).count();
+        pResult.packedTime = std::chrono::duration_cast<std::chrono::microseconds>(packedEnd - scalarEnd).count();
+        return true;
+    }
 } // namespace VMAP
@@ -23,7 +23,10 @@
 
 #include <G3D/Vector3.h>
 
+#include <atomic>
 #include <unordered_map>
+#include <mutex>
+#include <vector>
 
 //===========================================================
 
@@ -69,7 +72,27 @@ namespace VMAP
             ModelFileMap iLoadedModelFiles;
             InstanceTreeMap iInstanceMapTrees;
 
+            // maps may be updated by several threads, only the containers are shared between them:
+            // all tiles of a map id are loaded, unloaded and queried by the thread updating that map id
+            std::mutex iLoadedModelFilesLock;
+            mutable std::mutex iInstanceMapTreesLock;
+
+            // line of sight benchmark, queries are recorded by all map threads
+            struct RecordedRay
+            {
+                uint32 mapId;
+                G3D::Vector3 pos1;
+                G3D::Vector3 pos2;
+            };
+            std::vector<RecordedRay> iRecordedRays;
+            std::atomic<uint32> iRaysToRecord;
+            mutable std::mutex iRecordedRaysLock;
+
+            void recordRay(uint32 pMapId, const G3D::Vector3& pos1, const G3D::Vector3& pos2);
+
             bool _loadMap(uint32 pMapId, const std::string& basePath, uint32 tileX, uint32 tileY);
+            StaticMapTree* getMapTree(uint32 pMapId) const;
+            void releaseMapTreeIfEmpty(uint32 pMapId);
             /* void _unloadMap(uint32 pMapId, uint32 x, uint32 y); */
 
         public:
@@ -86,6 +109,7 @@ namespace VMAP
             void unloadMap(unsigned int pMapId) override;
 
             bool isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, float x2, float y2, float z2) override;
+            void isInLineOfSight(unsigned int pMapId, float x1, float y1, float z1, const float* pDests, uint32 pCount, bool* pResults) override;
             /**
             fill the hit pos and return true, if an object was hit
             */
@@ -94,6 +118,10 @@ namespace VMAP
 
             bool processCommand(char* /*pCommand*/) override { return false; }      // for debug and extensions
 
+            void recordLineOfSight(uint32 pCount) override;
+            uint32 getRecordedLineOfSightCount() const override;
+            bool benchmarkLineOfSight(uint32 pIterations, LineOfSightBenchmark& pResult) override;
+
             bool getAreaInfo(unsigned int pMapId, float x, float y, float& z, uint32& flags, int32& adtId, int32& rootId, int32& groupId) const override;
             bool GetLiquidLevel(uint32 pMapId, float x, float y, float z, uint8 ReqLiquidType, float& level, float& floor, uint32& type) const override;
 
@@ -21,6 +21,11 @@
 #include "MapTree.h"
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define VMAP_SSE_INTERSECTION
+#include <emmintrin.h>
+#endif
+
 using G3D::Vector3;
 using G3D::Ray;
 
@@ -242,11 +247,147 @@ namespace VMAP
         return result;
     }
 
+    // ===================== PackedTriangles ==================================
+
+    void PackedTriangles::build(const std::vector<Vector3>& vertices, const std::vector<MeshTriangle>& triangles, const BIH& tree)
+    {
+        coords.clear();
+        stride = 0;
+        if (triangles.empty())
+            return;
+
+        uint32 count = tree.primCount();
+        stride = count + 3;
+        coords.assign(COORD_COUNT * stride, 0.0f);      // zero padding has no area and never hits
+        for (uint32 i = 0; i < count; ++i)
+        {
+            const MeshTriangle& tri = triangles[tree.primIndex(i)];
+            const Vector3& v0 = vertices[tri.idx0];
+            const Vector3 e1 = vertices[tri.idx1] - v0;
+            const Vector3 e2 = vertices[tri.idx2] - v0;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                coords[(V0_X + axis) * stride + i] = v0[axis];
+                coords[(E1_X + axis) * stride + i] = e1[axis];
+                coords[(E2_X + axis) * stride + i] = e2[axis];
+            }
+        }
+    }
+
+#ifdef VMAP_SSE_INTERSECTION
+    // same operations and order as IntersectTriangle, so both find bit identical distances
+    bool PackedTriangles::intersectRay(const G3D::Ray& ray, uint32 first, uint32 count, float& distance, bool stopAtFirstHit) const
+    {
+        const __m128 ox = _mm_set1_ps(ray.origin().x);
+        const __m128 oy = _mm_set1_ps(ray.origin().y);
+        const __m128 oz = _mm_set1_ps(ray.origin().z);
+        const __m128 dx = _mm_set1_ps(ray.direction().x);
+        const __m128 dy = _mm_set1_ps(ray.direction().y);
+        const __m128 dz = _mm_set1_ps(ray.direction().z);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 eps = _mm_set1_ps(1e-5f);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+        bool hit = false;
+        for (uint32 i = first; i < first + count; i += 4)
+        {
+            const __m128 e1x = _mm_loadu_ps(column(E1_X) + i);
+            const __m128 e1y = _mm_loadu_ps(column(E1_Y) + i);
+            const __m128 e1z = _mm_loadu_ps(column(E1_Z) + i);
+            const __m128 e2x = _mm_loadu_ps(column(E2_X) + i);
+            const __m128 e2y = _mm_loadu_ps(column(E2_Y) + i);
+            const __m128 e2z = _mm_loadu_ps(column(E2_Z) + i);
+
+            // p = dir x e2, a = e1 . p
+            const __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            const __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            const __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            const __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            __m128 valid = _mm_cmpnlt_ps(_mm_and_ps(a, absMask), eps);
+
+            const __m128 f = _mm_div_ps(one, a);
+            const __m128 sx = _mm_sub_ps(ox, _mm_loadu_ps(column(V0_X) + i));
+            const __m128 sy = _mm_sub_ps(oy, _mm_loadu_ps(column(V0_Y) + i));
+            const __m128 sz = _mm_sub_ps(oz, _mm_loadu_ps(column(V0_Z) + i));
+            const __m128 u = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpnlt_ps(u, zero), _mm_cmpngt_ps(u, one)));
+
+            // q = s x e1
+            const __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            const __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            const __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            const __m128 v = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpnlt_ps(v, zero), _mm_cmpngt_ps(_mm_add_ps(u, v), one)));
+
+            const __m128 t = _mm_mul_ps(f, _mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)));
+            valid = _mm_and_ps(valid, _mm_and_ps(_mm_cmpgt_ps(t, zero), _mm_cmplt_ps(t, _mm_set1_ps(distance))));
+
+            int lanes = _mm_movemask_ps(valid);
+            uint32 left = first + count - i;
+            if (left < 4)
+                lanes &= (1 << left) - 1;
+            if (!lanes)
+                continue;
+
+            float times[4];
+            _mm_storeu_ps(times, t);
+            for (int lane = 0; lane < 4; ++lane)
+                if ((lanes & (1 << lane)) && times[lane] < distance)
+                    distance = times[lane];
+
+            hit = true;
+            if (stopAtFirstHit)
+                return true;
+        }
+        return hit;
+    }
+#else
+    bool PackedTriangles::intersectRay(const G3D::Ray& ray, uint32 first, uint32 count, float& distance, bool stopAtFirstHit) const
+    {
+        static const float EPS = 1e-5f;
+
+        const Vector3& org = ray.origin();
+        const Vector3& dir = ray.direction();
+        bool hit = false;
+        for (uint32 i = first; i < first + count; ++i)
+        {
+            const Vector3 e1(column(E1_X)[i], column(E1_Y)[i], column(E1_Z)[i]);
+            const Vector3 e2(column(E2_X)[i], column(E2_Y)[i], column(E2_Z)[i]);
+            const Vector3 p(dir.cross(e2));
+            const float a = e1.dot(p);
+            if (fabs(a) < EPS)
+                continue;
+
+            const float f = 1.0f / a;
+            const Vector3 s(org - Vector3(column(V0_X)[i], column(V0_Y)[i], column(V0_Z)[i]));
+            const float u = f * s.dot(p);
+            if ((u < 0.0f) || (u > 1.0f))
+                continue;
+
+            const Vector3 q(s.cross(e1));
+            const float v = f * dir.dot(q);
+            if ((v < 0.0f) || ((u + v) > 1.0f))
+                continue;
+
+            const float t = f * e2.dot(q);
+            if ((t > 0.0f) && (t < distance))
+            {
+                distance = t;
+                hit = true;
+                if (stopAtFirstHit)
+                    return true;
+            }
+        }
+        return hit;
+    }
+#endif
+
     // ===================== GroupModel ==================================
 
     GroupModel::GroupModel(const GroupModel& other):
         iBound(other.iBound), iMogpFlags(other.iMogpFlags), iGroupWMOID(other.iGroupWMOID),
-        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), iLiquid(nullptr)
+        vertices(other.vertices), triangles(other.triangles), meshTree(other.meshTree), packedTriangles(other.packedTriangles), iLiquid(nullptr)
     {
         if (other.iLiquid)
             iLiquid = new WmoLiquid(*other.iLiquid);
@@ -256,6 +397,7 @@ namespace VMAP
     {
         vertices.swap(vert);
         triangles.swap(tri);
+        packedTriangles = PackedTriangles();
         TriBoundFunc bFunc(vertices);
         meshTree.build(triangles, bFunc);
     }
@@ -309,6 +451,7 @@ namespace VMAP
         uint32 chunkSize, count;
         triangles.clear();
         vertices.clear();
+        packedTriangles = PackedTriangles();
         delete iLiquid;
         iLiquid = nullptr;
 
@@ -362,10 +505,29 @@ namespace VMAP
         bool hit;
     };
 
-    bool GroupModel::IntersectRay(const G3D::Ray& ray, float& distance, bool stopAtFirstHit) const
+    struct GModelPackedRayCallback
+    {
+        GModelPackedRayCallback(const PackedTriangles& tris): triangles(tris), hit(false) {}
+        bool operator()(const G3D::Ray& ray, uint32 first, uint32 count, float& distance, bool pStopAtFirstHit)
+        {
+            if (triangles.intersectRay(ray, first, count, distance, pStopAtFirstHit))
+                hit = true;
+            return hit;
+        }
+        const PackedTriangles& triangles;
+        bool hit;
+    };
+
+    bool GroupModel::IntersectRay(const G3D::Ray& ray, float& distance, bool stopAtFirstHit, bool usePacked) const
     {
         if (triangles.empty())
             return false;
+        if (!packedTriangles.empty() && usePacked)
+        {
+            GModelPackedRayCallback callback(packedTriangles);
+            meshTree.intersectRayLeaves(ray, callback, distance, stopAtFirstHit);
+            return callback.hit;
+        }
         GModelRayCallback callback(triangles, vertices);
         meshTree.intersectRay(ray, callback, distance, stopAtFirstHit);
         return callback.hit;
@@ -409,25 +571,32 @@ namespace VMAP
 
     struct WModelRayCallBack
     {
-        WModelRayCallBack(const std::vector<GroupModel>& mod): models(mod.begin()), hit(false) {}
+        WModelRayCallBack(const std::vector<GroupModel>& mod, bool packed): models(mod.begin()), hit(false), usePacked(packed) {}
         bool operator()(const G3D::Ray& ray, uint32 entry, float& distance, bool pStopAtFirstHit)
         {
-            bool result = models[entry].IntersectRay(ray, distance, pStopAtFirstHit);
+            bool result = models[entry].IntersectRay(ray, distance, pStopAtFirstHit, usePacked);
             if (result)  hit = true;
             return hit;
         }
         std::vector<GroupModel>::const_iterator models;
         bool hit;
+        bool usePacked;
     };
 
-    bool WorldModel::IntersectRay(const G3D::Ray& ray, float& distance, bool stopAtFirstHit) const
+    void WorldModel::packTriangles()
+    {
+        for (std::vector<GroupModel>::iterator itr = groupModels.begin(); itr != groupModels.end(); ++itr)
+            itr->packTriangles();
+    }
+
+    bool WorldModel::IntersectRay(const G3D::Ray& ray, float& distance, bool stopAtFirstHit, bool usePacked) const
     {
         // small M2 workaround, maybe better make separate class with virtual intersection funcs
         // in any case, there's no need to use a bound tree if we only have one submodel
         if (groupModels.size() == 1)
-            return groupModels[0].IntersectRay(ray, distance, stopAtFirstHit);
+            return groupModels[0].IntersectRay(ray, distance, stopAtFirstHit, usePacked);
 
-        WModelRayCallBack isc(groupModels);
+        WModelRayCallBack isc(groupModels, usePacked);
         groupTree.intersectRay(ray, isc, distance, stopAtFirstHit);
         return isc.hit;
     }
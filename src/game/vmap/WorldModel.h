@@ -26,6 +26,8 @@
 
 #include "Platform/Define.h"
 
+#include <vector>
+
 namespace VMAP
 {
     class TreeNode;
@@ -72,6 +74,27 @@ namespace VMAP
 #endif
     };
 
+    /*! Copy of the triangles of a GroupModel for ray tests of four triangles at once.
+        Triangles are stored in the leaf order of the mesh BIH as first vertex and two edges, one
+        array per coordinate, so a leaf is a consecutive range (SSE2 when available, scalar otherwise). */
+    class PackedTriangles
+    {
+        public:
+            PackedTriangles(): stride(0) {}
+
+            void build(const std::vector<Vector3>& vertices, const std::vector<MeshTriangle>& triangles, const BIH& tree);
+            bool empty() const { return coords.empty(); }
+            //! tests triangles [first, first + count) of the leaf order, sets distance to the closest hit
+            bool intersectRay(const G3D::Ray& ray, uint32 first, uint32 count, float& distance, bool stopAtFirstHit) const;
+        private:
+            enum Coord { V0_X, V0_Y, V0_Z, E1_X, E1_Y, E1_Z, E2_X, E2_Y, E2_Z, COORD_COUNT };
+
+            const float* column(Coord coord) const { return &coords[coord * stride]; }
+
+            std::vector<float> coords;  //!< COORD_COUNT arrays of stride floats
+            uint32 stride;              //!< triangle count + 3, four wide loads of the last leaf stay inside
+    };
+
     /*! holding additional info for WMO group files */
     class GroupModel
     {
@@ -85,7 +108,10 @@ namespace VMAP
             //! pass mesh data to object and create BIH. Passed vectors get get swapped with old geometry!
             void setMeshData(std::vector<Vector3>& vert, std::vector<MeshTriangle>& tri);
             void setLiquidData(WmoLiquid*& liquid) { iLiquid = liquid; liquid = nullptr; }
-            bool IntersectRay(const G3D::Ray& ray, float& distance, bool stopAtFirstHit) const;
+            //! usePacked = false tests the triangles one by one even if packed ones exist (line of sight benchmark)
+            bool IntersectRay(const G3D::Ray& ray, float& distance, bool stopAtFirstHit, bool usePacked = true) const;
+            //! build the PackedTriangles copy used by IntersectRay
+            void packTriangles() { packedTriangles.build(vertices, triangles, meshTree); }
             bool IsInsideObject(const Vector3& pos, const Vector3& down, float& z_dist) const;
             bool GetLiquidLevel(const Vector3& pos, float& liqHeight) const;
             uint32 GetLiquidType() const;
@@ -101,6 +127,7 @@ namespace VMAP
             std::vector<Vector3> vertices;
             std::vector<MeshTriangle> triangles;
             BIH meshTree;
+            PackedTriangles packedTriangles;
             WmoLiquid* iLiquid;
 
 #ifdef MMAP_GENERATOR
@@ -117,7 +144,9 @@ namespace VMAP
             //! pass group models to WorldModel and create BIH. Passed vector is swapped with old geometry!
             void setGroupModels(std::vector<GroupModel>& models);
             void setRootWmoID(uint32 id) { RootWMOID = id; }
-            bool IntersectRay(const G3D::Ray& ray, float& distance, bool stopAtFirstHit) const;
+            //! see GroupModel::packTriangles
+            void packTriangles();
+            bool IntersectRay(const G3D::Ray& ray, float& distance, bool stopAtFirstHit, bool usePacked = true) const;
             bool IntersectPoint(const G3D::Vector3& p, const G3D::Vector3& down, float& dist, AreaInfo& info) const;
             bool GetLocationInfo(const G3D::Vector3& p, const G3D::Vector3& down, float& dist, LocationInfo& info) const;
             bool writeFile(const std::string& filename);
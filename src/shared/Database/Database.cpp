@@ -91,13 +91,40 @@ bool SqlConnection::ExecuteStmt(int nIndex, const SqlStmtParameters& id)
     return pStmt->execute();
 }
 
+QueryResult* SqlConnection::QueryStmt(int nIndex, const SqlStmtParameters& id)
+{
+    if (nIndex == -1)
+        return nullptr;
+
+    // get prepared statement object
+    SqlPreparedStatement* pStmt = GetStmt(nIndex);
+    if (!pStmt || !pStmt->isQuery())
+        return nullptr;
+
+    // bind parameters
+    pStmt->bind(id);
+    // execute query
+    return pStmt->query();
+}
+
+QueryResult* SqlConnection::QueryOnce(const std::string& sql)
+{
+    std::unique_ptr<SqlPreparedStatement> pStmt(CreateStatement(sql));
+    if (!pStmt->prepare() || !pStmt->isQuery())
+        return nullptr;
+
+    pStmt->bind(SqlStmtParameters(0));
+    // result rows are copied out, statement is not needed after the query
+    return pStmt->query();
+}
+
 //////////////////////////////////////////////////////////////////////////
 Database::~Database()
 {
     StopServer();
 }
 
-bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
+bool Database::Initialize(const char* infoString, int nConns /*= 1*/, int nAsyncConns /*= 1*/)
 {
     // Enable logging of SQL commands (usually only GM commands)
     // (See method: PExecuteLog)
@@ -111,6 +138,8 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
 
     m_pingIntervallms = sConfig.GetIntDefault("MaxPingTime", 30) * (MINUTE * 1000);
 
+    m_infoString = infoString;
+
     // create DB connections
 
     // setup connection pool size
@@ -134,10 +163,25 @@ bool Database::Initialize(const char* infoString, int nConns /*= 1*/)
         m_pQueryConnections.push_back(pConn);
     }
 
-    // create and initialize connection for async requests
-    m_pAsyncConn = CreateConnection();
-    if (!m_pAsyncConn->Initialize(infoString))
-        return false;
+    // create and initialize connections for async requests
+    if (nAsyncConns < MIN_CONNECTION_POOL_SIZE)
+        nAsyncConns = MIN_CONNECTION_POOL_SIZE;
+    else if (nAsyncConns > MAX_CONNECTION_POOL_SIZE)
+        nAsyncConns = MAX_CONNECTION_POOL_SIZE;
+
+    for (int i = 0; i < nAsyncConns; ++i)
+    {
+        SqlConnection* pConn = CreateConnection();
+        if (!pConn->Initialize(infoString))
+        {
+            delete pConn;
+            return false;
+        }
+
+        m_pAsyncConns.push_back(pConn);
+    }
+
+    m_pAsyncConn = m_pAsyncConns[0];
 
     m_pResultQueue = new SqlResultQueue;
 
@@ -150,7 +194,11 @@ void Database::StopServer()
     HaltDelayThread();
 
     delete m_pResultQueue;
-    delete m_pAsyncConn;
+
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+        delete m_pAsyncConns[i];
+
+    m_pAsyncConns.clear();
 
     m_pResultQueue = nullptr;
     m_pAsyncConn = nullptr;
@@ -161,30 +209,59 @@ void Database::StopServer()
     m_pQueryConnections.clear();
 }
 
-SqlDelayThread* Database::CreateDelayThread()
+SqlDelayThread* Database::CreateDelayThread(SqlConnection* conn, SqlAsyncQueue* queue, bool pingDatabase)
 {
-    assert(m_pAsyncConn);
-    return new SqlDelayThread(this, m_pAsyncConn);
+    assert(conn);
+    return new SqlDelayThread(this, conn, queue, pingDatabase);
 }
 
 void Database::InitDelayThread()
 {
-    assert(!m_delayThread);
+    assert(m_delayThreads.empty());
+
+    m_asyncQueue.Start();
 
-    // New delay thread for delay execute
-    m_threadBody = CreateDelayThread();              // will deleted at m_delayThread delete
-    m_delayThread = new MaNGOS::Thread(m_threadBody);
+    // New delay thread for delay execute, one per async connection
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
+    {
+        // will deleted at thread delete
+        SqlDelayThread* threadBody = CreateDelayThread(m_pAsyncConns[i], &m_asyncQueue, i == 0);
+        m_threadBodies.push_back(threadBody);
+        m_delayThreads.push_back(new MaNGOS::Thread(threadBody));
+    }
 }
 
 void Database::HaltDelayThread()
 {
-    if (!m_threadBody || !m_delayThread) return;
+    if (m_threadBodies.empty() || m_delayThreads.empty()) return;
+
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+        m_threadBodies[i]->Stop();                          // Stop event
+
+    for (size_t i = 0; i < m_delayThreads.size(); ++i)
+    {
+        m_delayThreads[i]->wait();                          // Wait for flush to DB
+        delete m_delayThreads[i];                           // This also deletes thread body
+    }
+
+    m_delayThreads.clear();
+    m_threadBodies.clear();
+
+    // process all requests which might have been queued while threads were stopping
+    m_asyncQueue.ProcessRemaining(m_pAsyncConn);
+}
+
+bool Database::DelayOperation(SqlOperation* sql, uint32 orderKey /*= 0*/)
+{
+    m_asyncQueue.Delay(sql, orderKey);
+    return true;
+}
 
-    m_threadBody->Stop();                                   // Stop event
-    m_delayThread->wait();                                  // Wait for flush to DB
-    delete m_delayThread;                                   // This also deletes m_threadBody
-    m_delayThread = nullptr;
-    m_threadBody = nullptr;
+void Database::GetAsyncStats(std::vector<SqlDelayThreadStats>& stats) const
+{
+    stats.clear();
+    for (size_t i = 0; i < m_threadBodies.size(); ++i)
+        stats.push_back(m_threadBodies[i]->GetStats());
 }
 
 void Database::ThreadStart()
@@ -229,8 +306,9 @@ void Database::Ping()
 {
     const char* sql = "SELECT 1";
 
+    for (size_t i = 0; i < m_pAsyncConns.size(); ++i)
     {
-        SqlConnection::Lock guard(m_pAsyncConn);
+        SqlConnection::Lock guard(m_pAsyncConns[i]);
         delete guard->Query(sql);
     }
 
@@ -341,7 +419,7 @@ bool Database::Execute(const char* sql)
             return DirectExecute(sql);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPlainRequest(sql));
+        DelayOperation(new SqlPlainRequest(sql));
     }
 
     return true;
@@ -400,7 +478,7 @@ bool Database::BeginTransaction()
     return !!m_currentTransaction.get();
 }
 
-bool Database::CommitTransaction()
+bool Database::CommitTransaction(uint32 orderKey /*= 0*/)
 {
     if (!m_pAsyncConn || !m_currentTransaction.get())
         return false;
@@ -410,7 +488,7 @@ bool Database::CommitTransaction()
         return CommitTransactionDirect();
 
     // add SqlTransaction to the async queue
-    m_threadBody->Delay(m_currentTransaction.release());
+    DelayOperation(m_currentTransaction.release(), orderKey);
     return true;
 }
 
@@ -559,7 +637,7 @@ bool Database::ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params)
             return DirectExecuteStmt(id, params);
 
         // Simple sql statement
-        m_threadBody->Delay(new SqlPreparedRequest(id.ID(), params));
+        DelayOperation(new SqlPreparedRequest(id.ID(), params));
     }
 
     return true;
@@ -574,6 +652,34 @@ bool Database::DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* pa
     return _guard->ExecuteStmt(id.ID(), *params);
 }
 
+QueryResult* Database::QueryStmt(const SqlStatementID& id, SqlStmtParameters* params)
+{
+    MANGOS_ASSERT(params);
+    std::unique_ptr<SqlStmtParameters> p(params);
+    // execute query at connection for sync queries
+    SqlConnection::Lock _guard(getQueryConnection());
+    return _guard->QueryStmt(id.ID(), *params);
+}
+
+QueryResult* Database::QueryBinary(const char* sql)
+{
+    // not registered as prepared statement - ad-hoc request strings would stay prepared at every connection
+    SqlConnection::Lock _guard(getQueryConnection());
+    return _guard->QueryOnce(sql);
+}
+
+SqlConnection* Database::OpenSeparateConnection()
+{
+    SqlConnection* pConn = CreateConnection();
+    if (!pConn->Initialize(m_infoString.c_str()))
+    {
+        delete pConn;
+        return nullptr;
+    }
+
+    return pConn;
+}
+
 SqlStatement Database::CreateStatement(SqlStatementID& index, const char* fmt)
 {
     int nId = -1;
@@ -63,6 +63,9 @@ class MANGOS_DLL_SPEC SqlConnection
 
         // methods to work with prepared statements
         bool ExecuteStmt(int nIndex, const SqlStmtParameters& id);
+        QueryResult* QueryStmt(int nIndex, const SqlStmtParameters& id);
+        // prepare, run and free a statement for a single request, nothing is kept at the connection
+        QueryResult* QueryOnce(const std::string& sql);
 
         // SqlConnection object lock
         class Lock
@@ -104,7 +107,7 @@ class MANGOS_DLL_SPEC Database
     public:
         virtual ~Database();
 
-        virtual bool Initialize(const char* infoString, int nConns = 1);
+        virtual bool Initialize(const char* infoString, int nConns = 1, int nAsyncConns = 1);
         // start worker thread for async DB request execution
         virtual void InitDelayThread();
         // stop worker thread
@@ -126,6 +129,14 @@ class MANGOS_DLL_SPEC Database
         QueryResult* PQuery(const char* format, ...) ATTR_PRINTF(2, 3);
         QueryNamedResult* PQueryNamed(const char* format, ...) ATTR_PRINTF(2, 3);
 
+        // same as Query but executed as prepared statement, numeric values are transferred in binary form
+        // and read without string conversion - use for large loads (the statement is freed right after the query)
+        QueryResult* QueryBinary(const char* sql);
+
+        // connection outside of the pools for long requests of another thread (.debug sqlbench),
+        // owned by the caller, nullptr if it can't connect
+        SqlConnection* OpenSeparateConnection();
+
         bool DirectExecute(const char* sql) const
         {
             if (!m_pAsyncConn)
@@ -184,10 +195,13 @@ class MANGOS_DLL_SPEC Database
         bool PExecuteLog(const char* format, ...) ATTR_PRINTF(2, 3);
 
         bool BeginTransaction();
-        bool CommitTransaction();
+        // transactions with same order key are executed in commit order, key 0 keeps order with all not keyed requests
+        bool CommitTransaction(uint32 orderKey = 0);
         bool RollbackTransaction();
         // for sync transaction execution
         bool CommitTransactionDirect();
+        // true between BeginTransaction and commit/rollback in the calling thread
+        bool IsInTransaction() const { return m_currentTransaction.get() != nullptr; }
 
         // PREPARED STATEMENT API
 
@@ -198,6 +212,13 @@ class MANGOS_DLL_SPEC Database
 
         operator bool () const { return m_pQueryConnections.size() && m_pAsyncConn; }
 
+        // queue async request, requests with same order key keep their order (see SqlAsyncQueue)
+        bool DelayOperation(SqlOperation* sql, uint32 orderKey = 0);
+
+        // queue and latency statistics of async connections
+        uint32 GetAsyncQueueSize() const { return m_asyncQueue.GetSize(); }
+        void GetAsyncStats(std::vector<SqlDelayThreadStats>& stats) const;
+
         // escape string generation
         void escape_string(std::string& str);
 
@@ -223,7 +244,7 @@ class MANGOS_DLL_SPEC Database
     protected:
         Database() :
             m_nQueryConnPoolSize(1), m_pAsyncConn(nullptr), m_pResultQueue(nullptr),
-            m_threadBody(nullptr), m_delayThread(nullptr), m_bAllowAsyncTransactions(false),
+            m_bAllowAsyncTransactions(false),
             m_iStmtIndex(-1), m_logSQL(false), m_pingIntervallms(0)
         {
             m_nQueryCounter = -1;
@@ -234,7 +255,7 @@ class MANGOS_DLL_SPEC Database
         // factory method to create SqlConnection objects
         virtual SqlConnection* CreateConnection() = 0;
         // factory method to create SqlDelayThread objects
-        virtual SqlDelayThread* CreateDelayThread();
+        virtual SqlDelayThread* CreateDelayThread(SqlConnection* conn, SqlAsyncQueue* queue, bool pingDatabase);
 
         // per-thread based storage for SqlTransaction object initialization - no locking is required
         boost::thread_specific_ptr<SqlTransaction> m_currentTransaction;
@@ -243,7 +264,7 @@ class MANGOS_DLL_SPEC Database
 
         // round-robin connection selection
         SqlConnection* getQueryConnection();
-        // for now return one single connection for async requests
+        // first async connection, used for direct (sync) execution of statements
         SqlConnection* getAsyncConnection() const { return m_pAsyncConn; }
 
         friend class SqlStatement;
@@ -251,6 +272,7 @@ class MANGOS_DLL_SPEC Database
         // query function for prepared statements
         bool ExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
         bool DirectExecuteStmt(const SqlStatementID& id, SqlStmtParameters* params);
+        QueryResult* QueryStmt(const SqlStatementID& id, SqlStmtParameters* params);
 
         // connection helper counters
         int m_nQueryConnPoolSize;                           // current size of query connection pool
@@ -260,12 +282,14 @@ class MANGOS_DLL_SPEC Database
         typedef std::vector< SqlConnection* > SqlConnectionContainer;
         SqlConnectionContainer m_pQueryConnections;
 
-        // only one single DB connection for transactions
-        SqlConnection* m_pAsyncConn;
+        // connections for async requests and transactions, each one served by own executer thread
+        SqlConnectionContainer m_pAsyncConns;
+        SqlConnection* m_pAsyncConn;                        ///< first async connection
 
         SqlResultQueue*     m_pResultQueue;                 ///< Transaction queues from diff. threads
-        SqlDelayThread*     m_threadBody;                   ///< Pointer to delay sql executer (owned by m_delayThread)
-        MaNGOS::Thread*     m_delayThread;                  ///< Pointer to executer thread
+        SqlAsyncQueue       m_asyncQueue;                   ///< requests waiting for async execution
+        std::vector<SqlDelayThread*> m_threadBodies;        ///< delay sql executers (owned by m_delayThreads)
+        std::vector<MaNGOS::Thread*> m_delayThreads;        ///< executer threads
 
         bool m_bAllowAsyncTransactions;                     ///< flag which specifies if async transactions are enabled
 
@@ -284,6 +308,7 @@ class MANGOS_DLL_SPEC Database
 
         bool m_logSQL;
         std::string m_logsDir;
+        std::string m_infoString;                           // for OpenSeparateConnection
         uint32 m_pingIntervallms;
 };
 #endif
@@ -377,7 +377,9 @@ bool MySqlPreparedStatement::prepare()
         /* Get total columns in the query */
         m_nColumns = mysql_num_fields(m_pResultMetadata);
 
-        // bind output buffers
+        // let mysql_stmt_store_result() compute max_length, required to size text output buffers
+        my_bool updateMaxLength = 1;
+        mysql_stmt_attr_set(m_stmt, STMT_ATTR_UPDATE_MAX_LENGTH, &updateMaxLength);
     }
 
     m_bPrepared = true;
@@ -473,6 +475,49 @@ bool MySqlPreparedStatement::execute()
     return true;
 }
 
+QueryResult* MySqlPreparedStatement::query()
+{
+    if (!isPrepared() || !isQuery())
+        return nullptr;
+
+    uint32 _s = WorldTimer::getMSTime();
+
+    if (mysql_stmt_execute(m_stmt))
+    {
+        sLog.outError("SQL: cannot execute '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        return nullptr;
+    }
+
+    if (mysql_stmt_store_result(m_stmt))
+    {
+        sLog.outError("SQL: cannot store result of '%s'", m_szFmt.c_str());
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(m_stmt));
+        return nullptr;
+    }
+
+    DEBUG_FILTER_LOG(LOG_FILTER_SQL_TEXT, "[%u ms] SQL (binary): %s", WorldTimer::getMSTimeDiff(_s, WorldTimer::getMSTime()), m_szFmt.c_str());
+
+    uint64 rowCount = mysql_stmt_num_rows(m_stmt);
+    if (!rowCount)
+    {
+        mysql_stmt_free_result(m_stmt);
+        return nullptr;
+    }
+
+    // all rows are copied, statement can be reused right after
+    QueryResultMysqlStmt* queryResult = new QueryResultMysqlStmt(m_stmt, m_pResultMetadata, rowCount, m_nColumns);
+    mysql_stmt_free_result(m_stmt);
+
+    if (!queryResult->NextRow())
+    {
+        delete queryResult;
+        return nullptr;
+    }
+
+    return queryResult;
+}
+
 enum_field_types MySqlPreparedStatement::ToMySQLType(const SqlStmtFieldData& data, my_bool& bUnsigned)
 {
     bUnsigned = 0;
@@ -46,6 +46,8 @@ class MANGOS_DLL_SPEC MySqlPreparedStatement : public SqlPreparedStatement
 
         // execute DML statement
         virtual bool execute() override;
+        // execute query, result set is fetched in binary form
+        virtual QueryResult* query() override;
 
     protected:
         // bind parameters
@@ -34,28 +34,94 @@ class Field
             DB_TYPE_BOOL    = 0x04
         };
 
-        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN) {}
-        Field(const char* value, enum DataTypes type) : mValue(value), mType(type) {}
+        // values of binary protocol result sets, stored without text conversion
+        enum NativeTypes
+        {
+            NATIVE_NONE     = 0x00,                         // text value (or NULL)
+            NATIVE_INT64    = 0x01,
+            NATIVE_UINT64   = 0x02,
+            NATIVE_DOUBLE   = 0x03,
+            NATIVE_FLOAT    = 0x04                          // FLOAT column, kept as double but printed with 6 digits like by the text protocol
+        };
+
+        union NativeValue
+        {
+            int64 i64;
+            uint64 ui64;
+            double d;
+        };
+
+        Field() : mValue(nullptr), mType(DB_TYPE_UNKNOWN), mNativeType(NATIVE_NONE) {}
+        Field(const char* value, enum DataTypes type) : mValue(value), mType(type), mNativeType(NATIVE_NONE) {}
 
         ~Field() {}
 
         enum DataTypes GetType() const { return mType; }
-        bool IsNULL() const { return mValue == nullptr; }
+        bool IsNULL() const { return mValue == nullptr && mNativeType == NATIVE_NONE; }
 
-        const char* GetString() const { return mValue; }
+        const char* GetString() const { return mNativeType != NATIVE_NONE ? NativeToString() : mValue; }
         std::string GetCppString() const
         {
-            return mValue ? mValue : "";                    // std::string s = 0 have undefine result in C++
+            const char* value = GetString();
+            return value ? value : "";                      // std::string s = 0 have undefine result in C++
+        }
+        float GetFloat() const
+        {
+            if (mNativeType != NATIVE_NONE)
+                return static_cast<float>(NativeToDouble());
+
+            return mValue ? static_cast<float>(atof(mValue)) : 0.0f;
+        }
+        bool GetBool() const
+        {
+            if (mNativeType != NATIVE_NONE)
+                return NativeToInt() > 0;
+
+            return mValue ? atoi(mValue) > 0 : false;
+        }
+        int32 GetInt32() const
+        {
+            if (mNativeType != NATIVE_NONE)
+                return static_cast<int32>(NativeToInt());
+
+            return mValue ? static_cast<int32>(atol(mValue)) : int32(0);
+        }
+        uint8 GetUInt8() const
+        {
+            if (mNativeType != NATIVE_NONE)
+                return static_cast<uint8>(NativeToInt());
+
+            return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0);
+        }
+        uint16 GetUInt16() const
+        {
+            if (mNativeType != NATIVE_NONE)
+                return static_cast<uint16>(NativeToInt());
+
+            return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0);
+        }
+        int16 GetInt16() const
+        {
+            if (mNativeType != NATIVE_NONE)
+                return static_cast<int16>(NativeToInt());
+
+            return mValue ? static_cast<int16>(atol(mValue)) : int16(0);
+        }
+        uint32 GetUInt32() const
+        {
+            if (mNativeType != NATIVE_NONE)
+                return static_cast<uint32>(NativeToInt());
+
+            return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0);
         }
-        float GetFloat() const { return mValue ? static_cast<float>(atof(mValue)) : 0.0f; }
-        bool GetBool() const { return mValue ? atoi(mValue) > 0 : false; }
-        int32 GetInt32() const { return mValue ? static_cast<int32>(atol(mValue)) : int32(0); }
-        uint8 GetUInt8() const { return mValue ? static_cast<uint8>(atol(mValue)) : uint8(0); }
-        uint16 GetUInt16() const { return mValue ? static_cast<uint16>(atol(mValue)) : uint16(0); }
-        int16 GetInt16() const { return mValue ? static_cast<int16>(atol(mValue)) : int16(0); }
-        uint32 GetUInt32() const { return mValue ? static_cast<uint32>(atoll(mValue)) : uint32(0); }
         uint64 GetUInt64() const
         {
+            if (mNativeType == NATIVE_UINT64)
+                return mNative.ui64;
+
+            if (mNativeType != NATIVE_NONE)
+                return static_cast<uint64>(NativeToInt());
+
             uint64 value = 0;
             if (!mValue || sscanf(mValue, UI64FMTD, &value) == -1)
                 return 0;
@@ -67,12 +133,59 @@ class Field
         // no need for memory allocations to store resultset field strings
         // all we need is to cache pointers returned by different DBMS APIs
         void SetValue(const char* value) { mValue = value; };
+        // binary protocol value, NATIVE_NONE marks NULL value of not text column
+        void SetNativeValue(enum NativeTypes type, NativeValue value) { mValue = nullptr; mNativeType = type; mNative = value; }
 
     private:
         Field(Field const&);
         Field& operator=(Field const&);
 
+        int64 NativeToInt() const
+        {
+            switch (mNativeType)
+            {
+                case NATIVE_INT64:  return mNative.i64;
+                case NATIVE_UINT64: return static_cast<int64>(mNative.ui64);
+                default:            return static_cast<int64>(mNative.d);
+            }
+        }
+
+        double NativeToDouble() const
+        {
+            switch (mNativeType)
+            {
+                case NATIVE_INT64:  return static_cast<double>(mNative.i64);
+                case NATIVE_UINT64: return static_cast<double>(mNative.ui64);
+                default:            return mNative.d;
+            }
+        }
+
+        // text form of native value, only for callers reading numeric columns as string
+        const char* NativeToString() const
+        {
+            switch (mNativeType)
+            {
+                case NATIVE_INT64:  snprintf(mNativeText, sizeof(mNativeText), SI64FMTD, mNative.i64); break;
+                case NATIVE_UINT64: snprintf(mNativeText, sizeof(mNativeText), UI64FMTD, mNative.ui64); break;
+                // same digits as the text protocol: FLOAT rounded to 6 significant digits,
+                // DOUBLE with the fewest digits that read back as the same value
+                case NATIVE_FLOAT:  snprintf(mNativeText, sizeof(mNativeText), "%.6g", mNative.d); break;
+                default:
+                    for (int precision = 15; precision <= 17; ++precision)
+                    {
+                        snprintf(mNativeText, sizeof(mNativeText), "%.*g", precision, mNative.d);
+                        if (strtod(mNativeText, nullptr) == mNative.d)
+                            break;
+                    }
+                    break;
+            }
+            return mNativeText;
+        }
+
         const char* mValue;
         enum DataTypes mType;
+        enum NativeTypes mNativeType;
+        NativeValue mNative;
+        mutable char mNativeText[32];                       // fits "%.17g" of any double
 };
 #endif
@@ -69,7 +69,7 @@ void QueryResultMysql::EndQuery()
     }
 }
 
-enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType) const
+enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysqlType)
 {
     switch (mysqlType)
     {
@@ -99,4 +99,130 @@ enum Field::DataTypes QueryResultMysql::ConvertNativeType(enum_field_types mysql
             return Field::DB_TYPE_UNKNOWN;
     }
 }
+
+QueryResultMysqlStmt::QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_RES* metadata, uint64 rowCount, uint32 fieldCount) :
+    QueryResult(rowCount, fieldCount), mNextRow(0)
+{
+    mCurrentRow = new Field[mFieldCount];
+    MANGOS_ASSERT(mCurrentRow);
+
+    MYSQL_FIELD* fields = mysql_fetch_fields(metadata);
+
+    std::vector<MYSQL_BIND> binds(mFieldCount);
+    std::vector<Field::NativeValue> values(mFieldCount);
+    std::vector<std::vector<char> > texts(mFieldCount);
+    std::vector<unsigned long> lengths(mFieldCount);
+    std::vector<my_bool> nulls(mFieldCount);
+
+    memset(&binds[0], 0, sizeof(MYSQL_BIND) * mFieldCount);
+    mColumnTypes.resize(mFieldCount, Field::NATIVE_NONE);
+
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        mCurrentRow[i].SetType(QueryResultMysql::ConvertNativeType(fields[i].type));
+
+        MYSQL_BIND& bind = binds[i];
+        bind.length = &lengths[i];
+        bind.is_null = &nulls[i];
+
+        switch (fields[i].type)
+        {
+            case FIELD_TYPE_TINY:
+            case FIELD_TYPE_SHORT:
+            case FIELD_TYPE_LONG:
+            case FIELD_TYPE_INT24:
+            case FIELD_TYPE_LONGLONG:
+                bind.buffer_type = MYSQL_TYPE_LONGLONG;
+                bind.is_unsigned = (fields[i].flags & UNSIGNED_FLAG) ? 1 : 0;
+                bind.buffer = &values[i];
+                mColumnTypes[i] = bind.is_unsigned ? Field::NATIVE_UINT64 : Field::NATIVE_INT64;
+                break;
+            case FIELD_TYPE_FLOAT:
+            case FIELD_TYPE_DOUBLE:
+                bind.buffer_type = MYSQL_TYPE_DOUBLE;
+                bind.buffer = &values[i];
+                mColumnTypes[i] = fields[i].type == FIELD_TYPE_FLOAT ? Field::NATIVE_FLOAT : Field::NATIVE_DOUBLE;
+                break;
+            default:
+                // everything else (decimals, enums, dates) is returned as text, same as by plain queries
+                // max_length is known as statement has STMT_ATTR_UPDATE_MAX_LENGTH set
+                texts[i].resize(fields[i].max_length + 1);
+                bind.buffer_type = MYSQL_TYPE_STRING;
+                bind.buffer = &texts[i][0];
+                bind.buffer_length = texts[i].size();
+                break;
+        }
+    }
+
+    if (mysql_stmt_bind_result(stmt, &binds[0]))
+    {
+        sLog.outError("SQL ERROR: mysql_stmt_bind_result() failed");
+        sLog.outError("SQL ERROR: %s", mysql_stmt_error(stmt));
+        mRowCount = 0;
+        return;
+    }
+
+    mRows.reserve(size_t(rowCount) * mFieldCount);
+
+    for (;;)
+    {
+        int res = mysql_stmt_fetch(stmt);
+        if (res != 0 && res != MYSQL_DATA_TRUNCATED)
+            break;
+
+        for (uint32 i = 0; i < mFieldCount; ++i)
+        {
+            ColumnValue column;
+            column.value = values[i];
+            column.textOffset = 0;
+            column.isNull = nulls[i] != 0;
+
+            if (mColumnTypes[i] == Field::NATIVE_NONE && !column.isNull)
+            {
+                column.textOffset = mText.size();
+                mText.insert(mText.end(), texts[i].begin(), texts[i].begin() + std::min<size_t>(lengths[i], texts[i].size() - 1));
+                mText.push_back('\0');
+            }
+
+            mRows.push_back(column);
+        }
+    }
+
+    mRowCount = mFieldCount ? mRows.size() / mFieldCount : 0;
+}
+
+QueryResultMysqlStmt::~QueryResultMysqlStmt()
+{
+    EndQuery();
+}
+
+bool QueryResultMysqlStmt::NextRow()
+{
+    if (!mCurrentRow)
+        return false;
+
+    if (mNextRow >= mRowCount)
+    {
+        EndQuery();
+        return false;
+    }
+
+    ColumnValue const* row = &mRows[size_t(mNextRow) * mFieldCount];
+    for (uint32 i = 0; i < mFieldCount; ++i)
+    {
+        if (mColumnTypes[i] != Field::NATIVE_NONE)
+            mCurrentRow[i].SetNativeValue(row[i].isNull ? Field::NATIVE_NONE : mColumnTypes[i], row[i].value);
+        else
+            mCurrentRow[i].SetValue(row[i].isNull ? nullptr : &mText[row[i].textOffset]);
+    }
+
+    ++mNextRow;
+    return true;
+}
+
+void QueryResultMysqlStmt::EndQuery()
+{
+    delete[] mCurrentRow;
+    mCurrentRow = nullptr;
+}
 #endif
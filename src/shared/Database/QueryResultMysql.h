@@ -39,11 +39,39 @@ class QueryResultMysql : public QueryResult
 
         bool NextRow() override;
 
+        static enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType);
+
     private:
-        enum Field::DataTypes ConvertNativeType(enum_field_types mysqlType) const;
         void EndQuery();
 
         MYSQL_RES* mResult;
 };
+
+// result set of prepared statement, fetched with binary protocol
+// numeric columns are kept in native form, so Field getters don't parse text
+class QueryResultMysqlStmt : public QueryResult
+{
+    public:
+        QueryResultMysqlStmt(MYSQL_STMT* stmt, MYSQL_RES* metadata, uint64 rowCount, uint32 fieldCount);
+
+        ~QueryResultMysqlStmt();
+
+        bool NextRow() override;
+
+    private:
+        struct ColumnValue
+        {
+            Field::NativeValue value;
+            uint32 textOffset;                              // position in mText for text columns
+            bool isNull;
+        };
+
+        void EndQuery();
+
+        std::vector<Field::NativeTypes> mColumnTypes;
+        std::vector<ColumnValue> mRows;                     // all rows, mFieldCount values per row
+        std::vector<char> mText;                            // zero terminated values of text columns
+        uint64 mNextRow;
+};
 #endif
 #endif
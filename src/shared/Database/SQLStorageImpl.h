@@ -211,7 +211,8 @@ void SQLStorageLoaderBase<DerivedLoader, StorageClass>::Load(StorageClass& store
         delete result;
     }
 
-    result = WorldDatabase.PQuery("SELECT * FROM %s", store.GetTableName());
+    // full table load, binary result set avoids text conversion of every numeric value
+    result = WorldDatabase.QueryBinary((std::string("SELECT * FROM ") + store.GetTableName()).c_str());
 
     if (!result)
     {
@@ -20,14 +20,131 @@
 #include "Database/SqlOperations.h"
 #include "DatabaseEnv.h"
 
-SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn) : m_dbEngine(db), m_dbConnection(conn), m_running(true)
+#include <algorithm>
+
+SqlAsyncQueue::~SqlAsyncQueue()
+{
+    for (std::deque<DelayedOperation>::iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+        delete itr->operation;
+}
+
+void SqlAsyncQueue::Delay(SqlOperation* sql, uint32 orderKey)
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_queue.push_back(DelayedOperation(sql, orderKey));
+    }
+    m_condition.notify_one();
+}
+
+bool SqlAsyncQueue::SelectNext(DelayedOperation& op)
+{
+    // keys of requests waiting before the checked one, their order must be kept
+    std::set<uint32> keysWaiting;
+
+    for (std::deque<DelayedOperation>::iterator itr = m_queue.begin(); itr != m_queue.end(); ++itr)
+    {
+        if (!itr->orderKey)
+        {
+            // not keyed request waits for everything before it, and everything after waits for it
+            if (itr != m_queue.begin() || m_inProgress)
+                return false;
+        }
+        else if (m_keysInProgress.find(itr->orderKey) != m_keysInProgress.end() ||
+                 keysWaiting.find(itr->orderKey) != keysWaiting.end())
+        {
+            keysWaiting.insert(itr->orderKey);
+            continue;
+        }
+        else if (m_keysInProgress.find(0) != m_keysInProgress.end())
+            return false;
+
+        op = *itr;
+        m_queue.erase(itr);
+        m_keysInProgress.insert(op.orderKey);
+        ++m_inProgress;
+        return true;
+    }
+
+    return false;
+}
+
+bool SqlAsyncQueue::Next(DelayedOperation& op, Clock::time_point until)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    for (;;)
+    {
+        if (SelectNext(op))
+            return true;
+
+        if (!m_running && m_queue.empty())
+            return false;
+
+        if (m_condition.wait_until(lock, until) == std::cv_status::timeout)
+            return SelectNext(op);
+    }
+}
+
+void SqlAsyncQueue::Done(DelayedOperation const& op)
 {
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_keysInProgress.erase(op.orderKey);
+        --m_inProgress;
+    }
+
+    // finished request can unblock requests for any executer
+    m_condition.notify_all();
 }
 
-SqlDelayThread::~SqlDelayThread()
+void SqlAsyncQueue::Start()
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_running = true;
+}
+
+void SqlAsyncQueue::Stop()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_running = false;
+    }
+    m_condition.notify_all();
+}
+
+bool SqlAsyncQueue::IsStopped() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return !m_running && m_queue.empty();
+}
+
+void SqlAsyncQueue::ProcessRemaining(SqlConnection* conn)
+{
+    std::deque<DelayedOperation> queue;
+
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        queue.swap(m_queue);
+    }
+
+    for (std::deque<DelayedOperation>::iterator itr = queue.begin(); itr != queue.end(); ++itr)
+    {
+        itr->operation->Execute(conn);
+        delete itr->operation;
+    }
+}
+
+uint32 SqlAsyncQueue::GetSize() const
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_queue.size();
+}
+
+SqlDelayThread::SqlDelayThread(Database* db, SqlConnection* conn, SqlAsyncQueue* queue, bool pingDatabase) :
+    m_queue(queue), m_dbEngine(db), m_dbConnection(conn), m_pingDatabase(pingDatabase),
+    m_processed(0), m_totalLatencyUs(0), m_maxLatencyUs(0)
 {
-    // process all requests which might have been queued while thread was stopping
-    ProcessRequests();
 }
 
 void SqlDelayThread::run()
@@ -36,23 +153,37 @@ void SqlDelayThread::run()
     mysql_thread_init();
 #endif
 
-    const uint32 loopSleepms = 10;
+    typedef SqlAsyncQueue::Clock Clock;
 
-    const uint32 pingEveryLoop = m_dbEngine->GetPingIntervall() / loopSleepms;
+    // MaxPingTime = 0 must not turn the wait into busy loop
+    const Clock::duration pingInterval = std::chrono::milliseconds(std::max(m_dbEngine->GetPingIntervall(), uint32(1000)));
+    Clock::time_point nextPing = Clock::now() + pingInterval;
 
-    uint32 loopCounter = 0;
-    while (m_running)
+    // if the running state gets turned off while waiting
+    // empty the queue before exiting
+    while (!m_queue->IsStopped())
     {
-        // if the running state gets turned off while sleeping
-        // empty the queue before exiting
-        MaNGOS::Thread::Sleep(loopSleepms);
+        SqlAsyncQueue::DelayedOperation op;
+        if (m_queue->Next(op, nextPing))
+        {
+            op.operation->Execute(m_dbConnection);
+            delete op.operation;
+            m_queue->Done(op);
 
-        ProcessRequests();
+            uint64 latencyUs = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - op.queued).count();
 
-        if ((loopCounter++) >= pingEveryLoop)
+            std::lock_guard<std::mutex> guard(m_statsMutex);
+            ++m_processed;
+            m_totalLatencyUs += latencyUs;
+            if (latencyUs > m_maxLatencyUs)
+                m_maxLatencyUs = latencyUs;
+        }
+
+        if (Clock::now() >= nextPing)
         {
-            loopCounter = 0;
-            m_dbEngine->Ping();
+            nextPing = Clock::now() + pingInterval;
+            if (m_pingDatabase)
+                m_dbEngine->Ping();
         }
     }
 
@@ -63,24 +194,16 @@ void SqlDelayThread::run()
 
 void SqlDelayThread::Stop()
 {
-    m_running = false;
+    m_queue->Stop();
 }
 
-void SqlDelayThread::ProcessRequests()
+SqlDelayThreadStats SqlDelayThread::GetStats() const
 {
-    std::queue<std::unique_ptr<SqlOperation>> sqlQueue;
+    std::lock_guard<std::mutex> guard(m_statsMutex);
 
-    // we need to move the contents of the queue to a local copy because executing these statements with the
-    // lock in place can result in a deadlock with the world thread which calls Database::ProcessResultQueue()
-    {
-        std::lock_guard<std::mutex> guard(m_queueMutex);
-        sqlQueue = std::move(m_sqlQueue);
-    }
-
-    while (!sqlQueue.empty())
-    {
-        auto const s = std::move(sqlQueue.front());
-        sqlQueue.pop();
-        s->Execute(m_dbConnection);
-    }
+    SqlDelayThreadStats stats;
+    stats.processed = m_processed;
+    stats.avgLatencyUs = m_processed ? m_totalLatencyUs / m_processed : 0;
+    stats.maxLatencyUs = m_maxLatencyUs;
+    return stats;
 }
@@ -23,36 +23,95 @@
 #include "SqlOperations.h"
 
 #include <mutex>
-#include <queue>
-#include <memory>
+#include <condition_variable>
+#include <deque>
+#include <set>
+#include <chrono>
 
 class Database;
 class SqlOperation;
 class SqlConnection;
 
+/**
+ * Async requests of one database, shared by the executers of all async connections.
+ *
+ * Requests with same non-zero order key are executed one after another in queue order,
+ * requests with different keys may run in parallel at different connections.
+ * Requests without key (0) are executed alone, after all earlier requests are finished
+ * and before any later one, so they keep the order they always had with everything else.
+ */
+class SqlAsyncQueue
+{
+    public:
+        typedef std::chrono::steady_clock Clock;
+
+        struct DelayedOperation
+        {
+            DelayedOperation() : operation(nullptr), orderKey(0) {}
+            DelayedOperation(SqlOperation* sql, uint32 key) : operation(sql), orderKey(key), queued(Clock::now()) {}
+
+            SqlOperation* operation;
+            uint32 orderKey;
+            Clock::time_point queued;
+        };
+
+        SqlAsyncQueue() : m_running(true), m_inProgress(0) {}
+        ~SqlAsyncQueue();
+
+        void Delay(SqlOperation* sql, uint32 orderKey);
+
+        // wait for request which can be executed now, false at timeout or at stop when nothing is left
+        bool Next(DelayedOperation& op, Clock::time_point until);
+        // must be called after execution of every request returned by Next
+        void Done(DelayedOperation const& op);
+
+        void Start();
+        void Stop();
+        bool IsStopped() const;
+
+        // execute requests added after all executers ended, in queue order
+        void ProcessRemaining(SqlConnection* conn);
+
+        uint32 GetSize() const;
+
+    private:
+        bool SelectNext(DelayedOperation& op);
+
+        mutable std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<DelayedOperation> m_queue;
+        std::set<uint32> m_keysInProgress;
+        bool m_running;
+        uint32 m_inProgress;
+};
+
+// snapshot of one async connection executer state
+struct SqlDelayThreadStats
+{
+    SqlDelayThreadStats() : processed(0), avgLatencyUs(0), maxLatencyUs(0) {}
+
+    uint64 processed;                                       ///< requests executed since start
+    uint64 avgLatencyUs;                                    ///< average time from queueing to execution end
+    uint64 maxLatencyUs;                                    ///< worst time from queueing to execution end
+};
+
 class SqlDelayThread : public MaNGOS::Runnable
 {
     private:
-        std::mutex m_queueMutex;
-        std::queue<std::unique_ptr<SqlOperation>> m_sqlQueue;   ///< Queue of SQL statements
-        Database* m_dbEngine;                                   ///< Pointer to used Database engine
-        SqlConnection* m_dbConnection;                          ///< Pointer to DB connection
-        volatile bool m_running;
+        SqlAsyncQueue* m_queue;                             ///< requests shared with other async connections
+        Database* m_dbEngine;                               ///< Pointer to used Database engine
+        SqlConnection* m_dbConnection;                      ///< Pointer to DB connection
+        bool m_pingDatabase;                                ///< this executer keeps all database connections alive
 
-        // process all enqueued requests
-        void ProcessRequests();
+        mutable std::mutex m_statsMutex;
+        uint64 m_processed;
+        uint64 m_totalLatencyUs;
+        uint64 m_maxLatencyUs;
 
     public:
-        SqlDelayThread(Database* db, SqlConnection* conn);
-        ~SqlDelayThread();
+        SqlDelayThread(Database* db, SqlConnection* conn, SqlAsyncQueue* queue, bool pingDatabase);
 
-        ///< Put sql statement to delay queue
-        bool Delay(SqlOperation* sql)
-        {
-            std::lock_guard<std::mutex> guard(m_queueMutex);
-            m_sqlQueue.push(std::unique_ptr<SqlOperation>(sql));
-            return true;
-        }
+        SqlDelayThreadStats GetStats() const;
 
         virtual void Stop();                                ///< Stop event
         virtual void run();                                 ///< Main Thread loop
@@ -206,6 +206,8 @@ class MANGOS_DLL_SPEC SqlStatement
 
         bool Execute();
         bool DirectExecute();
+        // synchronous query, result set is read with binary protocol if DBMS supports it
+        QueryResult* Query();
 
         // templates to simplify 1-4 parameter bindings
         template<typename ParamType1>
@@ -314,6 +316,8 @@ class MANGOS_DLL_SPEC SqlPreparedStatement
 
         // execute statement w/o result set
         virtual bool execute() = 0;
+        // execute query statement, nullptr at error or for empty result set
+        virtual QueryResult* query() = 0;
 
     protected:
         SqlPreparedStatement(const std::string& fmt, SqlConnection& conn) :
@@ -343,6 +347,7 @@ class MANGOS_DLL_SPEC SqlPlainPreparedStatement : public SqlPreparedStatement
         virtual void bind(const SqlStmtParameters& holder) override;
 
         virtual bool execute() override;
+        virtual QueryResult* query() override;
 
     protected:
         void DataToString(const SqlStmtFieldData& data, std::ostringstream& fmt) const;
@@ -23,6 +23,7 @@
 #include "Util.h"
 #include "ByteBuffer.h"
 #include "ProgressBar.h"
+#include "TSS.h"
 
 #include <fstream>
 #include <iostream>
@@ -31,6 +32,9 @@
 
 INSTANTIATE_SINGLETON_1(Log);
 
+// output buffer of the current thread while Log::BeginCapture is active
+static MaNGOS::thread_local_ptr<LogCaptureBuffer> captureBuffer;
+
 LogFilterData logFilterData[LOG_FILTER_COUNT] =
 {
     { "transport_moves",     "LogFilter_TransportMoves",     true  },
@@ -353,6 +357,9 @@ std::string Log::GetTimestampStr()
 
 void Log::outString()
 {
+    if (CaptureLine(LOG_CAPTURE_STRING))
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_includeTime)
         outTime();
@@ -372,6 +379,13 @@ void Log::outString(const char* str, ...)
     if (!str)
         return;
 
+    va_list capture_ap;
+    va_start(capture_ap, str);
+    bool captured = CaptureLine(LOG_CAPTURE_STRING, str, capture_ap);
+    va_end(capture_ap);
+    if (captured)
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
     if (m_colored)
@@ -411,6 +425,13 @@ void Log::outError(const char* err, ...)
     if (!err)
         return;
 
+    va_list capture_ap;
+    va_start(capture_ap, err);
+    bool captured = CaptureLine(LOG_CAPTURE_ERROR, err, capture_ap);
+    va_end(capture_ap);
+    if (captured)
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
     if (m_colored)
@@ -447,6 +468,9 @@ void Log::outError(const char* err, ...)
 
 void Log::outErrorDb()
 {
+    if (CaptureLine(LOG_CAPTURE_ERROR_DB))
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
     if (m_includeTime)
@@ -476,6 +500,13 @@ void Log::outErrorDb(const char* err, ...)
     if (!err)
         return;
 
+    va_list capture_ap;
+    va_start(capture_ap, err);
+    bool captured = CaptureLine(LOG_CAPTURE_ERROR_DB, err, capture_ap);
+    va_end(capture_ap);
+    if (captured)
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
     if (m_colored)
@@ -526,6 +557,9 @@ void Log::outErrorDb(const char* err, ...)
 
 void Log::outErrorEventAI()
 {
+    if (CaptureLine(LOG_CAPTURE_ERROR_EVENT_AI))
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
 
     if (m_includeTime)
@@ -555,6 +589,13 @@ void Log::outErrorEventAI(const char* err, ...)
     if (!err)
         return;
 
+    va_list capture_ap;
+    va_start(capture_ap, err);
+    bool captured = CaptureLine(LOG_CAPTURE_ERROR_EVENT_AI, err, capture_ap);
+    va_end(capture_ap);
+    if (captured)
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_colored)
         SetColor(false, m_colors[LogError]);
@@ -607,6 +648,13 @@ void Log::outBasic(const char* str, ...)
     if (!str)
         return;
 
+    va_list capture_ap;
+    va_start(capture_ap, str);
+    bool captured = CaptureLine(LOG_CAPTURE_BASIC, str, capture_ap);
+    va_end(capture_ap);
+    if (captured)
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_BASIC)
     {
@@ -646,6 +694,13 @@ void Log::outDetail(const char* str, ...)
     if (!str)
         return;
 
+    va_list capture_ap;
+    va_start(capture_ap, str);
+    bool captured = CaptureLine(LOG_CAPTURE_DETAIL, str, capture_ap);
+    va_end(capture_ap);
+    if (captured)
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_DETAIL)
     {
@@ -687,6 +742,13 @@ void Log::outDebug(const char* str, ...)
     if (!str)
         return;
 
+    va_list capture_ap;
+    va_start(capture_ap, str);
+    bool captured = CaptureLine(LOG_CAPTURE_DEBUG, str, capture_ap);
+    va_end(capture_ap);
+    if (captured)
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_logLevel >= LOG_LVL_DEBUG)
     {
@@ -807,6 +869,9 @@ void Log::outChar(const char* str, ...)
 
 void Log::outErrorScriptLib()
 {
+    if (CaptureLine(LOG_CAPTURE_ERROR_SCRIPT_LIB))
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_includeTime)
         outTime();
@@ -838,6 +903,13 @@ void Log::outErrorScriptLib(const char* err, ...)
     if (!err)
         return;
 
+    va_list capture_ap;
+    va_start(capture_ap, err);
+    bool captured = CaptureLine(LOG_CAPTURE_ERROR_SCRIPT_LIB, err, capture_ap);
+    va_end(capture_ap);
+    if (captured)
+        return;
+
     std::lock_guard<std::mutex> guard(m_worldLogMtx);
     if (m_colored)
         SetColor(false, m_colors[LogError]);
@@ -986,6 +1058,99 @@ void Log::setScriptLibraryErrorFile(char const* fname, char const* libName)
     scriptErrLogFile = fopen(fileName.c_str(), "a");
 }
 
+void Log::BeginCapture()
+{
+    captureBuffer.reset(new LogCaptureBuffer);
+}
+
+void Log::EndCapture(LogCaptureBuffer& lines)
+{
+    if (LogCaptureBuffer* buffer = captureBuffer.get_value())
+        lines.swap(*buffer);
+
+    captureBuffer.reset();
+}
+
+void Log::Replay(LogCaptureBuffer const& lines)
+{
+    for (LogCaptureBuffer::const_iterator itr = lines.begin(); itr != lines.end(); ++itr)
+    {
+        char const* text = itr->text.c_str();
+        switch (itr->type)
+        {
+            case LOG_CAPTURE_STRING:
+                if (itr->empty)
+                    outString();
+                else
+                    outString("%s", text);
+                break;
+            case LOG_CAPTURE_ERROR:
+                outError("%s", text);
+                break;
+            case LOG_CAPTURE_BASIC:
+                outBasic("%s", text);
+                break;
+            case LOG_CAPTURE_DETAIL:
+                outDetail("%s", text);
+                break;
+            case LOG_CAPTURE_DEBUG:
+                outDebug("%s", text);
+                break;
+            case LOG_CAPTURE_ERROR_DB:
+                if (itr->empty)
+                    outErrorDb();
+                else
+                    outErrorDb("%s", text);
+                break;
+            case LOG_CAPTURE_ERROR_EVENT_AI:
+                if (itr->empty)
+                    outErrorEventAI();
+                else
+                    outErrorEventAI("%s", text);
+                break;
+            case LOG_CAPTURE_ERROR_SCRIPT_LIB:
+                if (itr->empty)
+                    outErrorScriptLib();
+                else
+                    outErrorScriptLib("%s", text);
+                break;
+        }
+    }
+}
+
+bool Log::CaptureLine(LogCaptureType type, const char* str, va_list ap)
+{
+    LogCaptureBuffer* buffer = captureBuffer.get_value();
+    if (!buffer)
+        return false;
+
+    va_list len_ap;
+    va_copy(len_ap, ap);
+    int len = vsnprintf(nullptr, 0, str, len_ap);
+    va_end(len_ap);
+
+    std::string text;
+    if (len > 0)
+    {
+        text.resize(len + 1);
+        vsnprintf(&text[0], text.size(), str, ap);
+        text.resize(len);
+    }
+
+    buffer->push_back(LogCaptureLine(type, false, text));
+    return true;
+}
+
+bool Log::CaptureLine(LogCaptureType type)
+{
+    LogCaptureBuffer* buffer = captureBuffer.get_value();
+    if (!buffer)
+        return false;
+
+    buffer->push_back(LogCaptureLine(type, true, std::string()));
+    return true;
+}
+
 void outstring_log(const char* str, ...)
 {
     if (!str)
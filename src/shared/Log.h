@@ -22,7 +22,9 @@
 #include "Common.h"
 #include "Policies/Singleton.h"
 
+#include <cstdarg>
 #include <mutex>
+#include <vector>
 
 class Config;
 class ByteBuffer;
@@ -91,6 +93,30 @@ enum Color
 
 const int Color_count = int(WHITE) + 1;
 
+// output kinds that can be held back by Log::BeginCapture
+enum LogCaptureType
+{
+    LOG_CAPTURE_STRING,
+    LOG_CAPTURE_ERROR,
+    LOG_CAPTURE_BASIC,
+    LOG_CAPTURE_DETAIL,
+    LOG_CAPTURE_DEBUG,
+    LOG_CAPTURE_ERROR_DB,
+    LOG_CAPTURE_ERROR_EVENT_AI,
+    LOG_CAPTURE_ERROR_SCRIPT_LIB
+};
+
+struct LogCaptureLine
+{
+    LogCaptureLine(LogCaptureType _type, bool _empty, std::string const& _text) : type(_type), empty(_empty), text(_text) {}
+
+    LogCaptureType type;
+    bool empty;                                             // output of the no-argument variant
+    std::string text;
+};
+
+typedef std::vector<LogCaptureLine> LogCaptureBuffer;
+
 class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::mutex> >
 {
         friend class MaNGOS::OperatorNew<Log>;
@@ -178,13 +204,23 @@ class Log : public MaNGOS::Singleton<Log, MaNGOS::ClassLevelLockable<Log, std::m
         bool HasLogLevelOrHigher(LogLevel loglvl) const { return m_logLevel >= loglvl || (m_logFileLevel >= loglvl && logfile); }
         bool IsOutCharDump() const { return m_charLog_Dump; }
         bool IsIncludeTime() const { return m_includeTime; }
+        std::string const& GetLogsDir() const { return m_logsDir; }
 
         static void WaitBeforeContinueIfNeed();
 
+        // Hold back console/file output of the calling thread until EndCapture,
+        // used to keep startup output in a fixed order when loading in parallel
+        void BeginCapture();
+        void EndCapture(LogCaptureBuffer& lines);
+        void Replay(LogCaptureBuffer const& lines);
+
         // Set filename for scriptlibrary error output
         void setScriptLibraryErrorFile(char const* fname, char const* libName);
 
     private:
+        bool CaptureLine(LogCaptureType type, const char* str, va_list ap);
+        bool CaptureLine(LogCaptureType type);
+
         FILE* openLogFile(char const* configFileName, char const* configTimeStampFlag, char const* mode);
         FILE* openGmlogPerAccount(uint32 account);
 
@@ -28,12 +28,94 @@
 #include <vector>
 #include <functional>
 #include <cstring>
+#include <unordered_map>
 
 namespace MaNGOS
 {
+namespace
+{
+    // upper limits of the latency histogram buckets in microseconds, the last bucket has none
+    const uint32 FlushLatencyBucketLimits[FlushLatencyHistogram::NumBuckets - 1] = { 100, 500, 1000, 5000, 10000, 25000, 50000 };
+
+    typedef std::vector<std::shared_ptr<Socket>> SocketList;
+
+    // sockets waiting for the next world tick flush, by network thread
+    std::mutex pendingFlushLock;
+    std::unordered_map<boost::asio::io_service *, SocketList> pendingFlushes;
+}
+
+FlushLatencyHistogram::FlushLatencyHistogram()
+{
+    Reset();
+}
+
+void FlushLatencyHistogram::Add(uint32 latency)
+{
+    int bucket = 0;
+    while (bucket < NumBuckets - 1 && latency >= FlushLatencyBucketLimits[bucket])
+        ++bucket;
+
+    m_counts[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void FlushLatencyHistogram::Reset()
+{
+    for (int i = 0; i < NumBuckets; ++i)
+        m_counts[i].store(0, std::memory_order_relaxed);
+}
+
+uint32 FlushLatencyHistogram::GetTotal() const
+{
+    uint32 total = 0;
+    for (int i = 0; i < NumBuckets; ++i)
+        total += GetCount(i);
+
+    return total;
+}
+
+uint32 FlushLatencyHistogram::GetBucketLimit(int bucket)
+{
+    return bucket < NumBuckets - 1 ? FlushLatencyBucketLimits[bucket] : 0;
+}
+
+std::atomic<uint32> Socket::s_flushDelay(50000);
+std::atomic<uint32> Socket::s_flushThreshold(0);
+std::atomic<FlushMode> Socket::s_flushMode(FlushMode::Timer);
+FlushLatencyHistogram Socket::s_flushLatency;
+
 Socket::Socket(boost::asio::io_service &service, std::function<void (Socket *)> closeHandler)
     : m_writeState(WriteState::Idle), m_readState(ReadState::Idle), m_socket(service),
-      m_closeHandler(closeHandler), m_outBufferFlushTimer(service), m_address("0.0.0.0") {}
+      m_closeHandler(closeHandler), m_outQueueSize(0), m_outFrontOffset(0), m_sendingChunks(0),
+      m_service(service), m_outBufferFlushTimer(service), m_flushGeneration(0), m_flushRequested(false), m_address("0.0.0.0") {}
+
+void Socket::SetFlushPolicy(FlushMode mode, uint32 delay, uint32 threshold)
+{
+    s_flushMode = mode;
+    s_flushDelay = delay;
+    s_flushThreshold = threshold;
+}
+
+void Socket::FlushPendingWrites()
+{
+    std::unordered_map<boost::asio::io_service *, SocketList> flushes;
+    {
+        std::lock_guard<std::mutex> guard(pendingFlushLock);
+        flushes.swap(pendingFlushes);
+    }
+
+    // a single handler per network thread starts the writes of all its sockets
+    for (auto i = flushes.begin(); i != flushes.end(); ++i)
+    {
+        std::shared_ptr<SocketList> sockets = std::make_shared<SocketList>();
+        sockets->swap(i->second);
+
+        i->first->post([sockets]
+        {
+            for (auto socket = sockets->begin(); socket != sockets->end(); ++socket)
+                (*socket)->FlushOut();
+        });
+    }
+}
 
 bool Socket::Open()
 {
@@ -48,8 +130,6 @@ bool Socket::Open()
         return false;
     }
 
-    m_outBuffer.reset(new PacketBuffer);
-    m_secondaryOutBuffer.reset(new PacketBuffer);
     m_inBuffer.reset(new PacketBuffer);
 
     StartAsyncRead();
@@ -166,24 +246,115 @@ void Socket::Write(const char *buffer, int length)
 {
     std::lock_guard<std::mutex> guard(m_mutex);
 
+    AppendOutput(buffer, length);
+    OnOutputAppended();
+}
+
+void Socket::Write(const char *header, int headerLength, const char *payload, int payloadLength)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    AppendOutput(header, headerLength);
+    AppendOutput(payload, payloadLength);
+    OnOutputAppended();
+}
+
+void Socket::Write(const char *header, int headerLength, SharedPayload const &payload, size_t payloadLength)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    AppendOutput(header, headerLength, payload, payloadLength);
+    OnOutputAppended();
+}
+
+// note that this function assumes that the socket mutex is locked
+void Socket::AppendOutput(const char *buffer, int length)
+{
+    if (length <= 0)
+        return;
+
+    // chunks being written must stay where they are, anything else may grow
+    if (m_outQueue.size() <= m_sendingChunks || m_outQueue.back().shared)
+    {
+        m_outQueue.push_back(OutputChunk());
+
+        if (!m_freeBuffers.empty())
+        {
+            m_outQueue.back().buffer.swap(m_freeBuffers.back());
+            m_freeBuffers.pop_back();
+        }
+        else
+            m_outQueue.back().buffer.reserve(DEFAULT_BUFFER_SIZE);
+    }
+
+    std::vector<uint8> &chunk = m_outQueue.back().buffer;
+    chunk.insert(chunk.end(), reinterpret_cast<const uint8 *>(buffer), reinterpret_cast<const uint8 *>(buffer) + length);
+    m_outQueueSize += length;
+}
+
+// note that this function assumes that the socket mutex is locked
+void Socket::AppendOutput(const char *header, int headerLength, SharedPayload const &payload, size_t length)
+{
+    if (length < SharedPayloadMinSize)
+    {
+        AppendOutput(header, headerLength);
+        AppendOutput(reinterpret_cast<const char *>(payload.get()), static_cast<int>(length));
+        return;
+    }
+
+    if (headerLength > static_cast<int>(MaxChunkPrefixSize))
+    {
+        AppendOutput(header, headerLength);
+        headerLength = 0;
+    }
+
+    m_outQueue.push_back(OutputChunk());
+
+    OutputChunk &chunk = m_outQueue.back();
+    if (headerLength > 0)
+    {
+        memcpy(chunk.prefix, header, headerLength);
+        chunk.prefixSize = headerLength;
+    }
+    chunk.shared = payload;
+    chunk.sharedSize = length;
+
+    m_outQueueSize += chunk.Size();
+}
+
+// note that this function assumes that the socket mutex is locked
+void Socket::OnOutputAppended()
+{
     switch (m_writeState)
     {
         case WriteState::Idle:
-            m_outBuffer->Write(buffer, length);
             StartWriteFlushTimer();
             break;
 
         case WriteState::Buffering:
-            m_outBuffer->Write(buffer, length);
             break;
 
-        case WriteState::Sending:
-            m_secondaryOutBuffer->Write(buffer, length);
+        case WriteState::Sending:                           // written by OnWriteComplete after the running write
             break;
 
         default:
             assert(false);
     }
+
+    // write large amounts of data at once, cancelling the timer triggers FlushOut()
+    const uint32 threshold = s_flushThreshold;
+    if (threshold && m_writeState == WriteState::Buffering && m_outQueueSize >= threshold)
+        RequestFlush();
+}
+
+// note that this function assumes that the socket mutex is locked
+void Socket::RequestFlush()
+{
+    if (m_writeState != WriteState::Buffering)
+        return;
+
+    m_flushRequested = true;
+    m_outBufferFlushTimer.cancel();
 }
 
 // note that this function assumes that the socket mutex is locked
@@ -200,10 +371,46 @@ void Socket::StartWriteFlushTimer()
     }
 
     m_writeState = WriteState::Buffering;
+    m_bufferingStart = std::chrono::steady_clock::now();
+    m_flushRequested = false;
+
+    if (s_flushMode == FlushMode::WorldTick)
+        AddPendingFlush();
+
+    // a wait of an earlier buffering period may still be queued, cancelled by expires_from_now below.
+    // its handler sees an old generation and must not flush the new buffer before the tick or delay
+    const uint32 generation = ++m_flushGeneration;
 
     std::shared_ptr<Socket> ptr = shared<Socket>();
-    m_outBufferFlushTimer.expires_from_now(boost::posix_time::milliseconds(BufferTimeout));
-    m_outBufferFlushTimer.async_wait([ptr](const boost::system::error_code &error) { ptr->FlushOut(); });
+    m_outBufferFlushTimer.expires_from_now(boost::posix_time::microseconds(s_flushDelay.load()));
+    m_outBufferFlushTimer.async_wait([ptr, generation](const boost::system::error_code &error) { ptr->OnFlushTimer(error, generation); });
+}
+
+void Socket::OnFlushTimer(const boost::system::error_code &error, uint32 generation)
+{
+    // if the socket is closed, silently fail
+    if (IsClosed())
+    {
+        m_writeState = WriteState::Idle;
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_mutex);
+
+    if (generation != m_flushGeneration)
+        return;
+
+    // cancelled without RequestFlush: the world tick has flushed this buffer already
+    if (error == boost::asio::error::operation_aborted && !m_flushRequested)
+        return;
+
+    FlushBuffered();
+}
+
+void Socket::AddPendingFlush()
+{
+    std::lock_guard<std::mutex> guard(pendingFlushLock);
+    pendingFlushes[&m_service].push_back(shared<Socket>());
 }
 
 void Socket::FlushOut()
@@ -216,24 +423,76 @@ void Socket::FlushOut()
     }
 
     std::lock_guard<std::mutex> guard(m_mutex);
+    FlushBuffered();
+}
 
-    assert(m_writeState == WriteState::Buffering);
+// note that this function assumes that the socket mutex is locked
+void Socket::FlushBuffered()
+{
+    // the timer, the world tick and the byte threshold can each trigger a flush, only the first one writes
+    if (m_writeState != WriteState::Buffering)
+        return;
 
     // at this point we are guarunteed that there is data to send in the primary buffer.  send it.
     m_writeState = WriteState::Sending;
 
+    // the wait of this buffering period is not needed anymore, its handler ignores the cancellation
+    m_outBufferFlushTimer.cancel();
+
+    const uint32 latency = static_cast<uint32>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_bufferingStart).count());
+    m_flushLatency.Add(latency);
+    s_flushLatency.Add(latency);
+
+    StartSend();
+}
+
+// note that this function assumes that the socket mutex is locked and there is output to write
+void Socket::StartSend()
+{
+    // one vectored write of the first chunks, shared payloads are written from where they are
+    m_sendBuffers.clear();
+    m_sendingChunks = 0;
+
+    for (std::deque<OutputChunk>::const_iterator chunk = m_outQueue.begin(); chunk != m_outQueue.end() && m_sendBuffers.size() + 2 <= MaxSendBuffers; ++chunk)
+    {
+        AddSendBuffers(*chunk, chunk == m_outQueue.begin() ? m_outFrontOffset : 0);
+        ++m_sendingChunks;
+    }
+
     std::shared_ptr<Socket> ptr = shared<Socket>();
-    m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
+    m_socket.async_write_some(SendBufferSequence(m_sendBuffers),
         make_custom_alloc_handler(m_allocator,
             [ptr](const boost::system::error_code &error, size_t length) { ptr->OnWriteComplete(error, length); }));
 }
 
+// note that this function assumes that the socket mutex is locked
+void Socket::AddSendBuffers(OutputChunk const &chunk, size_t offset)
+{
+    if (!chunk.shared)
+    {
+        m_sendBuffers.push_back(boost::asio::const_buffer(&chunk.buffer[offset], chunk.buffer.size() - offset));
+        return;
+    }
+
+    if (offset < chunk.prefixSize)
+    {
+        m_sendBuffers.push_back(boost::asio::const_buffer(&chunk.prefix[offset], chunk.prefixSize - offset));
+        offset = 0;
+    }
+    else
+        offset -= chunk.prefixSize;
+
+    m_sendBuffers.push_back(boost::asio::const_buffer(chunk.shared.get() + offset, chunk.sharedSize - offset));
+}
+
 // if the write state is idle, this will do nothing, which is correct
 // if the write state is sending, this will do nothing, which is correct
 // if the write state is buffering, this will cancel the running timer, which will immediately trigger FlushOut()
 void Socket::ForceFlushOut()
 {
-    m_outBufferFlushTimer.cancel();
+    std::lock_guard<std::mutex> guard(m_mutex);
+    RequestFlush();
 }
 
 void Socket::OnWriteComplete(const boost::system::error_code &error, size_t length)
@@ -255,37 +514,40 @@ void Socket::OnWriteComplete(const boost::system::error_code &error, size_t leng
     std::lock_guard<std::mutex> guard(m_mutex);
 
     assert(m_writeState == WriteState::Sending);
-    assert(length <= m_outBuffer->m_writePosition);
+    assert(length <= m_outQueueSize);
 
-    // if there is data left to write, move it to the start of the buffer
-    if (length < m_outBuffer->m_writePosition)
-    {
-        std::copy(&m_outBuffer->m_buffer[length], &m_outBuffer->m_buffer[m_outBuffer->m_writePosition], m_outBuffer->m_buffer.begin());
-        m_outBuffer->m_writePosition -= length;
-    }
-    // if not, reset the write pointer
-    else
-        m_outBuffer->m_writePosition = 0;
+    m_outQueueSize -= length;
 
-    // if there is data in the secondary buffer, append it to the primary buffer
-    if (m_secondaryOutBuffer->m_writePosition > 0)
+    // drop the written chunks, a partly written chunk stays in front
+    while (length > 0)
     {
-        // do we have enough space? if not, resize
-        if (m_outBuffer->m_buffer.size() < (m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition))
-            m_outBuffer->m_buffer.resize(m_outBuffer->m_writePosition + m_secondaryOutBuffer->m_writePosition);
+        OutputChunk &chunk = m_outQueue.front();
+        const size_t remaining = chunk.Size() - m_outFrontOffset;
 
-        std::copy(&m_secondaryOutBuffer->m_buffer[0], &m_secondaryOutBuffer->m_buffer[m_secondaryOutBuffer->m_writePosition], &m_outBuffer->m_buffer[m_outBuffer->m_writePosition]);
+        if (length < remaining)
+        {
+            m_outFrontOffset += length;
+            break;
+        }
 
-        m_outBuffer->m_writePosition += m_secondaryOutBuffer->m_writePosition;
-        m_secondaryOutBuffer->m_writePosition = 0;
+        length -= remaining;
+        m_outFrontOffset = 0;
+
+        if (!chunk.shared && m_freeBuffers.size() < 2)
+        {
+            chunk.buffer.clear();
+            m_freeBuffers.push_back(std::vector<uint8>());
+            m_freeBuffers.back().swap(chunk.buffer);
+        }
+
+        m_outQueue.pop_front();
     }
 
-    std::shared_ptr<Socket> ptr = shared<Socket>();
+    m_sendingChunks = 0;
+
     // if there is any data to write, do so immediately
-    if (m_outBuffer->m_writePosition > 0)
-        m_socket.async_write_some(boost::asio::buffer(m_outBuffer->m_buffer, m_outBuffer->m_writePosition),
-            make_custom_alloc_handler(m_allocator,
-                [ptr](const boost::system::error_code &error, size_t length) { ptr->OnWriteComplete(error, length);}));
+    if (!m_outQueue.empty())
+        StartSend();
     else
         m_writeState = WriteState::Idle;
 }
@@ -25,19 +25,62 @@
 
 #include <boost/asio.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <deque>
 #include <memory>
 #include <string>
 #include <mutex>
 #include <functional>
+#include <vector>
 
 namespace MaNGOS
 {
+    enum class FlushMode
+    {
+        Timer,      // buffered data is written when the flush delay ran out
+        WorldTick,  // buffered data is written at the end of the world update, the flush delay is only an upper limit
+    };
+
+    // histogram of the time buffered output waits before it is written
+    class MANGOS_DLL_SPEC FlushLatencyHistogram
+    {
+        public:
+            static const int NumBuckets = 8;
+
+            FlushLatencyHistogram();
+
+            void Add(uint32 latency);                       // in microseconds
+            void Reset();
+
+            uint32 GetCount(int bucket) const { return m_counts[bucket].load(std::memory_order_relaxed); }
+            uint32 GetTotal() const;
+
+            // upper limit of the bucket in microseconds, 0 for the last bucket which has none
+            static uint32 GetBucketLimit(int bucket);
+
+        private:
+            std::atomic<uint32> m_counts[NumBuckets];
+    };
+
     class MANGOS_DLL_SPEC Socket : public std::enable_shared_from_this<Socket>
     {
+        public:
+            // immutable payload referenced by the output queues of many sockets (broadcasts)
+            typedef std::shared_ptr<const uint8> SharedPayload;
+
+            // shared payloads smaller than this are copied, a reference costs more than the copy
+            static const size_t SharedPayloadMinSize = 128;
+
         private:
-            // buffer timeout period, in milliseconds.  higher values decrease responsiveness
+            // buffer timeout period, in microseconds.  higher values decrease responsiveness
             // ingame but increase bandwidth efficiency by reducing tcp overhead.
-            static const int BufferTimeout = 50;
+            static std::atomic<uint32> s_flushDelay;
+            // buffered bytes which are written at once without waiting for the timer or tick, 0 to disable
+            static std::atomic<uint32> s_flushThreshold;
+            static std::atomic<FlushMode> s_flushMode;
+
+            static FlushLatencyHistogram s_flushLatency;
 
             enum class WriteState
             {
@@ -59,19 +102,78 @@ namespace MaNGOS
 
             std::function<void(Socket *)> m_closeHandler;
 
+            // header bytes kept in a shared payload chunk itself, longer headers get a chunk of their own
+            static const size_t MaxChunkPrefixSize = 8;
+
+            // one piece of buffered output, either bytes copied into the socket or a
+            // shared payload with the (encrypted) header of this connection in front
+            struct OutputChunk
+            {
+                OutputChunk() : prefixSize(0), sharedSize(0) {}
+
+                size_t Size() const { return shared ? prefixSize + sharedSize : buffer.size(); }
+
+                std::vector<uint8> buffer;
+                uint8 prefix[MaxChunkPrefixSize];
+                size_t prefixSize;
+                SharedPayload shared;
+                size_t sharedSize;
+            };
+
+            // buffer sequence over m_sendBuffers, cheap to copy into the asio write operation
+            class SendBufferSequence
+            {
+                public:
+                    typedef boost::asio::const_buffer value_type;
+                    typedef std::vector<boost::asio::const_buffer>::const_iterator const_iterator;
+
+                    explicit SendBufferSequence(std::vector<boost::asio::const_buffer> const &buffers) : m_begin(buffers.begin()), m_end(buffers.end()) {}
+
+                    const_iterator begin() const { return m_begin; }
+                    const_iterator end() const { return m_end; }
+
+                private:
+                    const_iterator m_begin;
+                    const_iterator m_end;
+            };
+
+            // at most this many buffers are written by one write operation (asio uses up to 64 per call)
+            static const size_t MaxSendBuffers = 64;
+
             std::unique_ptr<PacketBuffer> m_inBuffer;
-            std::unique_ptr<PacketBuffer> m_outBuffer;
-            std::unique_ptr<PacketBuffer> m_secondaryOutBuffer;
+
+            std::deque<OutputChunk> m_outQueue;
+            size_t m_outQueueSize;                          // bytes in m_outQueue not written yet
+            size_t m_outFrontOffset;                        // bytes of the first chunk already written
+            size_t m_sendingChunks;                         // chunks at the front being written, they must not grow
+            std::vector<boost::asio::const_buffer> m_sendBuffers;
+            std::vector<std::vector<uint8>> m_freeBuffers;  // buffers of written chunks kept for reuse
 
             std::mutex m_mutex;
+            boost::asio::io_service &m_service;
             boost::asio::deadline_timer m_outBufferFlushTimer;
+            uint32 m_flushGeneration;                       // buffering periods started, tells stale timer waits apart
+            bool m_flushRequested;                          // timer cancelled to flush now, not by the world tick
+
+            std::chrono::steady_clock::time_point m_bufferingStart;
+            FlushLatencyHistogram m_flushLatency;
 
             void StartAsyncRead();
             void OnRead(const boost::system::error_code &error, size_t length);
 
+            void AppendOutput(const char *buffer, int length);
+            void AppendOutput(const char *header, int headerLength, SharedPayload const &payload, size_t length);
+            void OnOutputAppended();
+
             void StartWriteFlushTimer();
+            void OnFlushTimer(const boost::system::error_code &error, uint32 generation);
+            void RequestFlush();
+            void AddPendingFlush();
+            void StartSend();
+            void AddSendBuffers(OutputChunk const &chunk, size_t offset);
             void OnWriteComplete(const boost::system::error_code &error, size_t length);
             void FlushOut();
+            void FlushBuffered();
 
             void OnError(const boost::system::error_code &error);
 
@@ -101,6 +203,10 @@ namespace MaNGOS
             void ReadSkip(int length) { m_inBuffer->Read(nullptr, length); }
 
             void Write(const char *buffer, int length);
+            // header and payload are queued together, concurrent writes can't get between them
+            void Write(const char *header, int headerLength, const char *payload, int payloadLength);
+            // the payload is queued by reference, it must not change anymore
+            void Write(const char *header, int headerLength, SharedPayload const &payload, size_t payloadLength);
 
             boost::asio::ip::tcp::socket &GetAsioSocket() { return m_socket; }
 
@@ -110,6 +216,13 @@ namespace MaNGOS
             template <typename T>
             std::shared_ptr<T> shared() { return std::static_pointer_cast<T>(shared_from_this()); }
 
+            FlushLatencyHistogram const& GetFlushLatency() const { return m_flushLatency; }
+
+            static void SetFlushPolicy(FlushMode mode, uint32 delay, uint32 threshold);
+            // writes the buffered output of all sockets in FlushMode::WorldTick, one handler per network thread
+            static void FlushPendingWrites();
+            static FlushLatencyHistogram& GetTotalFlushLatency() { return s_flushLatency; }
+
         private:
             // custom allocator based on example from http://www.boost.org/doc/libs/1_62_0/doc/html/boost_asio/example/cpp11/allocation/server.cpp
 